@@ -1,6 +1,7 @@
 #include "core/Core.h"
 #include "events/broker/impl/JobBasedEventBroker.h"
 #include "graphics/service/RenderService.h"
+#include "networking/bridge/EventBridge.h"
 #include "plugins/impl/BoostPluginManager.h"
 #include "resources/loader/impl/FileLoader.h"
 #include "resources/manager/impl/ThreadPoolResourceManager.h"
@@ -49,6 +50,11 @@ Core::Core(common::config::SharedConfiguration config, bool only_local)
     SetNetworkingManager(common::memory::Owner<networking::NetworkingManager>(
         m_subsystems.CreateReference(), config));
 
+    // forward events of topics configured in 'net.bridge.topics' to peers
+    m_subsystems->AddOrReplaceSubsystem<networking::bridge::EventBridge>(
+        common::memory::Owner<networking::bridge::EventBridge>(
+            m_subsystems.CreateReference(), config));
+
     // setup remote-capable service registry
     SetServiceRegistry(
         common::memory::Owner<services::impl::PeerToPeerServiceRegistry>(
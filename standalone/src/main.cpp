@@ -4,10 +4,38 @@
 #include "core/Core.h"
 #include "graphics/renderer/impl/OffscreenRenderer.h"
 #include "graphics/renderer/impl/OnscreenRenderer.h"
+#include <fstream>
 
 using namespace hive;
 namespace po = boost::program_options;
 
+/**
+ * Writes the critical path analysis of the most recent job cycles to a file
+ * as JSON or logs it, if no file has been specified.
+ * @param job_manager job manager that analyzed its cycles
+ * @param output_path path of the JSON file or empty
+ */
+void ReportCycleAnalysis(
+    const common::memory::Borrower<jobsystem::JobManager> &job_manager,
+    const std::string &output_path) {
+  auto summary = job_manager->GetCycleAnalysisSummary();
+  if (!summary.has_value()) {
+    return;
+  }
+
+  if (output_path.empty()) {
+    LOG_INFO(summary->ToString())
+    return;
+  }
+
+  std::ofstream output(output_path, std::ios::trunc);
+  if (!output) {
+    LOG_ERR("Cannot write cycle analysis to " << output_path)
+    return;
+  }
+  output << summary->ToJson() << std::endl;
+}
+
 int main(int argc, const char **argv) {
   /* PARSE COMMAND LINE OPTIONS */
   std::string renderer_type;
@@ -18,6 +46,8 @@ int main(int argc, const char **argv) {
   int width, height;
   int max_update_rate;
   unsigned int threads;
+  int analysis_window;
+  std::string analysis_output_path;
   std::vector<std::string> connections_to_establish;
   std::vector<std::string> scene_objects_to_load;
 
@@ -46,6 +76,13 @@ int main(int argc, const char **argv) {
       po::value<unsigned int>(&threads)->default_value(
           std::thread::hardware_concurrency()),
       "amount of threads used in the job system")(
+      "analyze-cycles",
+      po::value<int>(&analysis_window)->default_value(0),
+      "Analyzes the critical path of job cycles and reports a summary every "
+      "given amount of cycles")(
+      "analysis-output",
+      po::value<std::string>(&analysis_output_path)->default_value(""),
+      "JSON file the cycle analysis is written to (it is logged otherwise)")(
       "connect,c",
       po::value<std::vector<std::string>>(&connections_to_establish)
           ->multitoken(),
@@ -67,6 +104,10 @@ int main(int argc, const char **argv) {
   auto config = std::make_shared<common::config::Configuration>();
   config->Set("net.port", service_port);
   config->Set("jobs.concurrency", threads);
+  if (analysis_window > 0) {
+    config->Set("jobs.analysis.enabled", true);
+    config->Set("jobs.analysis.window", analysis_window);
+  }
   bool local_only = service_port < 0;
 
   /* START KERNEL AND ALL ITS SUBSYSTEMS */
@@ -178,6 +219,11 @@ int main(int argc, const char **argv) {
     }
     lastIterationTime = std::chrono::steady_clock::now();
     core.GetJobManager()->InvokeCycleAndWait();
+
+    if (analysis_window > 0 &&
+        core.GetJobManager()->GetTotalCyclesCount() % analysis_window == 0) {
+      ReportCycleAnalysis(core.GetJobManager(), analysis_output_path);
+    }
   }
 
   return 0;
@@ -30,5 +30,5 @@
   }
 #else
 #define DEBUG_ASSERT(x, message)
-#definne DEBUG_ASSERT_NO_THROW(x, exception_type) x;
+#define DEBUG_ASSERT_NO_THROW(x, exception_type) x;
 #endif
@@ -0,0 +1,498 @@
+#include "common/config/Configuration.h"
+#include "common/memory/ExclusiveOwnership.h"
+#include "common/subsystems/SubsystemManager.h"
+#include "events/broker/impl/JobBasedEventBroker.h"
+#include "events/broker/impl/TopicSubscriberTrie.h"
+#include "events/listener/impl/FunctionalEventListener.h"
+#include "jobsystem/manager/JobManager.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace hive;
+using namespace hive::events;
+using namespace hive::events::brokers;
+using namespace hive::jobsystem;
+using namespace std::chrono_literals;
+
+/**
+ * Result of a single benchmark run. Parameters describe the scenario, metrics
+ * contain the measurements. Both are written as JSON, so results of different
+ * builds can be compared.
+ */
+struct BenchmarkResult {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> parameters;
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+static std::vector<BenchmarkResult> s_results;
+
+static void WriteJson(std::ostream &out,
+                      const std::vector<BenchmarkResult> &results) {
+  out << "{\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &result = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name
+        << "\", \"parameters\": {";
+    for (size_t j = 0; j < result.parameters.size(); j++) {
+      out << (j == 0 ? "" : ", ") << "\"" << result.parameters[j].first
+          << "\": \"" << result.parameters[j].second << "\"";
+    }
+    out << "}, \"metrics\": {";
+    for (size_t j = 0; j < result.metrics.size(); j++) {
+      out << (j == 0 ? "" : ", ") << "\"" << result.metrics[j].first
+          << "\": " << result.metrics[j].second;
+    }
+    out << "}}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+/**
+ * Measures the average duration of an operation.
+ * @param iterations count of times the operation is executed
+ * @param operation operation to measure (receives the iteration index)
+ * @return average duration of a single operation in nanoseconds
+ */
+static double Measure(size_t iterations,
+                      const std::function<void(size_t)> &operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    operation(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(iterations);
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+static std::string GetDispatchModeName(DispatchMode mode) {
+  switch (mode) {
+  case DispatchMode::INLINE:
+    return "inline";
+  case DispatchMode::BATCHED:
+    return "batched";
+  default:
+    return "job";
+  }
+}
+
+/**
+ * Job system and event broker used by benchmark runs.
+ */
+struct BrokerSetup {
+  common::memory::Owner<common::subsystems::SubsystemManager> subsystems;
+  common::memory::Borrower<JobManager> job_manager;
+  common::memory::Owner<JobBasedEventBroker> broker;
+
+  BrokerSetup()
+      : subsystems{}, job_manager{CreateJobManager(subsystems)},
+        broker{subsystems.CreateReference()} {}
+
+  static common::memory::Borrower<JobManager> CreateJobManager(
+      common::memory::Owner<common::subsystems::SubsystemManager>
+          &subsystems) {
+    auto config = std::make_shared<common::config::Configuration>();
+    auto job_manager = common::memory::Owner<JobManager>(config);
+    job_manager->StartExecution();
+    subsystems->AddOrReplaceSubsystem<JobManager>(std::move(job_manager));
+    return subsystems->RequireSubsystem<JobManager>();
+  }
+};
+
+/**
+ * Registers listeners on topics which are never fired, so the broker has to
+ * look up the fired topic among many others.
+ */
+static std::vector<SharedEventListener>
+RegisterNoiseTopics(IEventBroker &broker, size_t topic_count) {
+  std::vector<SharedEventListener> listeners;
+  for (size_t i = 0; i < topic_count; i++) {
+    auto listener =
+        std::make_shared<FunctionalEventListener>([](const SharedEvent &) {});
+    broker.RegisterListener(listener,
+                            "bench.noise" + std::to_string(i) + ".event");
+    listeners.push_back(std::move(listener));
+  }
+  return listeners;
+}
+
+/**
+ * Fires events of a single topic and measures how long firing and delivering
+ * them to all listeners takes.
+ * @param setup broker which already contains the other topics
+ */
+static void BenchmarkFireThroughput(BrokerSetup &setup, size_t listener_count,
+                                    size_t topic_count, DispatchMode mode) {
+  std::atomic_size_t delivered_count = 0;
+  std::vector<SharedEventListener> listeners;
+  for (size_t i = 0; i < listener_count; i++) {
+    auto listener = std::make_shared<FunctionalEventListener>(
+        [&delivered_count](const SharedEvent &) { delivered_count++; });
+    setup.broker->RegisterListener(listener, "bench.fired.event", mode);
+    listeners.push_back(std::move(listener));
+  }
+
+  // the same amount of deliveries for every listener count
+  size_t event_count = std::max<size_t>(100000 / listener_count, 100);
+  auto event = std::make_shared<Event>("bench.fired.event");
+
+  auto start = std::chrono::steady_clock::now();
+  double fire_ns = Measure(event_count,
+                           [&](size_t) { setup.broker->FireEvent(event); });
+  setup.job_manager->InvokeCycleAndWait();
+  double total_seconds = SecondsSince(start);
+
+  for (const auto &listener : listeners) {
+    setup.broker->UnregisterListener(listener);
+  }
+
+  s_results.push_back(
+      {"fire_throughput",
+       {{"listeners", std::to_string(listener_count)},
+        {"topics", std::to_string(topic_count)},
+        {"mode", GetDispatchModeName(mode)}},
+       {{"fire_ns", fire_ns},
+        {"events_per_second", event_count / total_seconds},
+        {"deliveries_per_second", delivered_count / total_seconds},
+        {"delivered", static_cast<double>(delivered_count)}}});
+}
+
+/**
+ * Fires events from multiple threads at once, which stresses the
+ * synchronization of subscriber lookup and job scheduling.
+ */
+static void BenchmarkConcurrentFire(size_t thread_count) {
+  BrokerSetup setup;
+  auto noise_listeners = RegisterNoiseTopics(*setup.broker, 100);
+
+  std::atomic_size_t delivered_count = 0;
+  std::vector<SharedEventListener> listeners;
+  for (size_t i = 0; i < 4; i++) {
+    auto listener = std::make_shared<FunctionalEventListener>(
+        [&delivered_count](const SharedEvent &) { delivered_count++; });
+    setup.broker->RegisterListener(listener, "bench.fired.event");
+    listeners.push_back(std::move(listener));
+  }
+
+  size_t events_per_thread = 40000 / thread_count;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; i++) {
+    threads.emplace_back([&setup, events_per_thread]() {
+      auto event = std::make_shared<Event>("bench.fired.event");
+      for (size_t j = 0; j < events_per_thread; j++) {
+        setup.broker->FireEvent(event);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double fire_seconds = SecondsSince(start);
+
+  setup.job_manager->InvokeCycleAndWait();
+  double total_seconds = SecondsSince(start);
+
+  size_t event_count = events_per_thread * thread_count;
+  s_results.push_back(
+      {"concurrent_fire",
+       {{"threads", std::to_string(thread_count)}},
+       {{"fired_events_per_second", event_count / fire_seconds},
+        {"events_per_second", event_count / total_seconds},
+        {"delivered", static_cast<double>(delivered_count)}}});
+}
+
+/**
+ * Fires events while another thread keeps registering and removing listeners
+ * of the same topic.
+ */
+static void BenchmarkChurn(bool with_churn) {
+  BrokerSetup setup;
+
+  std::atomic_size_t delivered_count = 0;
+  std::vector<SharedEventListener> listeners;
+  for (size_t i = 0; i < 16; i++) {
+    auto listener = std::make_shared<FunctionalEventListener>(
+        [&delivered_count](const SharedEvent &) { delivered_count++; });
+    setup.broker->RegisterListener(listener, "bench.fired.event",
+                                   DispatchMode::INLINE);
+    listeners.push_back(std::move(listener));
+  }
+
+  std::atomic_bool running = true;
+  std::atomic_size_t churn_count = 0;
+  std::thread churn_thread([&]() {
+    auto listener =
+        std::make_shared<FunctionalEventListener>([](const SharedEvent &) {});
+    while (with_churn && running) {
+      setup.broker->RegisterListener(listener, "bench.fired.event",
+                                     DispatchMode::INLINE);
+      setup.broker->RemoveListenerFromTopic(listener, "bench.fired.event");
+      churn_count++;
+    }
+  });
+
+  size_t event_count = 200000;
+  auto event = std::make_shared<Event>("bench.fired.event");
+  auto start = std::chrono::steady_clock::now();
+  double fire_ns = Measure(event_count,
+                           [&](size_t) { setup.broker->FireEvent(event); });
+  double seconds = SecondsSince(start);
+
+  running = false;
+  churn_thread.join();
+
+  s_results.push_back({"churn",
+                       {{"churn", with_churn ? "true" : "false"}},
+                       {{"fire_ns", fire_ns},
+                        {"events_per_second", event_count / seconds},
+                        {"churn_per_second", churn_count / seconds},
+                        {"delivered", static_cast<double>(delivered_count)}}});
+}
+
+/**
+ * Measures the time from firing an event until a listener handles it while
+ * the job system is continuously executing cycles.
+ */
+static void BenchmarkLatency(DispatchMode mode) {
+  BrokerSetup setup;
+
+  std::mutex latencies_mutex;
+  std::vector<double> latencies_us;
+  auto listener = std::make_shared<FunctionalEventListener>(
+      [&](const SharedEvent &event) {
+        auto fired =
+            event->GetPayload<std::chrono::steady_clock::time_point>("fired")
+                .value();
+        auto latency = std::chrono::duration<double, std::micro>(
+                           std::chrono::steady_clock::now() - fired)
+                           .count();
+        std::unique_lock lock(latencies_mutex);
+        latencies_us.push_back(latency);
+      });
+  setup.broker->RegisterListener(listener, "bench.fired.event", mode);
+
+  std::atomic_bool running = true;
+  std::thread cycle_thread([&]() {
+    while (running) {
+      setup.job_manager->InvokeCycleAndWait();
+    }
+  });
+
+  size_t event_count = 2000;
+  for (size_t i = 0; i < event_count; i++) {
+    auto event = std::make_shared<Event>("bench.fired.event");
+    event->SetPayload("fired", std::chrono::steady_clock::now());
+    setup.broker->FireEvent(event);
+    std::this_thread::sleep_for(100us);
+  }
+
+  // wait until the last events have been delivered
+  std::this_thread::sleep_for(100ms);
+  running = false;
+  cycle_thread.join();
+
+  std::unique_lock lock(latencies_mutex);
+  std::sort(latencies_us.begin(), latencies_us.end());
+  auto percentile = [&latencies_us](double percentile) {
+    if (latencies_us.empty()) {
+      return 0.0;
+    }
+    auto index = static_cast<size_t>(percentile * (latencies_us.size() - 1));
+    return latencies_us[index];
+  };
+
+  s_results.push_back(
+      {"latency",
+       {{"mode", GetDispatchModeName(mode)}},
+       {{"p50_us", percentile(0.5)},
+        {"p99_us", percentile(0.99)},
+        {"max_us", percentile(1.0)},
+        {"delivered", static_cast<double>(latencies_us.size())}}});
+}
+
+static std::vector<std::string_view> Split(std::string_view topic) {
+  std::vector<std::string_view> segments;
+  size_t begin = 0, end;
+  while ((end = topic.find('.', begin)) != std::string_view::npos) {
+    segments.push_back(topic.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  segments.push_back(topic.substr(begin));
+  return segments;
+}
+
+/**
+ * Matches a topic against a pattern segment by segment. This is the naive
+ * alternative to the trie (a linear scan over all patterns).
+ */
+static bool MatchesPattern(const std::vector<std::string_view> &pattern,
+                           size_t pattern_index,
+                           const std::vector<std::string_view> &topic,
+                           size_t topic_index) {
+  if (pattern_index == pattern.size()) {
+    return topic_index == topic.size();
+  }
+
+  if (pattern[pattern_index] == "**") {
+    for (size_t i = topic_index; i <= topic.size(); i++) {
+      if (MatchesPattern(pattern, pattern_index + 1, topic, i)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  if (topic_index == topic.size()) {
+    return false;
+  }
+
+  return (pattern[pattern_index] == "*" ||
+          pattern[pattern_index] == topic[topic_index]) &&
+         MatchesPattern(pattern, pattern_index + 1, topic, topic_index + 1);
+}
+
+/**
+ * Creates a topic of the benchmark (e.g. 'service.42.instance.3.state').
+ */
+static std::string CreateTopic(size_t index) {
+  return "service." + std::to_string(index) + ".instance." +
+         std::to_string(index % 7) + ".state";
+}
+
+/**
+ * Creates a pattern of the benchmark. Most patterns contain wildcards.
+ */
+static std::string CreatePattern(size_t index) {
+  switch (index % 4) {
+  case 0:
+    return "service." + std::to_string(index) + ".instance.*.state";
+  case 1:
+    return "service." + std::to_string(index) + ".**";
+  case 2:
+    return "service.*.instance." + std::to_string(index) + ".state";
+  default:
+    return CreateTopic(index);
+  }
+}
+
+/**
+ * Compares matching topics using the trie with a linear scan over all
+ * patterns.
+ */
+static void BenchmarkTopicTrie(size_t topic_count, size_t pattern_count) {
+  TopicSubscriberTrie trie;
+  auto listener =
+      std::make_shared<FunctionalEventListener>([](const SharedEvent &) {});
+  auto never_equal = [](const auto &) { return false; };
+
+  std::vector<std::string> patterns;
+  for (size_t i = 0; i < topic_count; i++) {
+    patterns.push_back(CreateTopic(i));
+  }
+  for (size_t i = 0; i < pattern_count; i++) {
+    patterns.push_back(CreatePattern(i));
+  }
+
+  double registration_ns = Measure(patterns.size(), [&](size_t i) {
+    trie.Add(patterns[i], {listener}, never_equal);
+  });
+
+  std::mt19937 random(42);
+  std::uniform_int_distribution<size_t> distribution(0, topic_count * 2);
+  std::vector<std::string> fired_topics;
+  for (size_t i = 0; i < 1024; i++) {
+    fired_topics.push_back(CreateTopic(distribution(random)));
+  }
+
+  size_t total_matches = 0;
+  std::vector<TopicSubscriberTrie::SharedSubscriberList> matches;
+  double trie_match_ns = Measure(100000, [&](size_t i) {
+    matches.clear();
+    trie.Match(fired_topics[i % fired_topics.size()], matches);
+    total_matches += matches.size();
+  });
+
+  // the naive approach is too slow for the same amount of iterations
+  std::vector<std::vector<std::string_view>> split_patterns;
+  for (const auto &pattern : patterns) {
+    split_patterns.push_back(Split(pattern));
+  }
+  size_t total_naive_matches = 0;
+  double naive_match_ns = Measure(1000, [&](size_t i) {
+    auto topic = Split(fired_topics[i % fired_topics.size()]);
+    for (const auto &pattern : split_patterns) {
+      if (MatchesPattern(pattern, 0, topic, 0)) {
+        total_naive_matches++;
+      }
+    }
+  });
+
+  s_results.push_back(
+      {"topic_trie",
+       {{"topics", std::to_string(topic_count)},
+        {"patterns", std::to_string(pattern_count)}},
+       {{"register_ns", registration_ns},
+        {"trie_match_ns", trie_match_ns},
+        {"linear_match_ns", naive_match_ns},
+        {"matches_per_fire", static_cast<double>(total_matches) / 100000.0}}});
+}
+
+/**
+ * Runs all benchmarks of the event broker and prints their results as JSON.
+ * Usage: eventsbenchmarks [output file]
+ * @note Logs are written to stderr, so stdout only contains the results.
+ */
+int main(int argc, char **argv) {
+  for (size_t topic_count : {1, 10000}) {
+    // registering topics is expensive, so all runs share them
+    BrokerSetup setup;
+    auto noise_listeners = RegisterNoiseTopics(*setup.broker, topic_count - 1);
+
+    for (size_t listener_count : {1, 10, 100}) {
+      for (auto mode :
+           {DispatchMode::INLINE, DispatchMode::JOB, DispatchMode::BATCHED}) {
+        BenchmarkFireThroughput(setup, listener_count, topic_count, mode);
+      }
+    }
+  }
+
+  for (size_t thread_count : {1, 2, 4, 8}) {
+    BenchmarkConcurrentFire(thread_count);
+  }
+
+  BenchmarkChurn(false);
+  BenchmarkChurn(true);
+
+  BenchmarkLatency(DispatchMode::INLINE);
+  BenchmarkLatency(DispatchMode::JOB);
+
+  for (size_t count : {100, 1000, 10000}) {
+    BenchmarkTopicTrie(count, count);
+  }
+
+  if (argc > 1) {
+    std::ofstream file(argv[1]);
+    WriteJson(file, s_results);
+  } else {
+    WriteJson(std::cout, s_results);
+  }
+
+  return 0;
+}
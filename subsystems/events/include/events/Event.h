@@ -33,12 +33,15 @@ public:
   Event() = delete;
   explicit Event(std::string topic)
       : topic{std::move(topic)}, m_id{common::uuid::UuidGenerator::Random()} {};
+  Event(std::string topic, std::string id)
+      : topic{std::move(topic)}, m_id{std::move(id)} {};
   virtual ~Event() = default;
 
   std::string GetId() const ;
   template <typename T> void SetPayload(const std::string &key, T value);
   template <typename T>
   std::optional<T> GetPayload(const std::string &key) const;
+  const std::map<std::string, std::any> &GetAllPayloads() const;
   const std::string &GetTopic() const;
 };
 
@@ -59,6 +62,10 @@ inline std::optional<T> Event::GetPayload(const std::string &key) const {
   }
 }
 
+inline const std::map<std::string, std::any> &Event::GetAllPayloads() const {
+  return m_payload;
+}
+
 inline const std::string &Event::GetTopic() const { return topic; }
 
 typedef std::shared_ptr<Event> SharedEvent;
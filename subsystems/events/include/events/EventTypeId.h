@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace hive::events {
+
+/**
+ * Identifies the type of a typed event. It is computed at compile time, so
+ * dispatching typed events requires no string comparisons.
+ */
+typedef uint64_t EventTypeId;
+
+/**
+ * Get the name of a type as generated by the compiler.
+ * @tparam T type
+ * @return compiler specific signature containing the type's name
+ * @note This is not demangled and only meant for identification and logging.
+ */
+template <typename T> constexpr std::string_view GetEventTypeName() {
+#ifdef _MSC_VER
+  return __FUNCSIG__;
+#else
+  return __PRETTY_FUNCTION__;
+#endif
+}
+
+/**
+ * Get the id of a typed event's type.
+ * @tparam T type of the event
+ * @return id of the type
+ * @note The id is derived from the type's name (FNV-1a), not from the address
+ * of a static variable, so it is the same across shared libraries.
+ */
+template <typename T> constexpr EventTypeId GetEventTypeId() {
+  EventTypeId hash = 14695981039346656037ull;
+  for (char c : GetEventTypeName<T>()) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+} // namespace hive::events
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "common/assert/Assert.h"
+#include "events/EventTypeId.h"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace hive::events {
+
+/**
+ * Holds a typed event of any type (the payload) together with its type id.
+ * Small events are stored inline, so creating and moving them does not
+ * allocate. Larger events are stored on the heap.
+ * @note In contrast to events::Event, typed events carry no topic, id or
+ * key-value payload: The event's type is its topic.
+ */
+class TypedEvent {
+public:
+  /** size of events (in bytes) that are stored inline */
+  static constexpr size_t c_inline_capacity = 64;
+
+private:
+  /** type-specific operations of the stored event */
+  struct Operations {
+    void (*destroy)(TypedEvent &event);
+    void (*move)(TypedEvent &from, TypedEvent &to);
+  };
+
+  template <typename T>
+  static constexpr bool c_is_stored_inline =
+      sizeof(T) <= c_inline_capacity &&
+      alignof(T) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<T>;
+
+  template <typename T> static const Operations *GetInlineOperations();
+  template <typename T> static const Operations *GetHeapOperations();
+
+  EventTypeId m_type{0};
+  const Operations *m_operations{nullptr};
+
+  /** small events are constructed in here */
+  alignas(std::max_align_t) std::byte m_storage[c_inline_capacity];
+
+  /** points to the stored event (either inline or on the heap) */
+  void *m_event{nullptr};
+
+  void Reset();
+
+public:
+  TypedEvent() = default;
+
+  /**
+   * Takes ownership of a typed event.
+   * @tparam T type of the event
+   * @param event event which is moved into this holder
+   */
+  template <typename T, typename = std::enable_if_t<
+                            !std::is_same_v<std::decay_t<T>, TypedEvent>>>
+  explicit TypedEvent(T &&event);
+
+  TypedEvent(TypedEvent &&other) noexcept;
+  TypedEvent &operator=(TypedEvent &&other) noexcept;
+  TypedEvent(const TypedEvent &other) = delete;
+  TypedEvent &operator=(const TypedEvent &other) = delete;
+  ~TypedEvent();
+
+  /**
+   * Get the type id of the stored event.
+   * @return type id or 0, if this holder is empty
+   */
+  EventTypeId GetType() const;
+
+  /**
+   * Checks if the stored event has a certain type.
+   * @tparam T expected type of the event
+   * @return true, if the event has this type
+   */
+  template <typename T> bool Is() const;
+
+  /**
+   * Get the stored event.
+   * @tparam T type of the event
+   * @return reference to the event
+   * @attention The type must match the type of the stored event (see Is)
+   */
+  template <typename T> const T &Get() const;
+};
+
+template <typename T> const TypedEvent::Operations *
+TypedEvent::GetInlineOperations() {
+  static const Operations operations{
+      [](TypedEvent &event) { static_cast<T *>(event.m_event)->~T(); },
+      [](TypedEvent &from, TypedEvent &to) {
+        to.m_event =
+            new (to.m_storage) T(std::move(*static_cast<T *>(from.m_event)));
+        static_cast<T *>(from.m_event)->~T();
+      }};
+  return &operations;
+}
+
+template <typename T> const TypedEvent::Operations *
+TypedEvent::GetHeapOperations() {
+  static const Operations operations{
+      [](TypedEvent &event) { delete static_cast<T *>(event.m_event); },
+      [](TypedEvent &from, TypedEvent &to) { to.m_event = from.m_event; }};
+  return &operations;
+}
+
+template <typename T, typename>
+TypedEvent::TypedEvent(T &&event) : m_type{GetEventTypeId<std::decay_t<T>>()} {
+  using EventType = std::decay_t<T>;
+  if constexpr (c_is_stored_inline<EventType>) {
+    m_event = new (m_storage) EventType(std::forward<T>(event));
+    m_operations = GetInlineOperations<EventType>();
+  } else {
+    m_event = new EventType(std::forward<T>(event));
+    m_operations = GetHeapOperations<EventType>();
+  }
+}
+
+inline TypedEvent::TypedEvent(TypedEvent &&other) noexcept {
+  *this = std::move(other);
+}
+
+inline TypedEvent &TypedEvent::operator=(TypedEvent &&other) noexcept {
+  if (this != &other) {
+    Reset();
+    if (other.m_operations) {
+      other.m_operations->move(other, *this);
+      m_type = other.m_type;
+      m_operations = other.m_operations;
+
+      // the other holder does not own the event anymore
+      other.m_event = nullptr;
+      other.m_operations = nullptr;
+      other.m_type = 0;
+    }
+  }
+  return *this;
+}
+
+inline TypedEvent::~TypedEvent() { Reset(); }
+
+inline void TypedEvent::Reset() {
+  if (m_operations) {
+    m_operations->destroy(*this);
+    m_operations = nullptr;
+    m_event = nullptr;
+    m_type = 0;
+  }
+}
+
+inline EventTypeId TypedEvent::GetType() const { return m_type; }
+
+template <typename T> inline bool TypedEvent::Is() const {
+  return m_operations && m_type == GetEventTypeId<T>();
+}
+
+template <typename T> inline const T &TypedEvent::Get() const {
+  DEBUG_ASSERT(Is<T>(), "typed event does not have the requested type")
+  return *static_cast<const T *>(m_event);
+}
+
+} // namespace hive::events
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "events/Event.h"
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace hive::events {
+
+/**
+ * Describes how events of a high-frequency topic are combined before they are
+ * delivered. Instead of one job per event and listener, each listener receives
+ * all pending events as a single batch (see IEventListener::HandleEvents).
+ */
+struct EventCoalescingPolicy {
+  /**
+   * Extracts the key of an event. A pending event is replaced by a newer one
+   * with the same key (latest-wins). If empty, all events are kept.
+   */
+  std::function<std::string(const SharedEvent &)> key;
+
+  /**
+   * Count of pending events which causes the batch to be delivered right away.
+   * Zero means there is no limit.
+   */
+  size_t max_batch_size{0};
+
+  /**
+   * Time window starting with the first pending event in which further events
+   * are collected (debounce). If zero, events are collected until the next
+   * execution cycle.
+   */
+  std::chrono::duration<double> window{0};
+};
+
+} // namespace hive::events
@@ -1,8 +1,13 @@
 #pragma once
 
 #include "events/Event.h"
+#include "events/TypedEvent.h"
+#include "events/broker/EventCoalescingPolicy.h"
+#include "events/listener/DispatchMode.h"
 #include "events/listener/IEventListener.h"
+#include "events/listener/ITypedEventListener.h"
 #include <memory>
+#include <type_traits>
 
 namespace hive::events {
 
@@ -10,6 +15,31 @@ namespace hive::events {
  * Manages events and propagates them from emitters to event listeners.
  */
 class IEventBroker {
+protected:
+  /**
+   * Transfers a typed event to all listeners registered for its type.
+   * @param event typed event that must be triggered
+   */
+  virtual void FireTypedEvent(TypedEvent event) = 0;
+
+  /**
+   * Add a listener for a type of typed events.
+   * @param listener listener to add
+   * @param type type id of the events the listener is interested in
+   */
+  virtual void
+  RegisterTypedListener(std::weak_ptr<ITypedEventListenerBase> listener,
+                        EventTypeId type) = 0;
+
+  /**
+   * Remove a listener from a type of typed events.
+   * @param listener listener to remove
+   * @param type type id of the events the listener is no longer interested in
+   */
+  virtual void
+  RemoveTypedListener(const std::weak_ptr<ITypedEventListenerBase> &listener,
+                      EventTypeId type) = 0;
+
 public:
   virtual ~IEventBroker() = default;
   /**
@@ -32,11 +62,16 @@ public:
    * Add a listener for a specific topic of event. The listener will be
    * notified when this event occurs.
    * @param listener listener to add
-   * @param topic topic of event the listener is interested in
+   * @param topic topic of event the listener is interested in. Topics can be
+   * hierarchical (e.g. 'net.connection.closed') and contain wildcards: '*'
+   * matches a single segment and '**' any number of segments.
+   * @param mode decides how the listener is invoked. Inline listeners are
+   * called on the firing thread and must never block.
    * @attention The broker does not own any listeners (see weak pointer)
    */
   virtual void RegisterListener(std::weak_ptr<IEventListener> listener,
-                                const std::string &topic) = 0;
+                                const std::string &topic,
+                                DispatchMode mode = DispatchMode::JOB) = 0;
 
   /**
    * Remove listener from all event types.
@@ -56,6 +91,73 @@ public:
    * Removes all listeners from the event manager
    */
   virtual void RemoveAllListeners() = 0;
+
+  /**
+   * Coalesces events of a high-frequency topic: Instead of delivering each
+   * event separately, listeners receive pending events in batches.
+   * @param topic exact topic of events that should be coalesced
+   * @param policy decides which events are kept and when batches are delivered
+   * @note Replacing a policy does not drop events which are still pending.
+   */
+  virtual void SetCoalescingPolicy(const std::string &topic,
+                                   EventCoalescingPolicy policy) = 0;
+
+  /**
+   * Stops coalescing events of a topic, so they are delivered separately
+   * again.
+   * @param topic topic of events that should no longer be coalesced
+   */
+  virtual void RemoveCoalescingPolicy(const std::string &topic) = 0;
+
+  /**
+   * Triggers a typed event and transfers it to all listeners registered for
+   * its type. In contrast to string topics, typed events are dispatched by
+   * their compile-time type id and small ones are stored inline.
+   * @tparam T type of the event
+   * @param event event that must be triggered
+   * @note Firing still allocates the job delivering the event and whatever
+   * the job system needs to schedule it.
+   */
+  template <typename T,
+            typename = std::enable_if_t<
+                !std::is_convertible_v<std::decay_t<T>, SharedEvent>>>
+  void FireEvent(T &&event);
+
+  /**
+   * Add a listener for events of the type it handles.
+   * @tparam Listener implementation of ITypedEventListener
+   * @param listener listener to add
+   * @attention The broker does not own any listeners (it only keeps a weak
+   * pointer)
+   */
+  template <typename Listener>
+  void RegisterListener(const std::shared_ptr<Listener> &listener);
+
+  /**
+   * Remove a listener from events of the type it handles.
+   * @tparam Listener implementation of ITypedEventListener
+   * @param listener listener to remove
+   */
+  template <typename Listener>
+  void RemoveListener(const std::shared_ptr<Listener> &listener);
 };
 
+template <typename T, typename> void IEventBroker::FireEvent(T &&event) {
+  FireTypedEvent(TypedEvent(std::forward<T>(event)));
+}
+
+template <typename Listener>
+void IEventBroker::RegisterListener(const std::shared_ptr<Listener> &listener) {
+  using EventType = typename Listener::EventType;
+  std::shared_ptr<ITypedEventListener<EventType>> typed_listener = listener;
+  RegisterTypedListener(typed_listener, GetEventTypeId<EventType>());
+}
+
+template <typename Listener>
+void IEventBroker::RemoveListener(const std::shared_ptr<Listener> &listener) {
+  using EventType = typename Listener::EventType;
+  std::shared_ptr<ITypedEventListener<EventType>> typed_listener = listener;
+  RemoveTypedListener(typed_listener, GetEventTypeId<EventType>());
+}
+
 } // namespace hive::events
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace hive::events::brokers {
+
+/**
+ * Subscribers of a single topic kept in an immutable array (copy-on-write).
+ * Readers get a snapshot without taking any lock, while writers copy the
+ * array, modify the copy and publish it atomically.
+ * @tparam Subscriber weak pointer to a listener or a type wrapping one that
+ * provides expired()
+ * @note Writers must be serialized by the owner of this list. Expired
+ * subscribers are dropped by every modification.
+ */
+template <typename Subscriber> class CopyOnWriteSubscribers {
+public:
+  typedef std::vector<Subscriber> SubscriberList;
+  typedef std::shared_ptr<const SubscriberList> SharedSubscriberList;
+
+private:
+  std::atomic<SharedSubscriberList> m_subscribers;
+
+public:
+  /**
+   * Get a snapshot of the current subscribers without locking.
+   * @return immutable list of subscribers or nullptr, if there are none
+   * @note The snapshot could contain expired subscribers.
+   */
+  SharedSubscriberList Get() const;
+
+  /**
+   * Adds a subscriber if there is no equal one yet.
+   * @param subscriber subscriber to add
+   * @param is_equal predicate checking if an existing subscriber equals the
+   * new one
+   * @return true, if the subscriber has been added
+   */
+  template <typename Predicate>
+  bool Add(Subscriber subscriber, Predicate is_equal);
+
+  /**
+   * Removes all subscribers matching the predicate and all expired ones.
+   * @param should_remove predicate deciding which subscribers are removed
+   */
+  template <typename Predicate> void Remove(Predicate should_remove);
+
+  /**
+   * Removes all expired subscribers.
+   */
+  void Prune();
+};
+
+template <typename Subscriber>
+inline typename CopyOnWriteSubscribers<Subscriber>::SharedSubscriberList
+CopyOnWriteSubscribers<Subscriber>::Get() const {
+  return m_subscribers.load();
+}
+
+template <typename Subscriber>
+template <typename Predicate>
+bool CopyOnWriteSubscribers<Subscriber>::Add(Subscriber subscriber,
+                                             Predicate is_equal) {
+  auto subscribers = m_subscribers.load();
+  auto new_subscribers = std::make_shared<SubscriberList>();
+  if (subscribers) {
+    new_subscribers->reserve(subscribers->size() + 1);
+    for (const auto &existing_subscriber : *subscribers) {
+      if (existing_subscriber.expired()) {
+        continue /* because this is a good opportunity to prune */;
+      }
+
+      if (is_equal(existing_subscriber)) {
+        return false;
+      }
+
+      new_subscribers->push_back(existing_subscriber);
+    }
+  }
+
+  new_subscribers->push_back(std::move(subscriber));
+  m_subscribers.store(std::move(new_subscribers));
+  return true;
+}
+
+template <typename Subscriber>
+template <typename Predicate>
+void CopyOnWriteSubscribers<Subscriber>::Remove(Predicate should_remove) {
+  auto subscribers = m_subscribers.load();
+  if (!subscribers) {
+    return;
+  }
+
+  auto new_subscribers = std::make_shared<SubscriberList>();
+  new_subscribers->reserve(subscribers->size());
+  for (const auto &subscriber : *subscribers) {
+    if (!subscriber.expired() && !should_remove(subscriber)) {
+      new_subscribers->push_back(subscriber);
+    }
+  }
+
+  if (new_subscribers->size() == subscribers->size()) {
+    return /* because nothing has changed */;
+  }
+
+  if (new_subscribers->empty()) {
+    m_subscribers.store(nullptr);
+  } else {
+    m_subscribers.store(std::move(new_subscribers));
+  }
+}
+
+template <typename Subscriber>
+void CopyOnWriteSubscribers<Subscriber>::Prune() {
+  Remove([](const auto &) { return false; });
+}
+
+} // namespace hive::events::brokers
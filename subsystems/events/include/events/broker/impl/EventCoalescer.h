@@ -0,0 +1,72 @@
+#pragma once
+
+#include "events/Event.h"
+#include "events/broker/EventCoalescingPolicy.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hive::events::brokers {
+
+/**
+ * Collects pending events of a single topic according to its coalescing
+ * policy until they are delivered as a batch.
+ */
+class EventCoalescer {
+public:
+  /** tells the broker what to do after an event has been added */
+  enum AddResult {
+    /** the event is delivered by an already scheduled flush */
+    PENDING,
+    /** this is the first pending event, so a flush must be scheduled */
+    SCHEDULE_FLUSH,
+    /** the batch is full and must be delivered right away */
+    FLUSH
+  };
+
+private:
+  const EventCoalescingPolicy m_policy;
+
+  mutable jobsystem::mutex m_mutex;
+  std::vector<SharedEvent> m_pending_events;
+
+  /** index of the pending event of each key (if events are keyed) */
+  std::unordered_map<std::string, size_t> m_pending_event_indices;
+
+  /** if a flush job has been scheduled, but not executed yet */
+  bool m_flush_scheduled{false};
+
+public:
+  explicit EventCoalescer(EventCoalescingPolicy policy);
+  EventCoalescer(EventCoalescer &other) = delete;
+
+  /**
+   * Adds an event to the pending batch or replaces a pending event with the
+   * same key.
+   * @param event fired event
+   * @return how the broker must proceed
+   */
+  AddResult Add(SharedEvent event);
+
+  /**
+   * Takes all pending events, e.g. because the batch is full.
+   * @return pending events in the order they have been fired
+   */
+  std::vector<SharedEvent> TakeBatch();
+
+  /**
+   * Takes all pending events when the scheduled flush is executed. The next
+   * event will cause another flush to be scheduled.
+   * @return pending events in the order they have been fired
+   */
+  std::vector<SharedEvent> TakeScheduledBatch();
+
+  const EventCoalescingPolicy &GetPolicy() const;
+};
+
+inline const EventCoalescingPolicy &EventCoalescer::GetPolicy() const {
+  return m_policy;
+}
+
+} // namespace hive::events::brokers
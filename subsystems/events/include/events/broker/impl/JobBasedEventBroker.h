@@ -3,11 +3,15 @@
 #include "common/memory/ExclusiveOwnership.h"
 #include "common/subsystems/SubsystemManager.h"
 #include "events/broker/IEventBroker.h"
+#include "events/broker/impl/EventCoalescer.h"
+#include "events/broker/impl/SubscriberRegistry.h"
+#include "events/broker/impl/TopicSubscriberTrie.h"
 #include "events/listener/IEventListener.h"
 #include "jobsystem/manager/JobManager.h"
-#include <map>
+#include <atomic>
 #include <memory>
-#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace hive::events::brokers {
@@ -15,27 +19,88 @@ namespace hive::events::brokers {
 /**
  * Using the jobsystem queue by wrapping the task of notifying events into jobs
  * instead of employing its own event queue.
+ * @note Firing events does not acquire any lock: Subscribers are read from
+ * immutable snapshots which are replaced when listeners are (un-)registered.
+ * @note Depending on their dispatch mode, listeners are called on the firing
+ * thread, by a job each, or by a single job shared with other listeners.
  */
 class JobBasedEventBroker final : public events::IEventBroker {
 private:
   /**
-   * Maps the topic name (as string) to all of its subscribers.
-   * @note Subscribers are kept as weak references (in case the listener is
-   * destroyed).
+   * Maps topic names and patterns (e.g. 'net.connection.*') to all of their
+   * subscribers.
    */
-  std::map<std::string, std::vector<std::weak_ptr<IEventListener>>>
-      m_event_listeners;
-  mutable jobsystem::mutex m_event_listeners_mutex;
+  TopicSubscriberTrie m_event_listeners;
+
+  /** Maps the type id of typed events to all of their subscribers. */
+  SubscriberRegistry<EventTypeId, ITypedEventListenerBase>
+      m_typed_event_listeners;
+
+  typedef std::unordered_map<std::string, std::shared_ptr<EventCoalescer>>
+      CoalescerMap;
+
+  /**
+   * Maps topics to the coalescers collecting their pending events. Like the
+   * subscribers, the map is only replaced (by policy changes), so firing
+   * events can read it without locking.
+   */
+  std::atomic<std::shared_ptr<const CoalescerMap>> m_coalescers;
+  jobsystem::mutex m_coalescers_mutex;
 
   /** Contains required subsystems */
   common::memory::Reference<common::subsystems::SubsystemManager> m_subsystems;
 
+  /** Scheduled flush jobs use this to check if the broker still exists */
+  std::shared_ptr<bool> m_this_alive_checker;
+
   /**
-   * Goes through all subscribers of all topics and checks if they are
-   * still valid and if they still exist.
+   * Collects all subscribers of patterns matching the topic. Listeners of
+   * multiple matching patterns are only collected once.
+   * @param topic topic of the fired event
+   * @param subscribers receives the subscribers
    */
-  void CleanUpSubscribers();
-  std::shared_ptr<bool> m_this_alive_checker;
+  void CollectSubscribers(const std::string &topic,
+                          std::vector<TopicSubscriber> &subscribers);
+
+  /**
+   * Invokes all subscribers according to their dispatch mode.
+   * @param topic topic of the events
+   * @param subscribers subscribers of the topic
+   * @param handler calls the listener
+   * @param job_manager used for scheduling jobs
+   */
+  template <typename Handler>
+  void Dispatch(const std::string &topic,
+                std::vector<TopicSubscriber> &subscribers,
+                const Handler &handler, jobsystem::JobManager &job_manager);
+
+  /**
+   * Adds an event to the pending batch of its coalesced topic and schedules
+   * or performs its delivery if necessary.
+   * @param coalescer coalescer of the event's topic
+   * @param event fired event
+   * @param job_manager used for delivering the batch
+   */
+  void CoalesceEvent(const std::shared_ptr<EventCoalescer> &coalescer,
+                     SharedEvent event, jobsystem::JobManager &job_manager);
+
+  /**
+   * Delivers a batch of events to all listeners of their topic. Each listener
+   * receives the whole batch in a single job.
+   * @param topic topic of the events
+   * @param batch coalesced events
+   * @param job_manager used for delivering the batch
+   */
+  void DeliverBatch(const std::string &topic, std::vector<SharedEvent> batch,
+                    jobsystem::JobManager &job_manager);
+
+protected:
+  void FireTypedEvent(TypedEvent event) override;
+  void RegisterTypedListener(std::weak_ptr<ITypedEventListenerBase> listener,
+                             EventTypeId type) override;
+  void
+  RemoveTypedListener(const std::weak_ptr<ITypedEventListenerBase> &listener,
+                      EventTypeId type) override;
 
 public:
   explicit JobBasedEventBroker(
@@ -43,14 +108,22 @@ public:
           &subsystems);
   ~JobBasedEventBroker() override;
 
+  // typed event API
+  using IEventBroker::FireEvent;
+  using IEventBroker::RegisterListener;
+
   void FireEvent(SharedEvent event) override;
   bool HasListener(const std::string &subscriber_id,
                    const std::string &topic) const override;
   void RegisterListener(std::weak_ptr<IEventListener> listener,
-                        const std::string &topic) override;
+                        const std::string &topic,
+                        DispatchMode mode = DispatchMode::JOB) override;
   void UnregisterListener(std::weak_ptr<IEventListener> listener) override;
   void RemoveListenerFromTopic(std::weak_ptr<IEventListener> subscriber,
                                const std::string &topic) override;
   void RemoveAllListeners() override;
+  void SetCoalescingPolicy(const std::string &topic,
+                           EventCoalescingPolicy policy) override;
+  void RemoveCoalescingPolicy(const std::string &topic) override;
 };
 } // namespace hive::events::brokers
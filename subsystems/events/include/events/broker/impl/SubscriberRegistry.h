@@ -0,0 +1,190 @@
+#pragma once
+
+#include "events/broker/impl/CopyOnWriteSubscribers.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace hive::events::brokers {
+
+/**
+ * Keeps the subscribers of each topic in immutable arrays (see
+ * CopyOnWriteSubscribers). Readers get a snapshot of a topic's subscribers
+ * without taking any lock, so firing events is free of contention, even while
+ * listeners are registered or removed.
+ * @tparam Key identifies a topic (e.g. its type id)
+ * @tparam Listener type of subscribers
+ */
+template <typename Key, typename Listener> class SubscriberRegistry {
+public:
+  typedef CopyOnWriteSubscribers<std::weak_ptr<Listener>> Topic;
+  typedef typename Topic::SharedSubscriberList SharedSubscriberList;
+
+private:
+  typedef std::unordered_map<Key, std::shared_ptr<Topic>> TopicMap;
+
+  /**
+   * Maps each topic to its subscribers. The map itself is only replaced when a
+   * new topic is added, so it can be read without locking as well.
+   */
+  std::atomic<std::shared_ptr<const TopicMap>> m_topics;
+
+  /** serializes writers, readers never acquire it */
+  mutable jobsystem::mutex m_write_mutex;
+
+  /**
+   * Get the topic with the given key or create it.
+   * @param key key of the topic
+   * @return topic
+   * @note The write mutex must be acquired by the caller.
+   */
+  std::shared_ptr<Topic> GetOrCreateTopic(const Key &key);
+
+  /**
+   * Get the topic with the given key.
+   * @param key key of the topic
+   * @return topic or nullptr, if it does not exist
+   */
+  std::shared_ptr<Topic> FindTopic(const Key &key) const;
+
+public:
+  SubscriberRegistry();
+  SubscriberRegistry(SubscriberRegistry &other) = delete;
+
+  /**
+   * Get a snapshot of the current subscribers of a topic without locking.
+   * @param key key of the topic
+   * @return immutable list of subscribers or nullptr, if there are none
+   * @note The snapshot could contain expired subscribers.
+   */
+  SharedSubscriberList GetSubscribers(const Key &key) const;
+
+  /**
+   * Adds a subscriber to a topic if it does not contain an equal one yet.
+   * @param key key of the topic
+   * @param subscriber subscriber to add
+   * @param is_equal predicate checking if an existing subscriber equals the
+   * new one
+   * @return true, if the subscriber has been added
+   */
+  template <typename Predicate>
+  bool Add(const Key &key, std::weak_ptr<Listener> subscriber,
+           Predicate is_equal);
+
+  /**
+   * Removes all subscribers from a topic matching a predicate.
+   * @param key key of the topic
+   * @param should_remove predicate deciding which subscribers are removed
+   */
+  template <typename Predicate>
+  void Remove(const Key &key, Predicate should_remove);
+
+  /**
+   * Removes all subscribers from all topics matching a predicate.
+   * @param should_remove predicate deciding which subscribers are removed
+   */
+  template <typename Predicate> void RemoveFromAll(Predicate should_remove);
+
+  /**
+   * Removes expired subscribers from a topic. This is meant to be called by
+   * readers that came across expired subscribers, so it does nothing if
+   * another writer is currently busy.
+   * @param key key of the topic
+   */
+  void Prune(const Key &key);
+
+  /**
+   * Removes all topics and subscribers.
+   */
+  void Clear();
+};
+
+template <typename Key, typename Listener>
+SubscriberRegistry<Key, Listener>::SubscriberRegistry()
+    : m_topics{std::make_shared<const TopicMap>()} {}
+
+template <typename Key, typename Listener>
+std::shared_ptr<typename SubscriberRegistry<Key, Listener>::Topic>
+SubscriberRegistry<Key, Listener>::FindTopic(const Key &key) const {
+  auto topics = m_topics.load();
+  auto iterator = topics->find(key);
+  if (iterator == topics->end()) {
+    return nullptr;
+  }
+  return iterator->second;
+}
+
+template <typename Key, typename Listener>
+std::shared_ptr<typename SubscriberRegistry<Key, Listener>::Topic>
+SubscriberRegistry<Key, Listener>::GetOrCreateTopic(const Key &key) {
+  if (auto topic = FindTopic(key)) {
+    return topic;
+  }
+
+  // new topics are rare, so copying the map is acceptable
+  auto topics = std::make_shared<TopicMap>(*m_topics.load());
+  auto topic = std::make_shared<Topic>();
+  topics->emplace(key, topic);
+  m_topics.store(std::move(topics));
+  return topic;
+}
+
+template <typename Key, typename Listener>
+typename SubscriberRegistry<Key, Listener>::SharedSubscriberList
+SubscriberRegistry<Key, Listener>::GetSubscribers(const Key &key) const {
+  if (auto topic = FindTopic(key)) {
+    return topic->Get();
+  }
+  return nullptr;
+}
+
+template <typename Key, typename Listener>
+template <typename Predicate>
+bool SubscriberRegistry<Key, Listener>::Add(const Key &key,
+                                            std::weak_ptr<Listener> subscriber,
+                                            Predicate is_equal) {
+  std::unique_lock lock(m_write_mutex);
+  return GetOrCreateTopic(key)->Add(std::move(subscriber), is_equal);
+}
+
+template <typename Key, typename Listener>
+template <typename Predicate>
+void SubscriberRegistry<Key, Listener>::Remove(const Key &key,
+                                               Predicate should_remove) {
+  std::unique_lock lock(m_write_mutex);
+  if (auto topic = FindTopic(key)) {
+    topic->Remove(should_remove);
+  }
+}
+
+template <typename Key, typename Listener>
+template <typename Predicate>
+void SubscriberRegistry<Key, Listener>::RemoveFromAll(
+    Predicate should_remove) {
+  std::unique_lock lock(m_write_mutex);
+  for (const auto &[key, topic] : *m_topics.load()) {
+    topic->Remove(should_remove);
+  }
+}
+
+template <typename Key, typename Listener>
+void SubscriberRegistry<Key, Listener>::Prune(const Key &key) {
+  std::unique_lock lock(m_write_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return /* because the next reader can try again */;
+  }
+
+  if (auto topic = FindTopic(key)) {
+    topic->Prune();
+  }
+}
+
+template <typename Key, typename Listener>
+void SubscriberRegistry<Key, Listener>::Clear() {
+  std::unique_lock lock(m_write_mutex);
+  m_topics.store(std::make_shared<const TopicMap>());
+}
+
+} // namespace hive::events::brokers
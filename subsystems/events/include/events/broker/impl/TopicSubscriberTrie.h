@@ -0,0 +1,251 @@
+#pragma once
+
+#include "events/broker/impl/CopyOnWriteSubscribers.h"
+#include "events/listener/DispatchMode.h"
+#include "events/listener/IEventListener.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hive::events::brokers {
+
+/**
+ * Listener subscribed to a topic or pattern.
+ */
+struct TopicSubscriber {
+  std::weak_ptr<IEventListener> listener;
+  DispatchMode mode{JOB};
+
+  bool expired() const { return listener.expired(); }
+};
+
+/**
+ * Indexes subscribers of hierarchical topics and topic patterns in a trie.
+ * Topics consist of segments separated by dots (e.g.
+ * 'net.connection.closed'). Patterns can contain wildcard segments:
+ * - '*' matches exactly one segment (e.g. 'net.*.closed')
+ * - '**' matches any number of segments, including none (e.g. 'net.**')
+ *
+ * Segments are interned, so walking the trie compares integers instead of
+ * strings. Finding all subscribers of a topic takes a single walk through the
+ * trie, no matter how many topics and patterns have been registered.
+ *
+ * @note Like the subscribers, nodes and interned segments are immutable once
+ * published: Matching topics does not acquire any lock.
+ * @note Nodes and interned segments are never removed, even if there are no
+ * subscribers left (except when clearing the trie).
+ */
+class TopicSubscriberTrie {
+public:
+  typedef CopyOnWriteSubscribers<TopicSubscriber>::SharedSubscriberList
+      SharedSubscriberList;
+  typedef uint32_t SegmentId;
+
+  static constexpr char c_segment_separator = '.';
+  static constexpr std::string_view c_single_wildcard = "*";
+  static constexpr std::string_view c_multi_wildcard = "**";
+
+private:
+  /** reserved segment ids of wildcards */
+  static constexpr SegmentId c_single_wildcard_id = 0;
+  static constexpr SegmentId c_multi_wildcard_id = 1;
+
+  /** segment ids of segments that have never been interned */
+  static constexpr SegmentId c_unknown_segment_id = UINT32_MAX;
+
+  struct Node;
+  typedef std::unordered_map<SegmentId, std::shared_ptr<Node>> ChildMap;
+
+  struct Node {
+    /** true, if this node has been reached using a '**' segment */
+    bool is_multi_wildcard{false};
+    std::atomic<std::shared_ptr<const ChildMap>> children;
+    CopyOnWriteSubscribers<TopicSubscriber> subscribers;
+  };
+
+  typedef std::unordered_map<std::string_view, SegmentId> SegmentMap;
+
+  std::atomic<std::shared_ptr<Node>> m_root;
+
+  /**
+   * Maps interned segments to their ids. The keys point into the segment
+   * storage, which only grows, so they stay valid for all snapshots.
+   */
+  std::atomic<std::shared_ptr<const SegmentMap>> m_segment_ids;
+  std::deque<std::string> m_segment_storage;
+  SegmentId m_next_segment_id{c_multi_wildcard_id + 1};
+
+  /** serializes writers, readers never acquire it */
+  mutable jobsystem::mutex m_write_mutex;
+
+  /**
+   * Get the id of a segment without interning it.
+   * @param segments snapshot of interned segments
+   * @param segment segment of a topic
+   * @return id of the segment or c_unknown_segment_id, if it is unknown
+   */
+  static SegmentId GetSegmentId(const SegmentMap &segments,
+                                std::string_view segment);
+
+  /**
+   * Get the id of a pattern's segment and intern it if necessary.
+   * @param segment segment of a pattern
+   * @return id of the segment
+   * @note The write mutex must be acquired by the caller.
+   */
+  SegmentId InternSegment(std::string_view segment);
+
+  /**
+   * Get the child of a node or create it.
+   * @param node parent node
+   * @param segment_id id of the child's segment
+   * @return child node
+   * @note The write mutex must be acquired by the caller.
+   */
+  static std::shared_ptr<Node> GetOrCreateChild(Node &node,
+                                                SegmentId segment_id);
+
+  /**
+   * Get the node of a pattern.
+   * @param pattern topic or topic pattern
+   * @return node or nullptr, if it does not exist
+   */
+  std::shared_ptr<Node> FindNode(std::string_view pattern) const;
+
+  /**
+   * Get the node of a pattern or create it (and all nodes on its path).
+   * @param pattern topic or topic pattern
+   * @return node
+   * @note The write mutex must be acquired by the caller.
+   */
+  std::shared_ptr<Node> GetOrCreateNode(std::string_view pattern);
+
+  /**
+   * Finds all nodes whose patterns match the topic.
+   * @param topic topic of an event
+   * @param root root node to start the walk from
+   * @param matches receives all matching nodes
+   */
+  void FindMatchingNodes(std::string_view topic, Node *root,
+                         std::vector<Node *> &matches) const;
+
+  /**
+   * Visits all nodes of the trie.
+   * @param node node to start from
+   * @param visitor function called for each node
+   */
+  template <typename Visitor>
+  static void VisitNodes(Node &node, const Visitor &visitor);
+
+public:
+  TopicSubscriberTrie();
+  TopicSubscriberTrie(TopicSubscriberTrie &other) = delete;
+
+  /**
+   * Checks if a topic or pattern contains wildcards.
+   * @param pattern topic or pattern
+   * @return true, if it contains at least one wildcard segment
+   */
+  static bool IsPattern(std::string_view pattern);
+
+  /**
+   * Collects snapshots of all subscribers of patterns matching the topic
+   * without locking.
+   * @param topic topic of the fired event
+   * @param matches receives a snapshot for each matching pattern that has
+   * subscribers
+   */
+  void Match(std::string_view topic,
+             std::vector<SharedSubscriberList> &matches) const;
+
+  /**
+   * Get a snapshot of the subscribers registered for exactly this topic or
+   * pattern.
+   * @param pattern topic or pattern the subscribers have been registered for
+   * @return immutable list of subscribers or nullptr, if there are none
+   */
+  SharedSubscriberList GetSubscribers(std::string_view pattern) const;
+
+  /**
+   * Adds a subscriber to a topic or pattern if it does not contain an equal
+   * one yet.
+   * @param pattern topic or pattern
+   * @param subscriber subscriber to add
+   * @param is_equal predicate checking if an existing subscriber equals the
+   * new one
+   * @return true, if the subscriber has been added
+   */
+  template <typename Predicate>
+  bool Add(std::string_view pattern, TopicSubscriber subscriber,
+           Predicate is_equal);
+
+  /**
+   * Removes all subscribers of a topic or pattern matching a predicate.
+   * @param pattern topic or pattern
+   * @param should_remove predicate deciding which subscribers are removed
+   */
+  template <typename Predicate>
+  void Remove(std::string_view pattern, Predicate should_remove);
+
+  /**
+   * Removes all subscribers of all topics and patterns matching a predicate.
+   * @param should_remove predicate deciding which subscribers are removed
+   */
+  template <typename Predicate> void RemoveFromAll(Predicate should_remove);
+
+  /**
+   * Removes expired subscribers from all patterns matching the topic. This is
+   * meant to be called by readers that came across expired subscribers, so it
+   * does nothing if another writer is currently busy.
+   * @param topic topic of a fired event
+   */
+  void Prune(std::string_view topic);
+
+  /**
+   * Removes all topics, patterns and subscribers.
+   */
+  void Clear();
+};
+
+template <typename Visitor>
+void TopicSubscriberTrie::VisitNodes(Node &node, const Visitor &visitor) {
+  visitor(node);
+  if (auto children = node.children.load()) {
+    for (const auto &[segment_id, child] : *children) {
+      VisitNodes(*child, visitor);
+    }
+  }
+}
+
+template <typename Predicate>
+bool TopicSubscriberTrie::Add(std::string_view pattern,
+                              TopicSubscriber subscriber, Predicate is_equal) {
+  std::unique_lock lock(m_write_mutex);
+  auto node = GetOrCreateNode(pattern);
+  return node->subscribers.Add(std::move(subscriber), is_equal);
+}
+
+template <typename Predicate>
+void TopicSubscriberTrie::Remove(std::string_view pattern,
+                                 Predicate should_remove) {
+  std::unique_lock lock(m_write_mutex);
+  if (auto node = FindNode(pattern)) {
+    node->subscribers.Remove(should_remove);
+  }
+}
+
+template <typename Predicate>
+void TopicSubscriberTrie::RemoveFromAll(Predicate should_remove) {
+  std::unique_lock lock(m_write_mutex);
+  VisitNodes(*m_root.load(), [&should_remove](Node &node) {
+    node.subscribers.Remove(should_remove);
+  });
+}
+
+} // namespace hive::events::brokers
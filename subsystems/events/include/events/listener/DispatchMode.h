@@ -0,0 +1,26 @@
+#pragma once
+
+namespace hive::events {
+
+/**
+ * Decides how an event broker invokes a listener when an event is fired.
+ */
+enum DispatchMode {
+  /**
+   * The listener is called directly on the thread firing the event. This
+   * avoids scheduling a job, but the listener must never block (e.g. by
+   * waiting for jobs, futures or contended locks) or perform expensive work.
+   */
+  INLINE,
+
+  /** Each invocation of the listener is scheduled as a separate job. */
+  JOB,
+
+  /**
+   * The listener is called by a single job that delivers the event to all
+   * batched listeners one after another.
+   */
+  BATCHED
+};
+
+} // namespace hive::events
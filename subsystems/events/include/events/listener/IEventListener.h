@@ -1,6 +1,7 @@
 #pragma once
 
 #include "events/Event.h"
+#include <span>
 
 namespace hive::events {
 
@@ -16,6 +17,18 @@ public:
    */
   virtual void HandleEvent(SharedEvent event) = 0;
 
+  /**
+   * Handles a batch of events of a coalesced topic (see
+   * EventCoalescingPolicy) at once.
+   * @param events events that must be handled, in the order they were fired
+   * @note By default, each event is passed to HandleEvent separately.
+   */
+  virtual void HandleEvents(std::span<const SharedEvent> events) {
+    for (const auto &event : events) {
+      HandleEvent(event);
+    }
+  }
+
   /**
    * GetAsInt id of this listener instance
    * @return id (preferably uuid of this listener)
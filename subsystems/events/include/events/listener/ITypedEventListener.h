@@ -0,0 +1,50 @@
+#pragma once
+
+#include "events/TypedEvent.h"
+#include <memory>
+
+namespace hive::events {
+
+/**
+ * Type-independent part of a typed event listener, which allows the broker to
+ * manage listeners of all event types together.
+ */
+class ITypedEventListenerBase {
+public:
+  virtual ~ITypedEventListenerBase() = default;
+
+  /**
+   * Handles a typed event.
+   * @param event event of the type this listener has been registered for
+   */
+  virtual void HandleTypedEvent(const TypedEvent &event) = 0;
+};
+
+/**
+ * Handles typed events of a certain type propagated by an event broker.
+ * @tparam T type of events this listener is interested in
+ */
+template <typename T>
+class ITypedEventListener : public ITypedEventListenerBase {
+public:
+  typedef T EventType;
+
+  /**
+   * Handles incoming event of the type this listener has registered its
+   * interest in.
+   * @param event event that must be handled
+   */
+  virtual void HandleEvent(const T &event) = 0;
+
+  void HandleTypedEvent(const TypedEvent &event) final;
+};
+
+template <typename T>
+void ITypedEventListener<T>::HandleTypedEvent(const TypedEvent &event) {
+  HandleEvent(event.Get<T>());
+}
+
+template <typename T>
+using SharedTypedEventListener = std::shared_ptr<ITypedEventListener<T>>;
+
+} // namespace hive::events
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "events/listener/ITypedEventListener.h"
+#include <functional>
+
+namespace hive::events {
+
+/**
+ * Allows handling typed events using a simple lambda function instead of
+ * implementing the interface.
+ * @tparam T type of events this listener is interested in
+ */
+template <typename T>
+class TypedFunctionalEventListener : public ITypedEventListener<T> {
+protected:
+  const std::function<void(const T &)> m_function;
+
+public:
+  TypedFunctionalEventListener() = delete;
+  explicit TypedFunctionalEventListener(std::function<void(const T &)> func)
+      : m_function{std::move(func)} {};
+
+  void HandleEvent(const T &event) override { m_function(event); }
+};
+
+} // namespace hive::events
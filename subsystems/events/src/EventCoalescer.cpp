@@ -0,0 +1,53 @@
+#include "events/broker/impl/EventCoalescer.h"
+
+using namespace hive::events;
+using namespace hive::events::brokers;
+
+EventCoalescer::EventCoalescer(EventCoalescingPolicy policy)
+    : m_policy(std::move(policy)) {}
+
+EventCoalescer::AddResult EventCoalescer::Add(SharedEvent event) {
+  std::unique_lock lock(m_mutex);
+
+  if (m_policy.key) {
+    auto key = m_policy.key(event);
+    auto [index, inserted] =
+        m_pending_event_indices.try_emplace(key, m_pending_events.size());
+    if (!inserted) {
+      // latest wins, but the position of the first event is kept
+      m_pending_events[index->second] = std::move(event);
+      return PENDING;
+    }
+  }
+
+  m_pending_events.push_back(std::move(event));
+
+  if (m_policy.max_batch_size > 0 &&
+      m_pending_events.size() >= m_policy.max_batch_size) {
+    return FLUSH;
+  }
+
+  if (!m_flush_scheduled) {
+    m_flush_scheduled = true;
+    return SCHEDULE_FLUSH;
+  }
+
+  return PENDING;
+}
+
+std::vector<SharedEvent> EventCoalescer::TakeBatch() {
+  std::unique_lock lock(m_mutex);
+  std::vector<SharedEvent> batch;
+  batch.swap(m_pending_events);
+  m_pending_event_indices.clear();
+  return batch;
+}
+
+std::vector<SharedEvent> EventCoalescer::TakeScheduledBatch() {
+  std::unique_lock lock(m_mutex);
+  m_flush_scheduled = false;
+  std::vector<SharedEvent> batch;
+  batch.swap(m_pending_events);
+  m_pending_event_indices.clear();
+  return batch;
+}
@@ -1,55 +1,156 @@
 #include "events/broker/impl/JobBasedEventBroker.h"
+#include "jobsystem/jobs/TimerJob.h"
 #include "logging/LogManager.h"
+#include <algorithm>
+#include <chrono>
 
 using namespace hive::events;
 using namespace hive::events::brokers;
-using namespace std::chrono_literals;
 using namespace hive::jobsystem;
 
+/** inline listeners taking longer than this probably block */
+static constexpr auto c_inline_listener_budget = std::chrono::milliseconds(1);
+
+typedef SubscriberRegistry<EventTypeId, ITypedEventListenerBase>::
+    SharedSubscriberList SharedTypedSubscriberList;
+
+/**
+ * Delivers a single typed event to all of its listeners. The event is moved
+ * into the job, so small events are never copied or allocated separately.
+ */
+class TypedEventJob : public Job {
+private:
+  TypedEvent m_event;
+  SharedTypedSubscriberList m_listeners;
+
+public:
+  TypedEventJob(TypedEvent event, SharedTypedSubscriberList listeners)
+      : Job([this](JobContext *) { return DeliverEvent(); }, "typed-event"),
+        m_event(std::move(event)), m_listeners(std::move(listeners)) {
+    SetCategory("events");
+  }
+
+  JobContinuation DeliverEvent() {
+    for (const auto &weak_listener : *m_listeners) {
+      if (auto listener = weak_listener.lock()) {
+        listener->HandleTypedEvent(m_event);
+      }
+    }
+    return JobContinuation::DISPOSE;
+  }
+};
+
 JobBasedEventBroker::JobBasedEventBroker(
     const common::memory::Reference<common::subsystems::SubsystemManager>
         &subsystems)
-    : m_subsystems(subsystems), m_this_alive_checker{std::make_shared<bool>()} {
+    : m_coalescers{std::make_shared<const CoalescerMap>()},
+      m_subsystems(subsystems), m_this_alive_checker{std::make_shared<bool>()} {
+}
 
-  // when this shared pointer expired, this has been destroyed
-  std::weak_ptr<bool> alive_checker = m_this_alive_checker;
+JobBasedEventBroker::~JobBasedEventBroker() { RemoveAllListeners(); }
 
-  SharedJob clean_up_job = std::make_shared<TimerJob>(
-      [&, alive_checker](JobContext *) {
-        if (!alive_checker.expired()) {
-          this->CleanUpSubscribers();
-          return JobContinuation::REQUEUE;
-        } else {
-          return JobContinuation::DISPOSE;
-        }
-      },
-      "events-listener-clean-up", 5s, JobExecutionPhase::INIT);
+void JobBasedEventBroker::CollectSubscribers(
+    const std::string &topic, std::vector<TopicSubscriber> &subscribers) {
+  // these snapshots stay valid, even if listeners are modified meanwhile
+  std::vector<TopicSubscriberTrie::SharedSubscriberList> matches;
+  m_event_listeners.Match(topic, matches);
 
-  auto job_manager = m_subsystems.Borrow()->RequireSubsystem<JobManager>();
-  job_manager->KickJob(clean_up_job);
-}
+  // listeners of multiple matching patterns receive the event only once
+  bool requires_deduplication = matches.size() > 1;
+  std::vector<IEventListener *> collected_listeners;
 
-JobBasedEventBroker::~JobBasedEventBroker() {
-  if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
-    auto subsystems = maybe_subsystems.value();
-    auto job_manager = subsystems->RequireSubsystem<JobManager>();
-    job_manager->DetachJob("events-listener-clean-up");
+  bool has_expired_subscribers = false;
+  for (const auto &subscribers_of_pattern : matches) {
+    for (const auto &subscriber : *subscribers_of_pattern) {
+      if (subscriber.expired()) {
+        has_expired_subscribers = true;
+        continue;
+      }
+
+      if (requires_deduplication) {
+        auto *listener = subscriber.listener.lock().get();
+        if (std::find(collected_listeners.begin(), collected_listeners.end(),
+                      listener) != collected_listeners.end()) {
+          continue;
+        }
+        collected_listeners.push_back(listener);
+      }
+
+      subscribers.push_back(subscriber);
+    }
   }
 
-  RemoveAllListeners();
+  // expired listeners are pruned lazily instead of periodically
+  if (has_expired_subscribers) {
+    m_event_listeners.Prune(topic);
+  }
 }
 
-void JobBasedEventBroker::CleanUpSubscribers() {
-  std::unique_lock subscriber_lock(m_event_listeners_mutex);
-  for (auto &[topic, original_subscribers] : m_event_listeners) {
-    std::vector<std::weak_ptr<IEventListener>> new_subscribers;
-    for (auto &subscriber : original_subscribers) {
-      if (!subscriber.expired()) {
-        new_subscribers.push_back(subscriber);
+template <typename Handler>
+void JobBasedEventBroker::Dispatch(const std::string &topic,
+                                   std::vector<TopicSubscriber> &subscribers,
+                                   const Handler &handler,
+                                   JobManager &job_manager) {
+  std::vector<std::weak_ptr<IEventListener>> batched_listeners;
+
+  for (auto &subscriber : subscribers) {
+    switch (subscriber.mode) {
+    case DispatchMode::INLINE:
+      if (auto listener = subscriber.listener.lock()) {
+#ifndef NDEBUG
+        auto start = std::chrono::steady_clock::now();
+        handler(*listener);
+        auto duration = std::chrono::steady_clock::now() - start;
+        if (duration > c_inline_listener_budget) {
+          LOG_WARN("inline listener "
+                   << listener->GetId() << " of topic '" << topic << "' took "
+                   << std::chrono::duration_cast<std::chrono::microseconds>(
+                          duration)
+                          .count()
+                   << "us and probably blocked the firing thread. Register "
+                      "it using another dispatch mode.")
+        }
+#else
+        handler(*listener);
+#endif
       }
+      break;
+    case DispatchMode::BATCHED:
+      batched_listeners.push_back(std::move(subscriber.listener));
+      break;
+    case DispatchMode::JOB:
+    default: {
+      SharedJob event_job = std::make_shared<Job>(
+          [weak_listener = std::move(subscriber.listener),
+           handler](JobContext *) {
+            if (auto listener = weak_listener.lock()) {
+              handler(*listener);
+            }
+            return JobContinuation::DISPOSE;
+          },
+          "fire-event-" + topic);
+      event_job->SetCategory("events");
+      job_manager.KickJob(event_job);
+      break;
+    }
     }
+  }
 
-    original_subscribers.swap(new_subscribers);
+  if (!batched_listeners.empty()) {
+    // a single job notifies all batched listeners one after another
+    SharedJob batch_job = std::make_shared<Job>(
+        [batched_listeners = std::move(batched_listeners),
+         handler](JobContext *) {
+          for (const auto &weak_listener : batched_listeners) {
+            if (auto listener = weak_listener.lock()) {
+              handler(*listener);
+            }
+          }
+          return JobContinuation::DISPOSE;
+        },
+        "fire-event-batch-" + topic);
+    batch_job->SetCategory("events");
+    job_manager.KickJob(batch_job);
   }
 }
 
@@ -58,29 +159,30 @@ void JobBasedEventBroker::FireEvent(SharedEvent event) {
     auto subsystems = maybe_subsystems.value();
     const auto &topic_name = event->GetTopic();
 
-    std::unique_lock subscriber_lock(m_event_listeners_mutex);
-    if (m_event_listeners.contains(topic_name)) {
-      auto &subscribers_of_topic = m_event_listeners.at(topic_name);
-      for (auto &subscriber : subscribers_of_topic) {
-        if (!subscriber.expired()) {
-          SharedJob event_job = std::make_shared<Job>(
-              [subscriber, event](JobContext *) {
-                if (!subscriber.expired()) {
-                  subscriber.lock()->HandleEvent(event);
-                }
-                return JobContinuation::DISPOSE;
-              },
-              "fire-event-" + event->GetId());
-
-          auto job_manager = subsystems->RequireSubsystem<JobManager>();
-          job_manager->KickJob(event_job);
-        }
+    auto coalescers = m_coalescers.load();
+    if (!coalescers->empty()) {
+      auto coalescer = coalescers->find(topic_name);
+      if (coalescer != coalescers->end()) {
+        auto job_manager = subsystems->RequireSubsystem<JobManager>();
+        CoalesceEvent(coalescer->second, std::move(event), *job_manager);
+        return /* because the event is delivered as part of a batch */;
       }
+    }
 
-      LOG_DEBUG("event of topic '" << topic_name << "' published to "
-                                   << subscribers_of_topic.size()
-                                   << " subscribers")
+    std::vector<TopicSubscriber> subscribers;
+    CollectSubscribers(topic_name, subscribers);
+    if (subscribers.empty()) {
+      return /* because nobody is interested in this event */;
     }
+
+    auto job_manager = subsystems->RequireSubsystem<JobManager>();
+    Dispatch(
+        topic_name, subscribers,
+        [event](IEventListener &listener) { listener.HandleEvent(event); },
+        *job_manager);
+
+    LOG_DEBUG("event of topic '" << topic_name << "' published to "
+                                 << subscribers.size() << " subscribers")
   } else {
     LOG_ERR("cannot fire event of topic '"
             << event->GetTopic()
@@ -88,13 +190,81 @@ void JobBasedEventBroker::FireEvent(SharedEvent event) {
   }
 }
 
+void JobBasedEventBroker::CoalesceEvent(
+    const std::shared_ptr<EventCoalescer> &coalescer, SharedEvent event,
+    JobManager &job_manager) {
+  auto topic = event->GetTopic();
+
+  switch (coalescer->Add(std::move(event))) {
+  case EventCoalescer::PENDING:
+    break;
+  case EventCoalescer::FLUSH:
+    DeliverBatch(topic, coalescer->TakeBatch(), job_manager);
+    break;
+  case EventCoalescer::SCHEDULE_FLUSH: {
+    // when this shared pointer expired, this has been destroyed
+    std::weak_ptr<bool> alive_checker = m_this_alive_checker;
+
+    auto flush = [this, alive_checker, coalescer, topic](JobContext *context) {
+      if (!alive_checker.expired()) {
+        DeliverBatch(topic, coalescer->TakeScheduledBatch(),
+                     *context->GetJobManager());
+      }
+      return JobContinuation::DISPOSE;
+    };
+
+    const auto &window = coalescer->GetPolicy().window;
+    if (window.count() > 0) {
+      SharedJob flush_job =
+          std::make_shared<TimerJob>(flush, "flush-events-" + topic, window);
+      flush_job->SetCategory("events");
+      job_manager.KickJob(flush_job);
+    } else {
+      SharedJob flush_job =
+          std::make_shared<Job>(flush, "flush-events-" + topic);
+      flush_job->SetCategory("events");
+      job_manager.KickJobForNextCycle(flush_job);
+    }
+    break;
+  }
+  }
+}
+
+void JobBasedEventBroker::DeliverBatch(const std::string &topic,
+                                       std::vector<SharedEvent> batch,
+                                       JobManager &job_manager) {
+  if (batch.empty()) {
+    return /* because there is nothing to deliver */;
+  }
+
+  std::vector<TopicSubscriber> subscribers;
+  CollectSubscribers(topic, subscribers);
+  if (subscribers.empty()) {
+    return /* because nobody is interested in these events */;
+  }
+
+  // all listeners share the same batch
+  auto shared_batch =
+      std::make_shared<const std::vector<SharedEvent>>(std::move(batch));
+
+  Dispatch(
+      topic, subscribers,
+      [shared_batch](IEventListener &listener) {
+        listener.HandleEvents(*shared_batch);
+      },
+      job_manager);
+
+  LOG_DEBUG("batch of " << shared_batch->size() << " events of topic '"
+                        << topic << "' published to " << subscribers.size()
+                        << " subscribers")
+}
+
 bool JobBasedEventBroker::HasListener(const std::string &subscriber_id,
                                       const std::string &topic) const {
-  if (m_event_listeners.contains(topic)) {
-    const auto &subscriber_list = m_event_listeners.at(topic);
-    for (const auto &subscriber : subscriber_list) {
-      if (!subscriber.expired() &&
-          subscriber.lock()->GetId() == subscriber_id) {
+  if (auto subscriber_list = m_event_listeners.GetSubscribers(topic)) {
+    for (const auto &subscriber : *subscriber_list) {
+      auto listener = subscriber.listener.lock();
+      if (listener && listener->GetId() == subscriber_id) {
         return true;
       }
     }
@@ -104,44 +274,97 @@ bool JobBasedEventBroker::HasListener(const std::string &subscriber_id,
 }
 
 void JobBasedEventBroker::RegisterListener(
-    std::weak_ptr<IEventListener> listener, const std::string &topic) {
-  std::unique_lock subscriber_lock(m_event_listeners_mutex);
-  if (!HasListener(listener.lock()->GetId(), topic)) {
-    if (!m_event_listeners.contains(topic)) {
-      std::vector<std::weak_ptr<IEventListener>> vec;
-      m_event_listeners[topic] = vec;
-    }
-    m_event_listeners[topic].push_back(listener);
-  }
+    std::weak_ptr<IEventListener> listener, const std::string &topic,
+    DispatchMode mode) {
+  auto listener_id = listener.lock()->GetId();
+  m_event_listeners.Add(topic, TopicSubscriber{std::move(listener), mode},
+                        [&listener_id](const auto &subscriber) {
+                          auto existing_listener = subscriber.listener.lock();
+                          return existing_listener &&
+                                 existing_listener->GetId() == listener_id;
+                        });
 }
 
 void JobBasedEventBroker::UnregisterListener(
     std::weak_ptr<IEventListener> listener) {
-  for (const auto &[topic, listener_set] : m_event_listeners) {
-    RemoveListenerFromTopic(listener, topic);
-  }
+  auto listener_id = listener.lock()->GetId();
+  m_event_listeners.RemoveFromAll([&listener_id](const auto &subscriber) {
+    auto existing_listener = subscriber.listener.lock();
+    return existing_listener && existing_listener->GetId() == listener_id;
+  });
 }
 
 void JobBasedEventBroker::RemoveListenerFromTopic(
     std::weak_ptr<IEventListener> subscriber, const std::string &topic) {
-  std::unique_lock subscriber_lock(m_event_listeners_mutex);
-  if (m_event_listeners.contains(topic)) {
-    auto &subscriber_list = m_event_listeners.at(topic);
-    for (auto subscriber_iter = subscriber_list.begin();
-         subscriber_iter != subscriber_list.end(); subscriber_iter++) {
-      // always check if listener is still valid
-      if ((*subscriber_iter).expired()) {
-        subscriber_list.erase(subscriber_iter);
-      } else if ((*subscriber_iter).lock()->GetId() ==
-                 subscriber.lock()->GetId()) {
-        subscriber_list.erase(subscriber_iter);
-        break;
-      }
-    }
-  }
+  auto listener_id = subscriber.lock()->GetId();
+  m_event_listeners.Remove(topic, [&listener_id](const auto &subscriber) {
+    auto existing_listener = subscriber.listener.lock();
+    return existing_listener && existing_listener->GetId() == listener_id;
+  });
 }
 
 void JobBasedEventBroker::RemoveAllListeners() {
-  std::unique_lock subscriber_lock(m_event_listeners_mutex);
-  m_event_listeners.clear();
-}
\ No newline at end of file
+  m_event_listeners.Clear();
+  m_typed_event_listeners.Clear();
+}
+
+void JobBasedEventBroker::SetCoalescingPolicy(const std::string &topic,
+                                              EventCoalescingPolicy policy) {
+  std::unique_lock lock(m_coalescers_mutex);
+  auto coalescers = std::make_shared<CoalescerMap>(*m_coalescers.load());
+  (*coalescers)[topic] = std::make_shared<EventCoalescer>(std::move(policy));
+  m_coalescers.store(std::move(coalescers));
+}
+
+void JobBasedEventBroker::RemoveCoalescingPolicy(const std::string &topic) {
+  std::unique_lock lock(m_coalescers_mutex);
+  auto coalescers = std::make_shared<CoalescerMap>(*m_coalescers.load());
+  coalescers->erase(topic);
+  m_coalescers.store(std::move(coalescers));
+}
+
+void JobBasedEventBroker::FireTypedEvent(TypedEvent event) {
+  auto subscribers = m_typed_event_listeners.GetSubscribers(event.GetType());
+  if (!subscribers) {
+    return /* because nobody is interested in this event */;
+  }
+
+  // expired listeners are pruned lazily instead of periodically
+  bool has_expired_subscribers =
+      std::any_of(subscribers->begin(), subscribers->end(),
+                  [](const auto &subscriber) { return subscriber.expired(); });
+  if (has_expired_subscribers) {
+    m_typed_event_listeners.Prune(event.GetType());
+  }
+
+  if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
+    auto subsystems = maybe_subsystems.value();
+    auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+    // one job delivers the event to all subscribers of its type
+    job_manager->KickJob(std::make_shared<TypedEventJob>(
+        std::move(event), std::move(subscribers)));
+  } else {
+    LOG_ERR("cannot fire typed event because required subsystems are not "
+            "available")
+  }
+}
+
+void JobBasedEventBroker::RegisterTypedListener(
+    std::weak_ptr<ITypedEventListenerBase> listener, EventTypeId type) {
+  // typed listeners are identified by their instance
+  auto shared_listener = listener.lock();
+  m_typed_event_listeners.Add(type, std::move(listener),
+                              [&shared_listener](const auto &subscriber) {
+                                return subscriber.lock() == shared_listener;
+                              });
+}
+
+void JobBasedEventBroker::RemoveTypedListener(
+    const std::weak_ptr<ITypedEventListenerBase> &listener, EventTypeId type) {
+  auto shared_listener = listener.lock();
+  m_typed_event_listeners.Remove(type,
+                                 [&shared_listener](const auto &subscriber) {
+                                   return subscriber.lock() == shared_listener;
+                                 });
+}
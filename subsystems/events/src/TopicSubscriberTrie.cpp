@@ -0,0 +1,245 @@
+#include "events/broker/impl/TopicSubscriberTrie.h"
+#include <algorithm>
+
+using namespace hive::events;
+using namespace hive::events::brokers;
+
+/**
+ * Iterates the segments of a topic without copying them.
+ * @param topic topic or pattern
+ * @param consumer function called for each segment
+ */
+template <typename Consumer>
+static void ForEachSegment(std::string_view topic, const Consumer &consumer) {
+  size_t begin = 0;
+  while (true) {
+    size_t end = topic.find(TopicSubscriberTrie::c_segment_separator, begin);
+    if (end == std::string_view::npos) {
+      consumer(topic.substr(begin));
+      return;
+    }
+    consumer(topic.substr(begin, end - begin));
+    begin = end + 1;
+  }
+}
+
+TopicSubscriberTrie::TopicSubscriberTrie()
+    : m_root{std::make_shared<Node>()},
+      m_segment_ids{std::make_shared<const SegmentMap>()} {}
+
+bool TopicSubscriberTrie::IsPattern(std::string_view pattern) {
+  bool contains_wildcard = false;
+  ForEachSegment(pattern, [&contains_wildcard](std::string_view segment) {
+    if (segment == c_single_wildcard || segment == c_multi_wildcard) {
+      contains_wildcard = true;
+    }
+  });
+  return contains_wildcard;
+}
+
+TopicSubscriberTrie::SegmentId
+TopicSubscriberTrie::GetSegmentId(const SegmentMap &segments,
+                                  std::string_view segment) {
+  auto iterator = segments.find(segment);
+  if (iterator == segments.end()) {
+    return c_unknown_segment_id;
+  }
+  return iterator->second;
+}
+
+TopicSubscriberTrie::SegmentId
+TopicSubscriberTrie::InternSegment(std::string_view segment) {
+  if (segment == c_single_wildcard) {
+    return c_single_wildcard_id;
+  } else if (segment == c_multi_wildcard) {
+    return c_multi_wildcard_id;
+  }
+
+  auto segments = m_segment_ids.load();
+  auto segment_id = GetSegmentId(*segments, segment);
+  if (segment_id != c_unknown_segment_id) {
+    return segment_id;
+  }
+
+  // new segments are rare, so copying the map is acceptable
+  const auto &stored_segment = m_segment_storage.emplace_back(segment);
+  auto new_segments = std::make_shared<SegmentMap>(*segments);
+  segment_id = m_next_segment_id++;
+  new_segments->emplace(stored_segment, segment_id);
+  m_segment_ids.store(std::move(new_segments));
+  return segment_id;
+}
+
+std::shared_ptr<TopicSubscriberTrie::Node>
+TopicSubscriberTrie::GetOrCreateChild(Node &node, SegmentId segment_id) {
+  auto children = node.children.load();
+  if (children) {
+    auto iterator = children->find(segment_id);
+    if (iterator != children->end()) {
+      return iterator->second;
+    }
+  }
+
+  auto child = std::make_shared<Node>();
+  child->is_multi_wildcard = segment_id == c_multi_wildcard_id;
+
+  auto new_children =
+      children ? std::make_shared<ChildMap>(*children)
+               : std::make_shared<ChildMap>();
+  new_children->emplace(segment_id, child);
+  node.children.store(std::move(new_children));
+  return child;
+}
+
+std::shared_ptr<TopicSubscriberTrie::Node>
+TopicSubscriberTrie::GetOrCreateNode(std::string_view pattern) {
+  auto node = m_root.load();
+  ForEachSegment(pattern, [this, &node](std::string_view segment) {
+    node = GetOrCreateChild(*node, InternSegment(segment));
+  });
+  return node;
+}
+
+std::shared_ptr<TopicSubscriberTrie::Node>
+TopicSubscriberTrie::FindNode(std::string_view pattern) const {
+  auto node = m_root.load();
+  auto segments = m_segment_ids.load();
+
+  ForEachSegment(pattern, [&node, &segments](std::string_view segment) {
+    if (!node) {
+      return;
+    }
+
+    SegmentId segment_id;
+    if (segment == c_single_wildcard) {
+      segment_id = c_single_wildcard_id;
+    } else if (segment == c_multi_wildcard) {
+      segment_id = c_multi_wildcard_id;
+    } else {
+      segment_id = GetSegmentId(*segments, segment);
+    }
+
+    auto children = node->children.load();
+    if (!children) {
+      node = nullptr;
+      return;
+    }
+
+    auto child = children->find(segment_id);
+    node = child != children->end() ? child->second : nullptr;
+  });
+
+  return node;
+}
+
+/**
+ * Adds a node and all nodes reachable from it without consuming a segment
+ * (using '**' which also matches no segments at all).
+ */
+template <typename NodeType>
+static void AddWithClosure(NodeType *node, std::vector<NodeType *> &nodes,
+                           uint32_t multi_wildcard_id) {
+  while (node) {
+    if (std::find(nodes.begin(), nodes.end(), node) != nodes.end()) {
+      return /* because it has already been added */;
+    }
+    nodes.push_back(node);
+
+    auto children = node->children.load();
+    if (!children) {
+      return;
+    }
+
+    auto iterator = children->find(multi_wildcard_id);
+    node = iterator != children->end() ? iterator->second.get() : nullptr;
+  }
+}
+
+void TopicSubscriberTrie::FindMatchingNodes(
+    std::string_view topic, Node *root, std::vector<Node *> &matches) const {
+  auto segments = m_segment_ids.load();
+
+  /*
+   * Walk the trie like a non-deterministic automaton: All nodes whose
+   * patterns match the consumed segments so far are active. Each segment
+   * moves all active nodes forward to their children matching the segment
+   * exactly or using a wildcard. Nodes reached by '**' stay active because
+   * they can consume any number of segments.
+   */
+  std::vector<Node *> active_nodes, next_active_nodes;
+  AddWithClosure(root, active_nodes, c_multi_wildcard_id);
+
+  ForEachSegment(topic, [&](std::string_view segment) {
+    SegmentId segment_id = GetSegmentId(*segments, segment);
+
+    next_active_nodes.clear();
+    for (Node *node : active_nodes) {
+      if (node->is_multi_wildcard) {
+        AddWithClosure(node, next_active_nodes, c_multi_wildcard_id);
+      }
+
+      auto children = node->children.load();
+      if (!children) {
+        continue;
+      }
+
+      if (segment_id != c_unknown_segment_id) {
+        auto exact_child = children->find(segment_id);
+        if (exact_child != children->end()) {
+          AddWithClosure(exact_child->second.get(), next_active_nodes,
+                         c_multi_wildcard_id);
+        }
+      }
+
+      auto wildcard_child = children->find(c_single_wildcard_id);
+      if (wildcard_child != children->end()) {
+        AddWithClosure(wildcard_child->second.get(), next_active_nodes,
+                       c_multi_wildcard_id);
+      }
+    }
+
+    active_nodes.swap(next_active_nodes);
+  });
+
+  matches.insert(matches.end(), active_nodes.begin(), active_nodes.end());
+}
+
+void TopicSubscriberTrie::Match(
+    std::string_view topic, std::vector<SharedSubscriberList> &matches) const {
+  // nodes are kept alive by the root
+  auto root = m_root.load();
+
+  std::vector<Node *> nodes;
+  FindMatchingNodes(topic, root.get(), nodes);
+
+  for (Node *node : nodes) {
+    if (auto subscribers = node->subscribers.Get()) {
+      matches.push_back(std::move(subscribers));
+    }
+  }
+}
+
+TopicSubscriberTrie::SharedSubscriberList
+TopicSubscriberTrie::GetSubscribers(std::string_view pattern) const {
+  auto node = FindNode(pattern);
+  return node ? node->subscribers.Get() : nullptr;
+}
+
+void TopicSubscriberTrie::Prune(std::string_view topic) {
+  std::unique_lock lock(m_write_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return /* because the next reader can try again */;
+  }
+
+  auto root = m_root.load();
+  std::vector<Node *> nodes;
+  FindMatchingNodes(topic, root.get(), nodes);
+  for (Node *node : nodes) {
+    node->subscribers.Prune();
+  }
+}
+
+void TopicSubscriberTrie::Clear() {
+  std::unique_lock lock(m_write_mutex);
+  m_root.store(std::make_shared<Node>());
+}
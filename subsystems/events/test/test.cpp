@@ -1,12 +1,16 @@
 #include "common/memory/ExclusiveOwnership.h"
 #include "events/broker/IEventBroker.h"
 #include "events/broker/impl/JobBasedEventBroker.h"
+#include "events/broker/impl/TopicSubscriberTrie.h"
 #include "events/listener/impl/FunctionalEventListener.h"
+#include "events/listener/impl/TypedFunctionalEventListener.h"
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace hive::events;
 using namespace hive::jobsystem;
 using namespace hive;
+using namespace std::chrono_literals;
 
 common::memory::Owner<common::subsystems::SubsystemManager> SetupSubsystems() {
   auto subsystems =
@@ -115,6 +119,330 @@ TEST(Messaging, subscriber_destroyed) {
   ASSERT_EQ(event_received_counter_b, 1);
 }
 
+TEST(Messaging, register_listeners_while_firing) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  std::atomic_int event_received_counter = 0;
+  auto subscriber = std::make_shared<events::FunctionalEventListener>(
+      [&](SharedEvent event) { event_received_counter++; });
+  broker->RegisterListener(subscriber, "test-event");
+
+  // listeners come and go (or expire) while events are being fired
+  std::atomic_bool running = true;
+  std::thread churn([&]() {
+    while (running) {
+      auto temporary = std::make_shared<events::FunctionalEventListener>(
+          [](SharedEvent) {});
+      broker->RegisterListener(temporary, "test-event");
+      broker->RemoveListenerFromTopic(temporary, "test-event");
+      broker->RegisterListener(temporary, "test-event");
+    }
+  });
+
+  int fire_count = 1000;
+  auto evt = std::make_shared<events::Event>("test-event");
+  for (int i = 0; i < fire_count; i++) {
+    broker->FireEvent(evt);
+  }
+
+  running = false;
+  churn.join();
+
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(fire_count, event_received_counter);
+  ASSERT_TRUE(broker->HasListener(subscriber->GetId(), "test-event"));
+}
+
+TEST(Messaging, topic_trie_matches_wildcards) {
+  events::brokers::TopicSubscriberTrie trie;
+  auto listener = std::make_shared<events::FunctionalEventListener>(
+      [](SharedEvent) {});
+
+  auto never_equal = [](const auto &) { return false; };
+  std::vector<std::string> patterns = {"net.connection.closed",
+                                       "net.*.closed",
+                                       "net.**",
+                                       "**.closed",
+                                       "net.connection.*.state",
+                                       "service"};
+  for (const auto &pattern : patterns) {
+    trie.Add(pattern, {listener}, never_equal);
+  }
+
+  auto count_matches = [&trie](const std::string &topic) {
+    std::vector<events::brokers::TopicSubscriberTrie::SharedSubscriberList>
+        matches;
+    trie.Match(topic, matches);
+    return matches.size();
+  };
+
+  ASSERT_EQ(4, count_matches("net.connection.closed"));
+  ASSERT_EQ(3, count_matches("net.peer.closed"));
+  ASSERT_EQ(1, count_matches("net"));
+  ASSERT_EQ(2, count_matches("net.connection.a.state"));
+  ASSERT_EQ(1, count_matches("closed"));
+  ASSERT_EQ(1, count_matches("service"));
+  ASSERT_EQ(0, count_matches("service.registered"));
+  ASSERT_EQ(0, count_matches("unknown"));
+
+  ASSERT_TRUE(events::brokers::TopicSubscriberTrie::IsPattern("net.**"));
+  ASSERT_FALSE(events::brokers::TopicSubscriberTrie::IsPattern("net.a*"));
+}
+
+TEST(Messaging, receive_events_of_wildcard_topics) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  std::atomic_int connection_events = 0;
+  std::atomic_int closed_events = 0;
+
+  auto connection_listener = std::make_shared<events::FunctionalEventListener>(
+      [&](SharedEvent event) { connection_events++; });
+  auto closed_listener = std::make_shared<events::FunctionalEventListener>(
+      [&](SharedEvent event) { closed_events++; });
+
+  broker->RegisterListener(connection_listener, "net.connection.*");
+  broker->RegisterListener(closed_listener, "**.closed");
+  broker->RegisterListener(closed_listener, "net.connection.closed");
+
+  broker->FireEvent(std::make_shared<Event>("net.connection.closed"));
+  broker->FireEvent(std::make_shared<Event>("net.connection.established"));
+  broker->FireEvent(std::make_shared<Event>("net.peer.closed"));
+  job_manager->InvokeCycleAndWait();
+
+  // listeners of several matching patterns are only notified once
+  ASSERT_EQ(2, connection_events);
+  ASSERT_EQ(2, closed_events);
+  ASSERT_TRUE(broker->HasListener(closed_listener->GetId(), "**.closed"));
+
+  broker->RemoveListenerFromTopic(connection_listener, "net.connection.*");
+  broker->FireEvent(std::make_shared<Event>("net.connection.established"));
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(2, connection_events);
+}
+
+struct TestTypedEvent {
+  int value;
+};
+
+struct OtherTestTypedEvent {
+  std::string text;
+};
+
+TEST(Messaging, receive_typed_event) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  std::atomic_int received_sum = 0;
+  std::atomic_int other_received_counter = 0;
+
+  auto subscriber_a =
+      std::make_shared<TypedFunctionalEventListener<TestTypedEvent>>(
+          [&](const TestTypedEvent &event) { received_sum += event.value; });
+  auto subscriber_b =
+      std::make_shared<TypedFunctionalEventListener<OtherTestTypedEvent>>(
+          [&](const OtherTestTypedEvent &event) {
+            ASSERT_EQ("hello", event.text);
+            other_received_counter++;
+          });
+
+  broker->RegisterListener(subscriber_a);
+  broker->RegisterListener(subscriber_a);
+  broker->RegisterListener(subscriber_b);
+
+  broker->FireEvent(TestTypedEvent{3});
+  broker->FireEvent(TestTypedEvent{4});
+  broker->FireEvent(OtherTestTypedEvent{"hello"});
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(7, received_sum);
+  ASSERT_EQ(1, other_received_counter);
+
+  // string topics are still delivered separately
+  broker->FireEvent(std::make_shared<events::Event>("test-event"));
+
+  broker->RemoveListener(subscriber_a);
+  broker->FireEvent(TestTypedEvent{5});
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(7, received_sum);
+}
+
+TEST(Messaging, typed_event_storage) {
+  struct LargeEvent {
+    char data[TypedEvent::c_inline_capacity * 2];
+    std::shared_ptr<int> resource;
+  };
+
+  auto resource = std::make_shared<int>(42);
+  {
+    TypedEvent small_event(TestTypedEvent{1});
+    TypedEvent large_event(LargeEvent{{}, resource});
+    ASSERT_EQ(2, resource.use_count());
+
+    ASSERT_TRUE(small_event.Is<TestTypedEvent>());
+    ASSERT_FALSE(small_event.Is<LargeEvent>());
+    ASSERT_EQ(1, small_event.Get<TestTypedEvent>().value);
+
+    TypedEvent moved_event(std::move(large_event));
+    ASSERT_FALSE(large_event.Is<LargeEvent>());
+    ASSERT_TRUE(moved_event.Is<LargeEvent>());
+    ASSERT_EQ(42, *moved_event.Get<LargeEvent>().resource);
+    ASSERT_EQ(2, resource.use_count());
+  }
+
+  // stored events are destroyed with their holder
+  ASSERT_EQ(1, resource.use_count());
+}
+
+TEST(Messaging, dispatch_modes) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  std::thread::id inline_thread;
+  std::atomic_int inline_counter = 0;
+  std::atomic_int job_counter = 0;
+  std::atomic_int batched_counter = 0;
+
+  auto inline_listener = std::make_shared<events::FunctionalEventListener>(
+      [&](SharedEvent event) {
+        inline_thread = std::this_thread::get_id();
+        inline_counter++;
+      });
+  auto job_listener = std::make_shared<events::FunctionalEventListener>(
+      [&](SharedEvent event) { job_counter++; });
+
+  std::vector<std::shared_ptr<events::FunctionalEventListener>>
+      batched_listeners;
+  for (int i = 0; i < 3; i++) {
+    batched_listeners.push_back(
+        std::make_shared<events::FunctionalEventListener>(
+            [&](SharedEvent event) { batched_counter++; }));
+    broker->RegisterListener(batched_listeners.back(), "test-event",
+                             DispatchMode::BATCHED);
+  }
+
+  broker->RegisterListener(inline_listener, "test-event",
+                           DispatchMode::INLINE);
+  broker->RegisterListener(job_listener, "test-event");
+
+  broker->FireEvent(std::make_shared<events::Event>("test-event"));
+
+  // inline listeners have been called by the firing thread right away
+  ASSERT_EQ(1, inline_counter);
+  ASSERT_EQ(std::this_thread::get_id(), inline_thread);
+
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(1, inline_counter);
+  ASSERT_EQ(1, job_counter);
+  ASSERT_EQ(3, batched_counter);
+}
+
+/** Records the batches of events it receives */
+class BatchRecordingListener : public IEventListener {
+public:
+  jobsystem::mutex mutex;
+  std::vector<std::vector<SharedEvent>> batches;
+
+  void HandleEvent(SharedEvent event) override {
+    HandleEvents(std::span<const SharedEvent>(&event, 1));
+  }
+
+  void HandleEvents(std::span<const SharedEvent> events) override {
+    std::unique_lock lock(mutex);
+    batches.emplace_back(events.begin(), events.end());
+  }
+
+  std::string GetId() const override { return "batch-recording-listener"; }
+};
+
+TEST(Messaging, coalesce_events_latest_per_key) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  auto listener = std::make_shared<BatchRecordingListener>();
+  broker->RegisterListener(listener, "connection-state");
+
+  EventCoalescingPolicy policy;
+  policy.key = [](const SharedEvent &event) {
+    return event->GetPayload<std::string>("connection").value();
+  };
+  broker->SetCoalescingPolicy("connection-state", policy);
+
+  auto fire = [&broker](const std::string &connection, int state) {
+    auto event = std::make_shared<Event>("connection-state");
+    event->SetPayload<std::string>("connection", connection);
+    event->SetPayload<int>("state", state);
+    broker->FireEvent(event);
+  };
+
+  fire("a", 1);
+  fire("b", 1);
+  fire("a", 2);
+  fire("a", 3);
+  fire("b", 2);
+
+  for (int i = 0; i < 3; i++) {
+    job_manager->InvokeCycleAndWait();
+  }
+
+  ASSERT_EQ(1, listener->batches.size());
+  auto &batch = listener->batches.front();
+  ASSERT_EQ(2, batch.size());
+  ASSERT_EQ("a", batch[0]->GetPayload<std::string>("connection").value());
+  ASSERT_EQ(3, batch[0]->GetPayload<int>("state").value());
+  ASSERT_EQ("b", batch[1]->GetPayload<std::string>("connection").value());
+  ASSERT_EQ(2, batch[1]->GetPayload<int>("state").value());
+
+  // events are delivered separately after the policy has been removed
+  broker->RemoveCoalescingPolicy("connection-state");
+  fire("a", 4);
+  fire("a", 5);
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(3, listener->batches.size());
+}
+
+TEST(Messaging, coalesce_events_in_batches) {
+  auto subsystems = SetupSubsystems();
+  auto broker = common::memory::Owner<events::brokers::JobBasedEventBroker>(
+      subsystems.CreateReference());
+  auto job_manager = subsystems->RequireSubsystem<JobManager>();
+
+  auto listener = std::make_shared<BatchRecordingListener>();
+  broker->RegisterListener(listener, "service-registered");
+
+  EventCoalescingPolicy policy;
+  policy.max_batch_size = 3;
+  policy.window = 100ms;
+  broker->SetCoalescingPolicy("service-registered", policy);
+
+  for (int i = 0; i < 7; i++) {
+    broker->FireEvent(std::make_shared<Event>("service-registered"));
+  }
+
+  // full batches are delivered right away, the rest after the window
+  job_manager->InvokeCycleAndWait();
+  ASSERT_EQ(2, listener->batches.size());
+  ASSERT_EQ(3, listener->batches[0].size());
+  ASSERT_EQ(3, listener->batches[1].size());
+
+  std::this_thread::sleep_for(150ms);
+  for (int i = 0; i < 2; i++) {
+    job_manager->InvokeCycleAndWait();
+  }
+  ASSERT_EQ(3, listener->batches.size());
+  ASSERT_EQ(1, listener->batches[2].size());
+}
+
 int main(int argc, char **argv) {
 
   ::testing::InitGoogleTest(&argc, argv);
@@ -3,6 +3,7 @@
 #include "common/config/Configuration.h"
 #include "common/memory/ExclusiveOwnership.h"
 #include "jobsystem/execution/IJobExecution.h"
+#include "jobsystem/profiling/CycleTracer.h"
 #include <future>
 #include <memory>
 #include <thread>
@@ -131,11 +132,25 @@ template <typename FutureType>
 void BoostFiberExecution::WaitForCompletion(
     const std::future<FutureType> &future) {
   if (IsExecutedByFiber()) {
+    if (future.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      return;
+    }
+
+    auto trace = profiling::CycleTracer::GetCurrentTrace();
+    auto wait_begin = trace ? std::chrono::steady_clock::now()
+                            : std::chrono::steady_clock::time_point();
+
     // caller is a fiber, so yield
     while (future.wait_for(std::chrono::seconds(0)) !=
            std::future_status::ready) {
       boost::this_fiber::yield();
     }
+
+    if (trace) {
+      trace->waits.push_back(
+          {wait_begin, std::chrono::steady_clock::now(), {}});
+    }
   } else {
     // caller is a thread, so block
     future.wait();
@@ -146,11 +161,25 @@ template <typename FutureType>
 void BoostFiberExecution::WaitForCompletion(
     const std::shared_future<FutureType> &future) {
   if (IsExecutedByFiber()) {
+    if (future.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+      return;
+    }
+
+    auto trace = profiling::CycleTracer::GetCurrentTrace();
+    auto wait_begin = trace ? std::chrono::steady_clock::now()
+                            : std::chrono::steady_clock::time_point();
+
     // caller is a fiber, so yield
     while (future.wait_for(std::chrono::seconds(0)) !=
            std::future_status::ready) {
       boost::this_fiber::yield();
     }
+
+    if (trace) {
+      trace->waits.push_back(
+          {wait_begin, std::chrono::steady_clock::now(), {}});
+    }
   } else {
     // caller is a thread, so block
     future.wait();
@@ -161,7 +190,16 @@ template <typename Rep, typename Period>
 void BoostFiberExecution::WaitForDuration(
     std::chrono::duration<Rep, Period> duration) {
   if (IsExecutedByFiber()) {
+    auto trace = profiling::CycleTracer::GetCurrentTrace();
+    auto wait_begin = trace ? std::chrono::steady_clock::now()
+                            : std::chrono::steady_clock::time_point();
+
     boost::this_fiber::sleep_for(duration);
+
+    if (trace) {
+      trace->waits.push_back(
+          {wait_begin, std::chrono::steady_clock::now(), {}});
+    }
   } else {
     std::this_thread::sleep_for(duration);
   }
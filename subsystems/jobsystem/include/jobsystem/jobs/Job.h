@@ -4,12 +4,16 @@
 #include "jobsystem/JobExecutionPhase.h"
 #include "jobsystem/JobExitBehavior.h"
 #include "jobsystem/JobState.h"
+#include "jobsystem/profiling/JobTrace.h"
 #include "jobsystem/synchronization/JobCounter.h"
 #include "jobsystem/synchronization/JobMutex.h"
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <string>
+#include <thread>
 
 namespace hive::jobsystem {
 
@@ -30,7 +34,28 @@ protected:
   std::function<JobContinuation(JobContext *)> m_workload;
 
   /** Tracks progress and current state of this job. */
-  JobState m_current_state{DETACHED};
+  std::atomic<JobState> m_current_state{DETACHED};
+
+  /**
+   * Point in time at which the last execution of this job started. This is
+   * used to track down jobs that stall the execution cycle.
+   */
+  std::atomic<std::chrono::steady_clock::time_point> m_execution_start;
+
+  /** Worker thread that started the last execution of this job. */
+  std::atomic<std::thread::id> m_worker;
+
+  /**
+   * Records the timings of the upcoming or current execution for the critical
+   * path analysis. This is only set if the analysis has been enabled.
+   */
+  profiling::SharedJobTrace m_trace;
+
+  /**
+   * Category used to limit the concurrency and rate of related jobs (e.g. all
+   * jobs of a subsystem). Uncategorized jobs (empty) are not limited.
+   */
+  std::string m_category;
 
   /** Workload will be executed in the given phase of the execution cycle. */
   JobExecutionPhase m_phase;
@@ -114,6 +139,20 @@ public:
    */
   const std::string &GetId();
 
+  /**
+   * Get the category of this job.
+   * @return category of this job or an empty string, if uncategorized.
+   */
+  const std::string &GetCategory() const;
+
+  /**
+   * Assigns this job to a category. The job manager enforces the limits of
+   * the category (see JobCategoryLimits) when scheduling the job.
+   * @param category name of the category
+   * @attention This must not be changed after the job has been kicked.
+   */
+  void SetCategory(std::string category);
+
   /**
    * if a job is synchronized with the cycle, the cycle will wait for the job to
    * finish. Asynchronous jobs can finish anytime in the future and are not
@@ -121,6 +160,27 @@ public:
    * @return true, if job is asynchronous.
    */
   bool IsAsync() const;
+
+  /**
+   * Get the point in time at which the last execution of this job has
+   * started.
+   * @return start of the last execution
+   */
+  std::chrono::steady_clock::time_point GetExecutionStartTime() const;
+
+  /**
+   * Get the worker thread that started the last execution of this job.
+   * @return id of the worker thread
+   * @note Fibers can migrate between worker threads when they yield.
+   */
+  std::thread::id GetWorkerThreadId() const;
+
+  /**
+   * Attaches a trace to the upcoming execution of this job which will record
+   * its timings.
+   * @param trace trace of the upcoming execution or nullptr
+   */
+  void SetTrace(profiling::SharedJobTrace trace);
 };
 
 inline JobState Job::GetState() { return m_current_state; }
@@ -128,8 +188,24 @@ inline void Job::SetState(JobState state) { m_current_state = state; }
 inline JobExecutionPhase Job::GetPhase() { return m_phase; }
 inline const std::string &Job::GetId() { return m_id; }
 
+inline const std::string &Job::GetCategory() const { return m_category; }
+inline void Job::SetCategory(std::string category) {
+  m_category = std::move(category);
+}
+
 inline bool Job::IsAsync() const { return m_async; }
 
+inline std::chrono::steady_clock::time_point
+Job::GetExecutionStartTime() const {
+  return m_execution_start;
+}
+
+inline std::thread::id Job::GetWorkerThreadId() const { return m_worker; }
+
+inline void Job::SetTrace(profiling::SharedJobTrace trace) {
+  m_trace = std::move(trace);
+}
+
 typedef std::shared_ptr<Job> SharedJob;
 
 } // namespace hive::jobsystem
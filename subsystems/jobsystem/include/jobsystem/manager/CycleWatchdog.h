@@ -0,0 +1,109 @@
+#pragma once
+
+#include "jobsystem/jobs/Job.h"
+#include "jobsystem/manager/StallReport.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace hive::jobsystem {
+
+/**
+ * Observes the phases of the execution cycle from a separate thread and
+ * reports phases that exceed a configured time budget. A stall report lists
+ * all jobs the phase is still waiting for, including how long they have been
+ * running and which worker picked them up.
+ * @note Each stalling phase is reported only once.
+ * @note The watchdog runs on a plain thread and not inside the job system
+ * because a stalled job system could not execute it anymore.
+ */
+class CycleWatchdog {
+private:
+  const std::chrono::milliseconds m_phase_budget;
+  const std::chrono::milliseconds m_check_interval;
+
+  /** progress of the currently observed phase */
+  size_t m_cycle{0};
+  JobManagerState m_phase{READY};
+  std::chrono::steady_clock::time_point m_phase_start;
+  bool m_phase_reported{false};
+
+  /** all synchronous jobs that have been scheduled in the current phase */
+  std::vector<SharedJob> m_phase_jobs;
+  mutable mutex m_phase_mutex;
+
+  std::function<void(const StallReport &)> m_stall_handler;
+  std::optional<StallReport> m_last_report;
+  mutable mutex m_report_mutex;
+
+  std::atomic_bool m_running{true};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_sleep_condition;
+  std::thread m_thread;
+
+  /**
+   * Periodically checks the current phase until the watchdog is destroyed.
+   * @note This is run by the watchdog thread.
+   */
+  void Run();
+
+public:
+  /**
+   * Creates the watchdog and starts observing.
+   * @param phase_budget maximum duration a single phase may take before it is
+   * considered stalled.
+   * @param check_interval interval in which the current phase is checked.
+   */
+  CycleWatchdog(std::chrono::milliseconds phase_budget,
+                std::chrono::milliseconds check_interval);
+  ~CycleWatchdog();
+  CycleWatchdog(CycleWatchdog &other) = delete;
+
+  /**
+   * Notifies the watchdog that a new phase has been started. This resets the
+   * phase timer and forgets the jobs of the previous phase.
+   * @param cycle number of the current cycle
+   * @param phase phase that has been started
+   */
+  void OnPhaseStarted(size_t cycle, JobManagerState phase);
+
+  /**
+   * Notifies the watchdog that a synchronous job has been passed to the
+   * execution in the current phase.
+   * @param job job the current phase will wait for
+   */
+  void OnJobScheduled(const SharedJob &job);
+
+  /**
+   * Notifies the watchdog that the cycle has been completed and there is no
+   * phase to observe anymore.
+   */
+  void OnCycleFinished();
+
+  /**
+   * Checks if the current phase exceeded its budget and reports the stall if
+   * it has not been reported yet.
+   * @return stall report, if a new stall has been detected
+   */
+  std::optional<StallReport> Check();
+
+  /**
+   * Set a handler that is called (on the watchdog thread) with every new stall
+   * report, e.g. to export it.
+   * @param handler handler receiving stall reports
+   */
+  void SetStallHandler(std::function<void(const StallReport &)> handler);
+
+  /**
+   * Get the most recent stall report.
+   * @return last stall report, if any stall has been detected yet
+   */
+  std::optional<StallReport> GetLastStallReport() const;
+};
+
+} // namespace hive::jobsystem
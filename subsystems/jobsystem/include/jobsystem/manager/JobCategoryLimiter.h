@@ -0,0 +1,135 @@
+#pragma once
+
+#include "common/config/Configuration.h"
+#include "jobsystem/jobs/Job.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <chrono>
+#include <map>
+#include <queue>
+#include <string>
+
+namespace hive::jobsystem {
+
+/**
+ * Limits applied to all jobs of the same category.
+ */
+struct JobCategoryLimits {
+  /** maximum count of jobs of this category running at the same time (0 =
+   * unlimited) */
+  size_t max_concurrency{0};
+
+  /** maximum count of jobs of this category started per second (0 =
+   * unlimited) */
+  double rate{0};
+
+  /** count of jobs that can be started at once before the rate applies. If
+   * this is 0, the burst equals the rate (but at least 1). */
+  double burst{0};
+};
+
+/**
+ * Contains noisy subsystems by enforcing the limits of job categories when
+ * jobs are scheduled. Jobs that exceed a limit are not dropped:
+ * - Jobs exceeding the rate of their category (token bucket) are deferred to
+ * upcoming cycles.
+ * - Jobs exceeding the concurrency of their category are held back until a
+ * running job of the same category has been executed. Asynchronous jobs do not
+ * take part in this limit, because the cycle cannot wait for them.
+ * @note Limits are either set explicitly or loaded from the configuration
+ * ('jobs.categories.<name>.max-concurrency', 'jobs.categories.<name>.rate' and
+ * 'jobs.categories.<name>.burst') when a category is used for the first time.
+ */
+class JobCategoryLimiter {
+private:
+  struct Category {
+    JobCategoryLimits limits;
+
+    /** count of jobs of this category that are currently scheduled or
+     * running */
+    size_t running{0};
+
+    /** jobs waiting for a free slot, in the order they have been held back */
+    std::queue<SharedJob> held_jobs;
+
+    /** currently available tokens of the bucket */
+    double tokens{0};
+    std::chrono::steady_clock::time_point last_refill;
+  };
+
+  common::config::SharedConfiguration m_config;
+
+  std::map<std::string, Category> m_categories;
+  mutable mutex m_categories_mutex;
+
+  /**
+   * Get the category with the given name or create it with limits loaded from
+   * the configuration.
+   * @param name name of the category
+   * @return category
+   * @note The categories mutex must be acquired by the caller.
+   */
+  Category &GetOrCreateCategory(const std::string &name);
+
+  /**
+   * Refills the token bucket of the category depending on the time passed
+   * since the last refill.
+   * @param category category to refill
+   */
+  static void Refill(Category &category);
+
+public:
+  explicit JobCategoryLimiter(common::config::SharedConfiguration config);
+  JobCategoryLimiter(JobCategoryLimiter &other) = delete;
+
+  /**
+   * Sets the limits of a job category. This replaces limits loaded from the
+   * configuration.
+   * @param category name of the category
+   * @param limits new limits of the category
+   */
+  void SetLimits(const std::string &category, const JobCategoryLimits &limits);
+
+  /**
+   * Get the limits of a job category.
+   * @param category name of the category
+   * @return limits of the category
+   */
+  JobCategoryLimits GetLimits(const std::string &category);
+
+  /**
+   * Takes a token from the bucket of the job's category.
+   * @param job job that is about to be scheduled
+   * @return false, if the rate of its category has been exceeded and the job
+   * should be deferred
+   */
+  bool TryConsumeToken(const SharedJob &job);
+
+  /**
+   * Acquires a slot of the job's category for its execution. If there is no
+   * free slot, the limiter holds the job back until a slot is released.
+   * @note Asynchronous jobs are not limited and never hold a slot.
+   * @param job job that is about to be scheduled
+   * @return true, if the job can be scheduled. Otherwise, it is held back by
+   * the limiter.
+   */
+  bool TryAcquireSlot(const SharedJob &job);
+
+  /**
+   * Releases the slot acquired by an executed job and passes it on to the next
+   * job held back in the same category.
+   * @param job job that has been executed
+   * @return job that acquired the released slot and must be scheduled now or
+   * nullptr, if there is none.
+   */
+  SharedJob ReleaseSlot(const SharedJob &job);
+
+  /**
+   * Get the count of jobs held back because their category's concurrency
+   * limit has been reached.
+   * @param category name of the category
+   * @return count of held back jobs
+   */
+  size_t GetHeldJobCount(const std::string &category) const;
+};
+
+} // namespace hive::jobsystem
@@ -7,6 +7,9 @@
 
 #include "JobManagerState.h"
 #include "common/config/Configuration.h"
+#include "jobsystem/manager/CycleWatchdog.h"
+#include "jobsystem/manager/JobCategoryLimiter.h"
+#include "jobsystem/profiling/CycleTracer.h"
 #include "jobsystem/execution/IJobExecution.h"
 #include "jobsystem/jobs/Job.h"
 #include "jobsystem/jobs/TimerJob.h"
@@ -75,6 +78,21 @@ private:
 
   size_t m_total_cycle_count{0};
 
+  /**
+   * Observes the cycle phases and reports those exceeding their time budget.
+   * @note This is only set if a phase budget has been configured.
+   */
+  std::unique_ptr<CycleWatchdog> m_watchdog;
+
+  /**
+   * Traces synchronous jobs and analyzes the critical path of each cycle.
+   * @note This is only set if the analysis has been enabled.
+   */
+  std::unique_ptr<profiling::CycleTracer> m_tracer;
+
+  /** Enforces the concurrency and rate limits of job categories. */
+  JobCategoryLimiter m_category_limiter;
+
 // Debug values
 #ifndef NDEBUG
   std::atomic<size_t> m_job_execution_counter{0};
@@ -107,12 +125,25 @@ private:
                               recursive_mutex &queue_mutex,
                               const SharedJobCounter &counter);
 
+  /**
+   * Passes a job to the execution after it has passed all limits.
+   * @param job job that should be executed
+   */
+  void ScheduleJob(const SharedJob &job);
+
   /**
    * The continuation requeue blacklist is used when cancelling jobs by
    * preventing their re-queueing. This operation clears the blacklist.
    */
   void ResetContinuationRequeueBlacklist();
 
+  /**
+   * Sets the current state of the manager and notifies the watchdog and
+   * tracer (if there are any) about the started phase.
+   * @param state new state of the manager
+   */
+  void SetCurrentState(JobManagerState state);
+
 public:
   JobManager() = delete;
   explicit JobManager(const common::config::SharedConfiguration &config);
@@ -160,6 +191,35 @@ public:
    */
   void KickJobForNextCycle(const SharedJob &job);
 
+  /**
+   * Notifies the manager that the execution of a job has ended. This releases
+   * the slot the job occupied in its category.
+   * @param job job that has been executed
+   * @note This is called by the job execution.
+   */
+  void OnJobExecuted(const SharedJob &job);
+
+  /**
+   * Sets the limits of a job category, which replace those configured
+   * ('jobs.categories.<name>.max-concurrency', 'jobs.categories.<name>.rate'
+   * and 'jobs.categories.<name>.burst').
+   * @param category name of the category (see Job::SetCategory)
+   * @param limits concurrency and rate limits of the category
+   * @attention A job must not wait for jobs of its own category, if the
+   * concurrency of the category is limited: the waiting job keeps its slot,
+   * so the awaited jobs might never get one (e.g. with a limit of 1).
+   */
+  void SetJobCategoryLimits(const std::string &category,
+                            const JobCategoryLimits &limits);
+
+  /**
+   * Get the count of jobs which are currently held back because their
+   * category has reached its concurrency limit.
+   * @param category name of the category
+   * @return count of held back jobs
+   */
+  size_t GetHeldJobCount(const std::string &category) const;
+
   /**
    * Starts a new execution cycle and passes queued jobs to the execution. The
    * calling thread will be blocked until all synchronous jobs are done.
@@ -211,6 +271,38 @@ public:
    * @return total count of cycles
    */
   size_t GetTotalCyclesCount() const;
+
+  /**
+   * Set a handler that receives a report every time a phase of the cycle
+   * exceeds its configured budget ('jobs.watchdog.phase-budget-ms'). This can
+   * be used to export stall reports.
+   * @param handler handler receiving stall reports. It is called on the
+   * watchdog thread, not inside the job system.
+   * @note Stall reports are always logged as warnings, even without handler.
+   */
+  void SetStallReportHandler(std::function<void(const StallReport &)> handler);
+
+  /**
+   * Get the most recent report of a stalling cycle phase.
+   * @return last stall report, if the watchdog is enabled and has detected a
+   * stall
+   */
+  std::optional<StallReport> GetLastStallReport() const;
+
+  /**
+   * Get the critical path analysis of the most recently completed cycle.
+   * @return analysis, if it has been enabled ('jobs.analysis.enabled') and a
+   * cycle has been completed since
+   */
+  std::optional<profiling::CycleAnalysis> GetLastCycleAnalysis() const;
+
+  /**
+   * Summarizes the critical path analyses of the most recent cycles
+   * ('jobs.analysis.window'). This tells where parallelism is being lost.
+   * @return summary, if the analysis has been enabled
+   */
+  std::optional<profiling::CycleAnalysisSummary>
+  GetCycleAnalysisSummary() const;
 };
 
 inline void
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "jobsystem/JobState.h"
+#include "jobsystem/manager/JobManagerState.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hive::jobsystem {
+
+/**
+ * Snapshot of a single job that was still unfinished when a stall of the
+ * execution cycle has been detected.
+ */
+struct StalledJobInfo {
+  /** id (label) of the job */
+  std::string id;
+
+  /** state of the job at the time of the snapshot */
+  JobState state;
+
+  /**
+   * Time that passed since the job started its execution. This is zero if the
+   * job has not been picked up by a worker yet.
+   */
+  std::chrono::nanoseconds elapsed{0};
+
+  /**
+   * Worker thread that started executing the job.
+   * @note Fibers can migrate between worker threads when they yield, so the
+   * job might currently be running (or waiting) on a different one.
+   */
+  std::thread::id worker;
+};
+
+/**
+ * Describes an execution phase of a cycle that exceeded its time budget and
+ * lists all jobs the phase is still waiting for.
+ */
+struct StallReport {
+  /** number of the stalling cycle */
+  size_t cycle{0};
+
+  /** phase of the cycle that stalled */
+  JobManagerState phase{READY};
+
+  /** time that passed since the phase has been started */
+  std::chrono::nanoseconds phase_elapsed{0};
+
+  /** configured time budget of a single phase */
+  std::chrono::nanoseconds budget{0};
+
+  /** all jobs that have not finished yet, longest running first */
+  std::vector<StalledJobInfo> unfinished_jobs;
+
+  /**
+   * Renders this report in a human-readable format for logging.
+   * @return multi-line textual representation of this report
+   */
+  std::string ToString() const;
+};
+
+/**
+ * Get a readable name of the job manager state.
+ * @param state state of the job manager
+ * @return name of the state
+ */
+const char *ToString(JobManagerState state);
+
+/**
+ * Get a readable name of the job state.
+ * @param state state of the job
+ * @return name of the state
+ */
+const char *ToString(JobState state);
+
+} // namespace hive::jobsystem
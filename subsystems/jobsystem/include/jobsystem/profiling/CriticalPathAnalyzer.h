@@ -0,0 +1,174 @@
+#pragma once
+
+#include "jobsystem/profiling/JobTrace.h"
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace hive::jobsystem::profiling {
+
+/**
+ * Describes what happened during a segment of the critical path.
+ */
+enum CriticalPathSegmentKind {
+  /** A job has been executing its workload. */
+  WORK,
+
+  /**
+   * A job has been ready to run (or to resume), but no worker has picked it
+   * up yet.
+   */
+  SCHEDULING,
+
+  /**
+   * A job has been waiting for something that is not tracked by the job
+   * system (e.g. a future or a fixed duration).
+   */
+  WAITING,
+
+  /**
+   * The cycle has been waiting for a phase barrier, i.e. the transition from
+   * one phase to the next one.
+   */
+  BARRIER
+};
+
+/**
+ * Continuous part of the critical path that is attributed to a single job.
+ */
+struct CriticalPathSegment {
+  std::string job_id;
+  CriticalPathSegmentKind kind;
+  std::chrono::nanoseconds duration{0};
+};
+
+/**
+ * Breaks time down into the categories relevant for parallelism.
+ */
+struct CycleTimeBreakdown {
+  /** time spent executing workloads */
+  std::chrono::nanoseconds work{0};
+
+  /** time jobs have been ready, but not running */
+  std::chrono::nanoseconds scheduling_delay{0};
+
+  /** time jobs have been suspended while waiting */
+  std::chrono::nanoseconds waiting{0};
+
+  /** time worker threads had nothing to do */
+  std::chrono::nanoseconds idle{0};
+};
+
+/**
+ * Result of the critical path analysis of a single execution cycle.
+ */
+struct CycleAnalysis {
+  size_t cycle{0};
+  size_t job_count{0};
+  std::chrono::nanoseconds duration{0};
+
+  /** durations of the init, main and clean-up phase (in this order) */
+  std::chrono::nanoseconds phase_durations[3]{};
+
+  /**
+   * Time of all jobs and workers combined. The idle time is the capacity of
+   * all workers during the cycle that has not been used for work.
+   */
+  CycleTimeBreakdown total;
+
+  /** Time along the critical path only. Its sum equals the cycle duration. */
+  CycleTimeBreakdown critical_path;
+
+  /** all segments of the critical path in chronological order */
+  std::vector<CriticalPathSegment> segments;
+
+  /**
+   * Average amount of workers that have been doing useful work during the
+   * cycle. If this is much lower than the worker count, parallelism is lost.
+   */
+  double parallelism{0};
+};
+
+/**
+ * Job that frequently contributes to the critical path of cycles.
+ */
+struct CriticalPathContributor {
+  std::string job_id;
+
+  /** amount of cycles in which the job has been on the critical path */
+  size_t cycles{0};
+
+  /** total time the job has contributed to the critical path */
+  std::chrono::nanoseconds time{0};
+};
+
+/**
+ * Summary of the critical path analyses of multiple consecutive cycles.
+ */
+struct CycleAnalysisSummary {
+  size_t cycles{0};
+  size_t worker_count{0};
+  std::chrono::nanoseconds average_duration{0};
+  std::chrono::nanoseconds max_duration{0};
+  double average_parallelism{0};
+
+  /** averages per cycle of all jobs and workers combined */
+  CycleTimeBreakdown average_total;
+
+  /** averages per cycle along the critical path */
+  CycleTimeBreakdown average_critical_path;
+
+  /** jobs contributing most to the critical path, highest first */
+  std::vector<CriticalPathContributor> top_contributors;
+
+  /**
+   * Renders this summary in a human-readable format.
+   * @return multi-line textual representation
+   */
+  std::string ToString() const;
+
+  /**
+   * Renders this summary as JSON object.
+   * @return JSON representation
+   */
+  std::string ToJson() const;
+};
+
+/**
+ * Explains why an execution cycle took as long as it did: It computes the
+ * critical path through the cycle, following phase barriers, jobs kicking
+ * other jobs and WaitForCompletion() edges of counters, and breaks the cycle
+ * time down into useful work, scheduling delay, waiting and idle workers.
+ */
+class CriticalPathAnalyzer {
+public:
+  /**
+   * Analyzes a single completed cycle.
+   * @param trace traces recorded during the cycle
+   * @param worker_count count of worker threads used in the cycle
+   * @return analysis of the cycle
+   */
+  static CycleAnalysis Analyze(const CycleTrace &trace, size_t worker_count);
+
+  /**
+   * Summarizes the analyses of a window of cycles.
+   * @param analyses analyses of consecutive cycles
+   * @param worker_count count of worker threads used in the cycles
+   * @param max_contributors maximum count of listed critical path
+   * contributors
+   * @return summary of the analyses
+   */
+  static CycleAnalysisSummary
+  Summarize(const std::deque<CycleAnalysis> &analyses, size_t worker_count,
+            size_t max_contributors = 10);
+};
+
+/**
+ * Get a readable name of the critical path segment kind.
+ * @param kind kind of segment
+ * @return name of the kind
+ */
+const char *ToString(CriticalPathSegmentKind kind);
+
+} // namespace hive::jobsystem::profiling
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "jobsystem/jobs/Job.h"
+#include "jobsystem/manager/JobManagerState.h"
+#include "jobsystem/profiling/CriticalPathAnalyzer.h"
+#include "jobsystem/profiling/JobTrace.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <deque>
+#include <optional>
+
+namespace hive::jobsystem::profiling {
+
+/**
+ * Records traces of all synchronous jobs of each execution cycle and analyzes
+ * the cycle's critical path once it has been completed. The analyses of the
+ * most recent cycles are kept in a sliding window.
+ */
+class CycleTracer {
+private:
+  const size_t m_window_size;
+  const size_t m_worker_count;
+
+  /** traces of the currently running cycle */
+  CycleTrace m_current_cycle;
+  JobManagerState m_current_state{READY};
+  mutable mutex m_current_cycle_mutex;
+
+  /** analyses of the most recent cycles, oldest first */
+  std::deque<CycleAnalysis> m_window;
+  mutable mutex m_window_mutex;
+
+  void FinishCycle(trace_time_point now);
+
+public:
+  /**
+   * Creates a tracer.
+   * @param window_size count of the most recent cycles kept for the summary
+   * @param worker_count count of worker threads executing jobs
+   */
+  CycleTracer(size_t window_size, size_t worker_count);
+
+  /**
+   * Notifies the tracer that the job manager entered a new state. This starts
+   * and finishes phases and cycles.
+   * @param cycle number of the current cycle
+   * @param state new state of the job manager
+   */
+  void OnStateChanged(size_t cycle, JobManagerState state);
+
+  /**
+   * Creates a trace for a synchronous job that is passed to the execution.
+   * @param job job that is about to be scheduled
+   * @return trace that must be filled during the job's execution
+   */
+  SharedJobTrace OnJobScheduled(const SharedJob &job);
+
+  /**
+   * Get the analysis of the most recently completed cycle.
+   * @return analysis, if any cycle has been completed yet
+   */
+  std::optional<CycleAnalysis> GetLastCycleAnalysis() const;
+
+  /**
+   * Summarizes the analyses of all cycles in the current window.
+   * @return summary of the current window
+   */
+  CycleAnalysisSummary GetSummary() const;
+
+  /**
+   * Get the trace of the job currently executed by the calling fiber.
+   * @return trace of the current job or nullptr, if the caller is not a
+   * traced job.
+   */
+  static SharedJobTrace GetCurrentTrace();
+
+  /**
+   * Set the trace of the job currently executed by the calling fiber.
+   * @param trace trace of the current job or nullptr to reset it.
+   */
+  static void SetCurrentTrace(const SharedJobTrace &trace);
+};
+
+} // namespace hive::jobsystem::profiling
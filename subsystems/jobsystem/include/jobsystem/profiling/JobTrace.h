@@ -0,0 +1,98 @@
+#pragma once
+
+#include "jobsystem/JobExecutionPhase.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hive::jobsystem::profiling {
+
+typedef std::chrono::steady_clock::time_point trace_time_point;
+
+struct JobTrace;
+
+/**
+ * Records a single period in which a traced job has been suspended because
+ * it was waiting for something (e.g. a counter, future or duration).
+ */
+struct JobWaitTrace {
+  trace_time_point begin;
+  trace_time_point end;
+
+  /**
+   * Job that finished last before the awaited counter has been released.
+   * This is empty if the job waited for something that is not tracked by the
+   * job system (e.g. a future or a fixed duration).
+   * @note This is a weak reference to avoid reference cycles between traces.
+   */
+  std::weak_ptr<JobTrace> released_by;
+};
+
+/**
+ * Records the timings of a single execution of a synchronous job during an
+ * execution cycle. These records are the foundation of the critical path
+ * analysis.
+ * @note A trace is written by the fiber executing the job and must only be
+ * read after the job has finished (e.g. after the cycle has completed).
+ */
+struct JobTrace {
+  /** id (label) of the job */
+  std::string id;
+
+  /** phase of the cycle in which the job has been executed */
+  JobExecutionPhase phase{MAIN};
+
+  /** point in time the job has been passed to the execution */
+  trace_time_point scheduled;
+
+  /** point in time a worker started executing the job */
+  trace_time_point started;
+
+  /** point in time the job finished its execution */
+  trace_time_point finished;
+
+  /** true, if the job has been executed completely */
+  bool completed{false};
+
+  /** worker thread that started executing the job */
+  std::thread::id worker;
+
+  /** all periods in which the job has been waiting, ordered by time */
+  std::vector<JobWaitTrace> waits;
+
+  /**
+   * Job that kicked this one during the same phase. It's empty if the job has
+   * been scheduled at the beginning of its phase.
+   * @note This is a weak reference to avoid reference cycles between traces.
+   */
+  std::weak_ptr<JobTrace> spawned_by;
+};
+
+typedef std::shared_ptr<JobTrace> SharedJobTrace;
+
+/**
+ * Records the timings of a single phase of an execution cycle.
+ */
+struct PhaseTrace {
+  trace_time_point begin;
+  trace_time_point end;
+};
+
+/**
+ * Collects all traces recorded during a single execution cycle.
+ */
+struct CycleTrace {
+  size_t cycle{0};
+  trace_time_point begin;
+  trace_time_point end;
+
+  /** traces of the init, main and clean-up phase (in this order) */
+  PhaseTrace phases[3];
+
+  /** traces of all synchronous jobs executed in this cycle */
+  std::vector<SharedJobTrace> jobs;
+};
+
+} // namespace hive::jobsystem::profiling
@@ -0,0 +1,290 @@
+#pragma once
+
+#include "common/assert/Assert.h"
+#include "jobsystem/synchronization/JobMutex.h"
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// include order matters here
+#include "boost/fiber/condition_variable.hpp"
+
+namespace hive::jobsystem {
+
+namespace execution::impl {
+// Defined in the fiber based job execution
+bool IsExecutedByFiber();
+} // namespace execution::impl
+
+/**
+ * Result of an operation on a job channel.
+ */
+enum JobChannelStatus {
+  /** The value has been sent or received. */
+  CHANNEL_SUCCESS,
+
+  /** There was no value to receive (only returned by non-waiting calls). */
+  CHANNEL_EMPTY,
+
+  /** There was no space left (only returned by non-waiting calls). */
+  CHANNEL_FULL,
+
+  /**
+   * The channel has been closed: No values can be sent anymore and all
+   * remaining values have already been received.
+   */
+  CHANNEL_CLOSED
+};
+
+/**
+ * Bounded multi-producer multi-consumer queue used to pass values between
+ * jobs (e.g. stages of a pipeline). When the channel is full, senders are
+ * suspended until there is space again. When it is empty, receivers are
+ * suspended until values arrive. This results in backpressure between
+ * producing and consuming jobs without burning worker threads.
+ * @tparam T type of the transported values
+ * @note Jobs (fibers) are suspended and resumed by the scheduler, so they do
+ * not occupy a worker while waiting. Normal threads (e.g. the main thread)
+ * yield instead because fiber primitives cannot block them safely.
+ */
+template <typename T> class JobChannel {
+private:
+  const size_t m_capacity;
+  std::deque<T> m_values;
+  bool m_closed{false};
+  mutable mutex m_mutex;
+
+  /** suspended fibers waiting for values to arrive */
+  boost::fibers::condition_variable_any m_not_empty;
+
+  /** suspended fibers waiting for space to become available */
+  boost::fibers::condition_variable_any m_not_full;
+
+  /**
+   * Suspends the calling fiber (or yields the calling thread) until the
+   * predicate becomes true.
+   * @param lock acquired lock of the channel mutex
+   * @param condition condition variable that is notified when the predicate
+   * could have changed
+   * @param predicate continues once this is true
+   */
+  template <typename Predicate>
+  void Wait(std::unique_lock<mutex> &lock,
+            boost::fibers::condition_variable_any &condition,
+            Predicate predicate);
+
+public:
+  /**
+   * Creates a channel.
+   * @param capacity maximum count of values the channel can buffer before
+   * senders have to wait.
+   */
+  explicit JobChannel(size_t capacity);
+  JobChannel(JobChannel &other) = delete;
+
+  /**
+   * Sends a value. If the channel is full, the caller waits until there is
+   * space again.
+   * @param value value to send
+   * @return CHANNEL_SUCCESS or CHANNEL_CLOSED, if the channel has been closed
+   * (the value is discarded in this case)
+   */
+  JobChannelStatus Send(T value);
+
+  /**
+   * Sends a value without waiting.
+   * @param value value to send
+   * @return CHANNEL_SUCCESS, CHANNEL_FULL or CHANNEL_CLOSED
+   */
+  JobChannelStatus TrySend(T value);
+
+  /**
+   * Receives a value. If the channel is empty, the caller waits until a value
+   * arrives.
+   * @param value received value
+   * @return CHANNEL_SUCCESS or CHANNEL_CLOSED, if the channel has been closed
+   * and there are no values left.
+   */
+  JobChannelStatus Receive(T &value);
+
+  /**
+   * Receives a value without waiting.
+   * @param value received value
+   * @return CHANNEL_SUCCESS, CHANNEL_EMPTY or CHANNEL_CLOSED
+   */
+  JobChannelStatus TryReceive(T &value);
+
+  /**
+   * Receives all buffered values, but at most the given amount. If the
+   * channel is empty, the caller waits until at least one value arrives.
+   * @param values received values are appended to this vector
+   * @param max_count maximum count of values to receive
+   * @return count of received values. This is 0 if the channel has been
+   * closed and there are no values left.
+   */
+  size_t ReceiveBatch(std::vector<T> &values, size_t max_count);
+
+  /**
+   * Closes the channel. Values cannot be sent anymore, but buffered values
+   * can still be received. All waiting parties are woken up.
+   */
+  void Close();
+
+  /**
+   * Checks if the channel has been closed.
+   * @return true, if the channel has been closed
+   */
+  bool IsClosed() const;
+
+  /**
+   * Get the count of currently buffered values.
+   * @return count of buffered values
+   */
+  size_t GetSize() const;
+
+  /**
+   * Get the maximum count of buffered values.
+   * @return capacity of the channel
+   */
+  size_t GetCapacity() const;
+};
+
+template <typename T>
+JobChannel<T>::JobChannel(size_t capacity) : m_capacity(capacity) {
+  DEBUG_ASSERT(capacity > 0, "channel capacity must be greater than zero")
+}
+
+template <typename T>
+template <typename Predicate>
+void JobChannel<T>::Wait(std::unique_lock<mutex> &lock,
+                         boost::fibers::condition_variable_any &condition,
+                         Predicate predicate) {
+  if (execution::impl::IsExecutedByFiber()) {
+    // caller is a fiber, so suspend it until notified
+    condition.wait(lock, predicate);
+  } else {
+    // caller is a thread, so yield
+    while (!predicate()) {
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+    }
+  }
+}
+
+template <typename T> JobChannelStatus JobChannel<T>::Send(T value) {
+  std::unique_lock lock(m_mutex);
+  Wait(lock, m_not_full,
+       [this]() { return m_closed || m_values.size() < m_capacity; });
+
+  if (m_closed) {
+    return CHANNEL_CLOSED;
+  }
+
+  m_values.push_back(std::move(value));
+  lock.unlock();
+
+  m_not_empty.notify_one();
+  return CHANNEL_SUCCESS;
+}
+
+template <typename T> JobChannelStatus JobChannel<T>::TrySend(T value) {
+  std::unique_lock lock(m_mutex);
+  if (m_closed) {
+    return CHANNEL_CLOSED;
+  }
+
+  if (m_values.size() >= m_capacity) {
+    return CHANNEL_FULL;
+  }
+
+  m_values.push_back(std::move(value));
+  lock.unlock();
+
+  m_not_empty.notify_one();
+  return CHANNEL_SUCCESS;
+}
+
+template <typename T> JobChannelStatus JobChannel<T>::Receive(T &value) {
+  std::unique_lock lock(m_mutex);
+  Wait(lock, m_not_empty, [this]() { return m_closed || !m_values.empty(); });
+
+  if (m_values.empty()) {
+    return CHANNEL_CLOSED;
+  }
+
+  value = std::move(m_values.front());
+  m_values.pop_front();
+  lock.unlock();
+
+  m_not_full.notify_one();
+  return CHANNEL_SUCCESS;
+}
+
+template <typename T> JobChannelStatus JobChannel<T>::TryReceive(T &value) {
+  std::unique_lock lock(m_mutex);
+  if (m_values.empty()) {
+    return m_closed ? CHANNEL_CLOSED : CHANNEL_EMPTY;
+  }
+
+  value = std::move(m_values.front());
+  m_values.pop_front();
+  lock.unlock();
+
+  m_not_full.notify_one();
+  return CHANNEL_SUCCESS;
+}
+
+template <typename T>
+size_t JobChannel<T>::ReceiveBatch(std::vector<T> &values, size_t max_count) {
+  if (max_count == 0) {
+    return 0;
+  }
+
+  std::unique_lock lock(m_mutex);
+  Wait(lock, m_not_empty, [this]() { return m_closed || !m_values.empty(); });
+
+  size_t count = std::min(max_count, m_values.size());
+  for (size_t i = 0; i < count; i++) {
+    values.push_back(std::move(m_values.front()));
+    m_values.pop_front();
+  }
+  lock.unlock();
+
+  // multiple senders could continue now
+  if (count > 0) {
+    m_not_full.notify_all();
+  }
+
+  return count;
+}
+
+template <typename T> void JobChannel<T>::Close() {
+  {
+    std::unique_lock lock(m_mutex);
+    m_closed = true;
+  }
+
+  m_not_empty.notify_all();
+  m_not_full.notify_all();
+}
+
+template <typename T> bool JobChannel<T>::IsClosed() const {
+  std::unique_lock lock(m_mutex);
+  return m_closed;
+}
+
+template <typename T> size_t JobChannel<T>::GetSize() const {
+  std::unique_lock lock(m_mutex);
+  return m_values.size();
+}
+
+template <typename T> inline size_t JobChannel<T>::GetCapacity() const {
+  return m_capacity;
+}
+
+template <typename T> using SharedJobChannel = std::shared_ptr<JobChannel<T>>;
+
+} // namespace hive::jobsystem
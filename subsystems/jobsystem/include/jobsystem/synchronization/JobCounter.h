@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/assert/Assert.h"
+#include "jobsystem/profiling/JobTrace.h"
 #include "jobsystem/synchronization/IJobWaitable.h"
 #include "jobsystem/synchronization/JobMutex.h"
 #include <memory>
@@ -22,6 +23,12 @@ private:
   size_t m_count{0};
   mutable jobsystem::mutex m_count_mutex;
 
+  /**
+   * Trace of the job that has decreased this counter last. This is only set
+   * if the critical path analysis is enabled.
+   */
+  std::weak_ptr<profiling::JobTrace> m_last_finished_job;
+
 public:
   /**
    * Increment the job counter
@@ -41,6 +48,19 @@ public:
    */
   bool IsFinished() override;
 
+  /**
+   * Remembers the trace of the job that is about to decrease this counter.
+   * @param trace trace of the finishing job
+   */
+  void SetLastFinishedJob(const profiling::SharedJobTrace &trace);
+
+  /**
+   * Get the trace of the job that has decreased this counter last. This is
+   * used to follow WaitForCompletion() edges in the critical path analysis.
+   * @return trace of the last finished job, if it has been traced
+   */
+  profiling::SharedJobTrace GetLastFinishedJob() const;
+
   virtual ~JobCounter() = default;
 };
 
@@ -60,6 +80,17 @@ inline bool JobCounter::IsFinished() {
   return m_count < 1;
 }
 
+inline void
+JobCounter::SetLastFinishedJob(const profiling::SharedJobTrace &trace) {
+  std::unique_lock lock(m_count_mutex);
+  m_last_finished_job = trace;
+}
+
+inline profiling::SharedJobTrace JobCounter::GetLastFinishedJob() const {
+  std::unique_lock lock(m_count_mutex);
+  return m_last_finished_job.lock();
+}
+
 typedef std::shared_ptr<jobsystem::JobCounter> SharedJobCounter;
 
 } // namespace hive::jobsystem
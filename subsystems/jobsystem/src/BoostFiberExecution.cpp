@@ -41,8 +41,11 @@ void BoostFiberExecution::Schedule(const std::shared_ptr<Job> &job) {
         manager->KickJobForNextCycle(job);
       }
 
+      // pass the category slot on before the phase can complete
+      manager->OnJobExecuted(job);
       job->FinishJob();
     } else {
+      // the category slot was part of the manager's limiter, which is gone
       LOG_ERR("Cannot execute job "
               << job->GetId()
               << " because job manager has already been destroyed")
@@ -56,6 +59,11 @@ void BoostFiberExecution::Schedule(const std::shared_ptr<Job> &job) {
 
   // check other status codes than 'success'
   if (status != boost::fibers::channel_op_status::success) {
+    // the job will never run, so it must not keep its category slot
+    if (auto maybe_manager = m_managing_instance.TryBorrow()) {
+      maybe_manager.value()->OnJobExecuted(job);
+    }
+
     switch (status) {
     case boost::fibers::channel_op_status::closed:
       LOG_ERR("cannot schedule job " << job->GetId()
@@ -81,6 +89,14 @@ void BoostFiberExecution::WaitForCompletion(
 #endif
 
   if (IsExecutedByFiber()) {
+    if (waitable->IsFinished()) {
+      return;
+    }
+
+    auto trace = profiling::CycleTracer::GetCurrentTrace();
+    auto wait_begin = trace ? std::chrono::steady_clock::now()
+                            : std::chrono::steady_clock::time_point();
+
     // caller is a fiber, so yield
     auto id_before = boost::this_fiber::get_id();
     while (!waitable->IsFinished()) {
@@ -90,6 +106,16 @@ void BoostFiberExecution::WaitForCompletion(
     auto id_after = boost::this_fiber::get_id();
     DEBUG_ASSERT(id_before == id_after,
                  "fiber must not change id during yielding")
+
+    if (trace) {
+      // counters know which job released them, other waitables do not
+      profiling::SharedJobTrace released_by;
+      if (auto counter = std::dynamic_pointer_cast<JobCounter>(waitable)) {
+        released_by = counter->GetLastFinishedJob();
+      }
+      trace->waits.push_back(
+          {wait_begin, std::chrono::steady_clock::now(), released_by});
+    }
   } else {
     // caller is a thread, so block
     while (!waitable->IsFinished()) {
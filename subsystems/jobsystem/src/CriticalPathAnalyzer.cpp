@@ -0,0 +1,356 @@
+#include "jobsystem/profiling/CriticalPathAnalyzer.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+
+using namespace hive::jobsystem::profiling;
+using namespace std::chrono;
+
+#define BARRIER_SEGMENT_ID "<phase-barrier>"
+
+const char *hive::jobsystem::profiling::ToString(CriticalPathSegmentKind kind) {
+  switch (kind) {
+  case WORK:
+    return "work";
+  case SCHEDULING:
+    return "scheduling";
+  case WAITING:
+    return "waiting";
+  case BARRIER:
+    return "barrier";
+  }
+  return "unknown";
+}
+
+static double ToMilliseconds(nanoseconds time) {
+  return duration_cast<duration<double, std::milli>>(time).count();
+}
+
+static std::string EscapeJson(const std::string &value) {
+  std::stringstream ss;
+  for (char c : value) {
+    switch (c) {
+    case '"':
+      ss << "\\\"";
+      break;
+    case '\\':
+      ss << "\\\\";
+      break;
+    case '\n':
+      ss << "\\n";
+      break;
+    case '\t':
+      ss << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast<int>(c) << std::dec;
+      } else {
+        ss << c;
+      }
+    }
+  }
+  return ss.str();
+}
+
+static void AddToBreakdown(CycleTimeBreakdown &breakdown,
+                           CriticalPathSegmentKind kind,
+                           nanoseconds duration) {
+  switch (kind) {
+  case WORK:
+    breakdown.work += duration;
+    break;
+  case SCHEDULING:
+    breakdown.scheduling_delay += duration;
+    break;
+  case WAITING:
+    breakdown.waiting += duration;
+    break;
+  case BARRIER:
+    // workers are idle while the cycle transitions between phases
+    breakdown.idle += duration;
+    break;
+  }
+}
+
+CycleAnalysis CriticalPathAnalyzer::Analyze(const CycleTrace &trace,
+                                            size_t worker_count) {
+  CycleAnalysis analysis;
+  analysis.cycle = trace.cycle;
+  analysis.duration = trace.end - trace.begin;
+
+  for (int i = 0; i < 3; i++) {
+    auto phase_duration = trace.phases[i].end - trace.phases[i].begin;
+    analysis.phase_durations[i] = std::max(nanoseconds(0), phase_duration);
+  }
+
+  /*
+   * Break down the time of all jobs and workers combined. Whatever capacity
+   * of the workers has not been used for work, has been idle.
+   */
+  const JobTrace *last_job_of_phase[3]{nullptr, nullptr, nullptr};
+  for (const auto &job : trace.jobs) {
+    if (!job->completed) {
+      continue;
+    }
+
+    analysis.job_count++;
+
+    nanoseconds waited{0};
+    for (const auto &wait : job->waits) {
+      waited += wait.end - wait.begin;
+    }
+
+    analysis.total.work += (job->finished - job->started) - waited;
+    analysis.total.waiting += waited;
+    analysis.total.scheduling_delay += job->started - job->scheduled;
+
+    auto &last_job = last_job_of_phase[job->phase];
+    if (!last_job || job->finished > last_job->finished) {
+      last_job = job.get();
+    }
+  }
+
+  auto capacity =
+      analysis.duration * static_cast<nanoseconds::rep>(worker_count);
+  analysis.total.idle =
+      std::max(nanoseconds(0), capacity - analysis.total.work);
+
+  if (analysis.duration.count() > 0) {
+    analysis.parallelism =
+        static_cast<double>(analysis.total.work.count()) /
+        static_cast<double>(analysis.duration.count());
+  }
+
+  /*
+   * Walk the critical path backwards, starting at the end of the cycle. Each
+   * phase ends with the job that finished last. From there, the path follows
+   * whatever delayed the current job: The job that released a counter it has
+   * been waiting for, the job that kicked it or the barrier of the previous
+   * phase.
+   */
+  std::vector<CriticalPathSegment> reversed_segments;
+  auto add_segment = [&reversed_segments, &analysis](
+                         const std::string &job_id,
+                         CriticalPathSegmentKind kind, nanoseconds duration) {
+    if (duration.count() <= 0) {
+      return;
+    }
+
+    AddToBreakdown(analysis.critical_path, kind, duration);
+
+    bool extends_last_segment = !reversed_segments.empty() &&
+                                reversed_segments.back().kind == kind &&
+                                reversed_segments.back().job_id == job_id;
+    if (extends_last_segment) {
+      reversed_segments.back().duration += duration;
+    } else {
+      reversed_segments.push_back({job_id, kind, duration});
+    }
+  };
+
+  // guards against endless walks caused by inconsistent traces
+  size_t remaining_hops = trace.jobs.size() * 2 + 1;
+
+  trace_time_point cursor = trace.end;
+  for (int phase = 2; phase >= 0; phase--) {
+    const JobTrace *job = last_job_of_phase[phase];
+    if (!job) {
+      continue /* because empty phases are part of the barrier */;
+    }
+
+    add_segment(BARRIER_SEGMENT_ID, BARRIER, cursor - job->finished);
+    trace_time_point time = job->finished;
+
+    while (job && remaining_hops-- > 0) {
+      const JobTrace *next_job = nullptr;
+
+      for (auto wait = job->waits.rbegin(); wait != job->waits.rend();
+           ++wait) {
+        if (wait->end > time) {
+          continue;
+        }
+
+        add_segment(job->id, WORK, time - wait->end);
+
+        // all traces of the cycle are kept alive by the cycle trace
+        const JobTrace *releaser = wait->released_by.lock().get();
+        bool was_released_by_job = releaser && releaser->completed &&
+                                   releaser->finished >= wait->begin &&
+                                   releaser->finished <= wait->end;
+        if (was_released_by_job) {
+          // resuming the job after it has been released is scheduling delay
+          add_segment(job->id, SCHEDULING, wait->end - releaser->finished);
+          next_job = releaser;
+          time = releaser->finished;
+          break;
+        }
+
+        add_segment(job->id, WAITING, wait->end - wait->begin);
+        time = wait->begin;
+      }
+
+      if (next_job) {
+        job = next_job;
+        continue;
+      }
+
+      add_segment(job->id, WORK, time - job->started);
+      add_segment(job->id, SCHEDULING, job->started - job->scheduled);
+      time = job->scheduled;
+
+      const JobTrace *parent = job->spawned_by.lock().get();
+      bool was_spawned_by_job = parent && parent->completed &&
+                                parent->started <= time &&
+                                time <= parent->finished;
+      job = was_spawned_by_job ? parent : nullptr;
+    }
+
+    cursor = time;
+  }
+
+  add_segment(BARRIER_SEGMENT_ID, BARRIER, cursor - trace.begin);
+
+  analysis.segments.assign(reversed_segments.rbegin(),
+                           reversed_segments.rend());
+  return analysis;
+}
+
+CycleAnalysisSummary
+CriticalPathAnalyzer::Summarize(const std::deque<CycleAnalysis> &analyses,
+                                size_t worker_count, size_t max_contributors) {
+  CycleAnalysisSummary summary;
+  summary.worker_count = worker_count;
+  summary.cycles = analyses.size();
+
+  if (analyses.empty()) {
+    return summary;
+  }
+
+  nanoseconds total_duration{0};
+  double total_parallelism{0};
+  CycleTimeBreakdown total, critical_path;
+  std::map<std::string, CriticalPathContributor> contributors;
+
+  for (const auto &analysis : analyses) {
+    total_duration += analysis.duration;
+    summary.max_duration = std::max(summary.max_duration, analysis.duration);
+    total_parallelism += analysis.parallelism;
+
+    total.work += analysis.total.work;
+    total.scheduling_delay += analysis.total.scheduling_delay;
+    total.waiting += analysis.total.waiting;
+    total.idle += analysis.total.idle;
+
+    critical_path.work += analysis.critical_path.work;
+    critical_path.scheduling_delay += analysis.critical_path.scheduling_delay;
+    critical_path.waiting += analysis.critical_path.waiting;
+    critical_path.idle += analysis.critical_path.idle;
+
+    std::set<std::string> jobs_on_path;
+    for (const auto &segment : analysis.segments) {
+      if (segment.kind == BARRIER) {
+        continue;
+      }
+
+      auto &contributor = contributors[segment.job_id];
+      contributor.job_id = segment.job_id;
+      contributor.time += segment.duration;
+      if (jobs_on_path.insert(segment.job_id).second) {
+        contributor.cycles++;
+      }
+    }
+  }
+
+  auto count = static_cast<long>(analyses.size());
+  summary.average_duration = total_duration / count;
+  summary.average_parallelism =
+      total_parallelism / static_cast<double>(analyses.size());
+
+  summary.average_total = {total.work / count, total.scheduling_delay / count,
+                           total.waiting / count, total.idle / count};
+  summary.average_critical_path = {
+      critical_path.work / count, critical_path.scheduling_delay / count,
+      critical_path.waiting / count, critical_path.idle / count};
+
+  for (auto &[id, contributor] : contributors) {
+    summary.top_contributors.push_back(std::move(contributor));
+  }
+
+  std::sort(summary.top_contributors.begin(), summary.top_contributors.end(),
+            [](const auto &a, const auto &b) { return a.time > b.time; });
+  if (summary.top_contributors.size() > max_contributors) {
+    summary.top_contributors.resize(max_contributors);
+  }
+
+  return summary;
+}
+
+static void PrintBreakdown(std::stringstream &ss,
+                           const CycleTimeBreakdown &breakdown) {
+  ss << "work " << ToMilliseconds(breakdown.work) << "ms, scheduling delay "
+     << ToMilliseconds(breakdown.scheduling_delay) << "ms, waiting "
+     << ToMilliseconds(breakdown.waiting) << "ms, idle "
+     << ToMilliseconds(breakdown.idle) << "ms";
+}
+
+std::string CycleAnalysisSummary::ToString() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "critical path analysis of " << cycles << " cycles (" << worker_count
+     << " workers)";
+  ss << "\n  cycle duration: avg " << ToMilliseconds(average_duration)
+     << "ms, max " << ToMilliseconds(max_duration) << "ms";
+  ss << "\n  parallelism: avg " << average_parallelism << " of "
+     << worker_count << " workers";
+  ss << "\n  all workers (avg per cycle): ";
+  PrintBreakdown(ss, average_total);
+  ss << "\n  critical path (avg per cycle): ";
+  PrintBreakdown(ss, average_critical_path);
+
+  ss << "\n  top contributors to critical path:";
+  for (const auto &contributor : top_contributors) {
+    ss << "\n    - '" << contributor.job_id << "' in " << contributor.cycles
+       << " cycles, " << ToMilliseconds(contributor.time) << "ms";
+  }
+
+  return ss.str();
+}
+
+static void PrintBreakdownAsJson(std::stringstream &ss,
+                                 const CycleTimeBreakdown &breakdown) {
+  ss << "{\"work_ms\":" << ToMilliseconds(breakdown.work)
+     << ",\"scheduling_delay_ms\":"
+     << ToMilliseconds(breakdown.scheduling_delay)
+     << ",\"waiting_ms\":" << ToMilliseconds(breakdown.waiting)
+     << ",\"idle_ms\":" << ToMilliseconds(breakdown.idle) << "}";
+}
+
+std::string CycleAnalysisSummary::ToJson() const {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  ss << "{\"cycles\":" << cycles << ",\"workers\":" << worker_count
+     << ",\"average_duration_ms\":" << ToMilliseconds(average_duration)
+     << ",\"max_duration_ms\":" << ToMilliseconds(max_duration)
+     << ",\"average_parallelism\":" << average_parallelism;
+
+  ss << ",\"total\":";
+  PrintBreakdownAsJson(ss, average_total);
+  ss << ",\"critical_path\":";
+  PrintBreakdownAsJson(ss, average_critical_path);
+
+  ss << ",\"top_contributors\":[";
+  for (size_t i = 0; i < top_contributors.size(); i++) {
+    const auto &contributor = top_contributors[i];
+    ss << (i > 0 ? "," : "") << "{\"job\":\""
+       << EscapeJson(contributor.job_id) << "\",\"cycles\":"
+       << contributor.cycles
+       << ",\"time_ms\":" << ToMilliseconds(contributor.time) << "}";
+  }
+  ss << "]}";
+
+  return ss.str();
+}
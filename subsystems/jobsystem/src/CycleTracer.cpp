@@ -0,0 +1,97 @@
+#include "jobsystem/profiling/CycleTracer.h"
+#include "jobsystem/execution/impl/fiber/BoostFiberExecution.h"
+
+using namespace hive::jobsystem;
+using namespace hive::jobsystem::profiling;
+
+// Each job runs in its own fiber, so the trace of the current job is stored
+// fiber-locally. Thread-locals do not work here because fibers can migrate
+// between worker threads while they are suspended.
+static boost::fibers::fiber_specific_ptr<SharedJobTrace> current_trace;
+
+CycleTracer::CycleTracer(size_t window_size, size_t worker_count)
+    : m_window_size(std::max<size_t>(1, window_size)),
+      m_worker_count(worker_count) {}
+
+void CycleTracer::OnStateChanged(size_t cycle, JobManagerState state) {
+  auto now = std::chrono::steady_clock::now();
+
+  std::unique_lock lock(m_current_cycle_mutex);
+  if (m_current_state != READY) {
+    m_current_cycle.phases[m_current_state - CYCLE_INIT].end = now;
+  }
+
+  if (m_current_state == READY && state != READY) {
+    m_current_cycle = CycleTrace();
+    m_current_cycle.cycle = cycle;
+    m_current_cycle.begin = now;
+  }
+
+  if (state != READY) {
+    m_current_cycle.phases[state - CYCLE_INIT].begin = now;
+  }
+
+  bool has_cycle_finished = m_current_state != READY && state == READY;
+  m_current_state = state;
+
+  if (has_cycle_finished) {
+    FinishCycle(now);
+  }
+}
+
+void CycleTracer::FinishCycle(trace_time_point now) {
+  m_current_cycle.end = now;
+  auto analysis =
+      CriticalPathAnalyzer::Analyze(m_current_cycle, m_worker_count);
+
+  // traces of finished cycles are not needed anymore
+  m_current_cycle.jobs.clear();
+
+  std::unique_lock lock(m_window_mutex);
+  m_window.push_back(std::move(analysis));
+  while (m_window.size() > m_window_size) {
+    m_window.pop_front();
+  }
+}
+
+SharedJobTrace CycleTracer::OnJobScheduled(const SharedJob &job) {
+  auto trace = std::make_shared<JobTrace>();
+  trace->id = job->GetId();
+  trace->phase = job->GetPhase();
+  trace->spawned_by = GetCurrentTrace();
+  trace->scheduled = std::chrono::steady_clock::now();
+
+  std::unique_lock lock(m_current_cycle_mutex);
+  m_current_cycle.jobs.push_back(trace);
+  return trace;
+}
+
+std::optional<CycleAnalysis> CycleTracer::GetLastCycleAnalysis() const {
+  std::unique_lock lock(m_window_mutex);
+  if (m_window.empty()) {
+    return {};
+  }
+  return m_window.back();
+}
+
+CycleAnalysisSummary CycleTracer::GetSummary() const {
+  std::unique_lock lock(m_window_mutex);
+  return CriticalPathAnalyzer::Summarize(m_window, m_worker_count);
+}
+
+SharedJobTrace CycleTracer::GetCurrentTrace() {
+  if (!execution::impl::IsExecutedByFiber()) {
+    return nullptr;
+  }
+
+  SharedJobTrace *trace = current_trace.get();
+  return trace ? *trace : nullptr;
+}
+
+void CycleTracer::SetCurrentTrace(const SharedJobTrace &trace) {
+  if (!execution::impl::IsExecutedByFiber()) {
+    return;
+  }
+
+  current_trace.reset(trace ? new SharedJobTrace(trace) : nullptr);
+}
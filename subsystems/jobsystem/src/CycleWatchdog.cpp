@@ -0,0 +1,125 @@
+#include "jobsystem/manager/CycleWatchdog.h"
+#include "logging/LogManager.h"
+#include <algorithm>
+
+using namespace hive::jobsystem;
+
+CycleWatchdog::CycleWatchdog(std::chrono::milliseconds phase_budget,
+                             std::chrono::milliseconds check_interval)
+    : m_phase_budget(phase_budget), m_check_interval(check_interval) {
+  m_thread = std::thread(&CycleWatchdog::Run, this);
+}
+
+CycleWatchdog::~CycleWatchdog() {
+  {
+    std::unique_lock lock(m_sleep_mutex);
+    m_running = false;
+  }
+  m_sleep_condition.notify_all();
+  m_thread.join();
+}
+
+void CycleWatchdog::Run() {
+  std::unique_lock lock(m_sleep_mutex);
+  while (m_running) {
+    m_sleep_condition.wait_for(lock, m_check_interval,
+                               [this]() { return !m_running; });
+    if (!m_running) {
+      break;
+    }
+
+    lock.unlock();
+    Check();
+    lock.lock();
+  }
+}
+
+void CycleWatchdog::OnPhaseStarted(size_t cycle, JobManagerState phase) {
+  std::unique_lock lock(m_phase_mutex);
+  m_cycle = cycle;
+  m_phase = phase;
+  m_phase_start = std::chrono::steady_clock::now();
+  m_phase_reported = false;
+  m_phase_jobs.clear();
+}
+
+void CycleWatchdog::OnJobScheduled(const SharedJob &job) {
+  std::unique_lock lock(m_phase_mutex);
+  m_phase_jobs.push_back(job);
+}
+
+void CycleWatchdog::OnCycleFinished() {
+  std::unique_lock lock(m_phase_mutex);
+  m_phase = READY;
+  m_phase_jobs.clear();
+}
+
+std::optional<StallReport> CycleWatchdog::Check() {
+  auto now = std::chrono::steady_clock::now();
+
+  StallReport report;
+  {
+    std::unique_lock lock(m_phase_mutex);
+    if (m_phase == READY || m_phase_reported) {
+      return {};
+    }
+
+    auto phase_elapsed = now - m_phase_start;
+    if (phase_elapsed <= m_phase_budget) {
+      return {};
+    }
+
+    m_phase_reported = true;
+    report.cycle = m_cycle;
+    report.phase = m_phase;
+    report.phase_elapsed = phase_elapsed;
+    report.budget = m_phase_budget;
+
+    for (const auto &job : m_phase_jobs) {
+      auto state = job->GetState();
+      bool is_unfinished = state == AWAITING_EXECUTION ||
+                           state == IN_EXECUTION || state == QUEUED;
+      if (!is_unfinished) {
+        continue;
+      }
+
+      StalledJobInfo info{job->GetId(), state, {}, {}};
+      if (state == IN_EXECUTION) {
+        info.elapsed = now - job->GetExecutionStartTime();
+        info.worker = job->GetWorkerThreadId();
+      }
+      report.unfinished_jobs.push_back(std::move(info));
+    }
+  }
+
+  std::sort(report.unfinished_jobs.begin(), report.unfinished_jobs.end(),
+            [](const StalledJobInfo &a, const StalledJobInfo &b) {
+              return a.elapsed > b.elapsed;
+            });
+
+  LOG_WARN(report.ToString())
+
+  std::function<void(const StallReport &)> handler;
+  {
+    std::unique_lock lock(m_report_mutex);
+    m_last_report = report;
+    handler = m_stall_handler;
+  }
+
+  if (handler) {
+    handler(report);
+  }
+
+  return report;
+}
+
+void CycleWatchdog::SetStallHandler(
+    std::function<void(const StallReport &)> handler) {
+  std::unique_lock lock(m_report_mutex);
+  m_stall_handler = std::move(handler);
+}
+
+std::optional<StallReport> CycleWatchdog::GetLastStallReport() const {
+  std::unique_lock lock(m_report_mutex);
+  return m_last_report;
+}
@@ -1,4 +1,5 @@
 #include "jobsystem/jobs/Job.h"
+#include "jobsystem/profiling/CycleTracer.h"
 #include "logging/LogManager.h"
 #include <chrono>
 
@@ -16,7 +17,16 @@ JobContinuation Job::Execute(JobContext *context) {
 #ifdef ENABLE_PROFILING
   common::profiling::Timer job_execution_timer("job-execution-" + m_id);
 #endif
+  m_execution_start = std::chrono::steady_clock::now();
+  m_worker = std::this_thread::get_id();
   m_current_state = IN_EXECUTION;
+
+  if (m_trace) {
+    m_trace->started = m_execution_start;
+    m_trace->worker = m_worker;
+    profiling::CycleTracer::SetCurrentTrace(m_trace);
+  }
+
   JobContinuation continuation;
   try {
 
@@ -48,6 +58,12 @@ JobContinuation Job::Execute(JobContext *context) {
     continuation = DISPOSE;
   }
 
+  if (m_trace) {
+    profiling::CycleTracer::SetCurrentTrace(nullptr);
+    m_trace->finished = std::chrono::steady_clock::now();
+    m_trace->completed = true;
+  }
+
   return continuation;
 }
 
@@ -67,6 +83,15 @@ void Job::FinishJob() {
   while (!m_counters.empty()) {
     auto counter = m_counters.front();
     m_counters.pop();
+
+    // allows jobs waiting for this counter to trace what they waited for
+    if (m_trace) {
+      counter->SetLastFinishedJob(m_trace);
+    }
+
     counter->Decrease();
   }
+
+  // the trace belonged to the finished execution only
+  m_trace = nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#include "jobsystem/manager/JobCategoryLimiter.h"
+#include "common/assert/Assert.h"
+#include "logging/LogManager.h"
+#include <algorithm>
+
+using namespace hive::jobsystem;
+
+static double GetBucketCapacity(const JobCategoryLimits &limits) {
+  return std::max(1.0, limits.burst > 0 ? limits.burst : limits.rate);
+}
+
+JobCategoryLimiter::JobCategoryLimiter(
+    common::config::SharedConfiguration config)
+    : m_config(std::move(config)) {}
+
+JobCategoryLimiter::Category &
+JobCategoryLimiter::GetOrCreateCategory(const std::string &name) {
+  auto iterator = m_categories.find(name);
+  if (iterator != m_categories.end()) {
+    return iterator->second;
+  }
+
+  std::string prefix = "jobs.categories." + name;
+  JobCategoryLimits limits;
+  limits.max_concurrency = static_cast<size_t>(
+      std::max(0, m_config->GetAsInt(prefix + ".max-concurrency", 0)));
+  limits.rate = std::max(0.f, m_config->GetAsFloat(prefix + ".rate", 0));
+  limits.burst = std::max(0.f, m_config->GetAsFloat(prefix + ".burst", 0));
+
+  Category category;
+  category.limits = limits;
+  category.tokens = GetBucketCapacity(limits);
+  category.last_refill = std::chrono::steady_clock::now();
+
+  if (limits.max_concurrency > 0 || limits.rate > 0) {
+    LOG_DEBUG("job category '" << name << "' is limited to "
+                               << limits.max_concurrency
+                               << " concurrent jobs and " << limits.rate
+                               << " jobs per second")
+  }
+
+  return m_categories.emplace(name, std::move(category)).first->second;
+}
+
+void JobCategoryLimiter::Refill(Category &category) {
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed = now - category.last_refill;
+  category.last_refill = now;
+
+  category.tokens =
+      std::min(GetBucketCapacity(category.limits),
+               category.tokens + elapsed.count() * category.limits.rate);
+}
+
+void JobCategoryLimiter::SetLimits(const std::string &category,
+                                   const JobCategoryLimits &limits) {
+  std::unique_lock lock(m_categories_mutex);
+  auto &existing_category = GetOrCreateCategory(category);
+  existing_category.limits = limits;
+
+  // new limits start with a full bucket
+  existing_category.tokens = GetBucketCapacity(limits);
+  existing_category.last_refill = std::chrono::steady_clock::now();
+}
+
+JobCategoryLimits JobCategoryLimiter::GetLimits(const std::string &category) {
+  std::unique_lock lock(m_categories_mutex);
+  return GetOrCreateCategory(category).limits;
+}
+
+bool JobCategoryLimiter::TryConsumeToken(const SharedJob &job) {
+  const auto &name = job->GetCategory();
+  if (name.empty()) {
+    return true /* because uncategorized jobs are not limited */;
+  }
+
+  std::unique_lock lock(m_categories_mutex);
+  auto &category = GetOrCreateCategory(name);
+  if (category.limits.rate <= 0) {
+    return true;
+  }
+
+  Refill(category);
+  if (category.tokens < 1) {
+    return false;
+  }
+
+  category.tokens -= 1;
+  return true;
+}
+
+bool JobCategoryLimiter::TryAcquireSlot(const SharedJob &job) {
+  const auto &name = job->GetCategory();
+  if (name.empty()) {
+    return true /* because uncategorized jobs are not limited */;
+  }
+
+  // Asynchronous jobs might run for many cycles. Held synchronous jobs of
+  // their category would keep the phase from completing all that time.
+  if (job->IsAsync()) {
+    return true;
+  }
+
+  std::unique_lock lock(m_categories_mutex);
+  auto &category = GetOrCreateCategory(name);
+
+  // held jobs are first in line, so they must not be overtaken
+  bool has_free_slot = category.limits.max_concurrency == 0 ||
+                       category.running < category.limits.max_concurrency;
+  if (has_free_slot && category.held_jobs.empty()) {
+    category.running++;
+    return true;
+  }
+
+  category.held_jobs.push(job);
+  return false;
+}
+
+SharedJob JobCategoryLimiter::ReleaseSlot(const SharedJob &job) {
+  const auto &name = job->GetCategory();
+  if (name.empty() || job->IsAsync()) {
+    return nullptr /* because the job has not acquired a slot */;
+  }
+
+  std::unique_lock lock(m_categories_mutex);
+  auto &category = GetOrCreateCategory(name);
+  DEBUG_ASSERT(category.running > 0,
+               "job category slot released more often than acquired")
+  category.running--;
+
+  bool has_free_slot = category.limits.max_concurrency == 0 ||
+                       category.running < category.limits.max_concurrency;
+  if (!has_free_slot || category.held_jobs.empty()) {
+    return nullptr;
+  }
+
+  auto next_job = category.held_jobs.front();
+  category.held_jobs.pop();
+  category.running++;
+  return next_job;
+}
+
+size_t JobCategoryLimiter::GetHeldJobCount(const std::string &category) const {
+  std::unique_lock lock(m_categories_mutex);
+  auto iterator = m_categories.find(category);
+  if (iterator == m_categories.end()) {
+    return 0;
+  }
+  return iterator->second.held_jobs.size();
+}
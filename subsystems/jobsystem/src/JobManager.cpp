@@ -2,13 +2,35 @@
 #include "boost/core/demangle.hpp"
 #include "common/profiling/Timer.h"
 #include "logging/LogManager.h"
+#include <algorithm>
 #include <sstream>
 
 using namespace hive::jobsystem;
 using namespace std::chrono_literals;
 
 JobManager::JobManager(const common::config::SharedConfiguration &config)
-    : m_config(config), m_execution(config) {
+    : m_config(config), m_execution(config), m_category_limiter(config) {
+  // a phase budget of 0 disables the watchdog
+  int phase_budget_ms = config->GetAsInt("jobs.watchdog.phase-budget-ms", 0);
+  if (phase_budget_ms > 0) {
+    int check_interval_ms = config->GetAsInt("jobs.watchdog.interval-ms",
+                                             std::max(1, phase_budget_ms / 4));
+    m_watchdog = std::make_unique<CycleWatchdog>(
+        std::chrono::milliseconds(phase_budget_ms),
+        std::chrono::milliseconds(check_interval_ms));
+    LOG_DEBUG("cycle watchdog enabled with a phase budget of "
+              << phase_budget_ms << "ms")
+  }
+
+  if (config->GetBool("jobs.analysis.enabled", false)) {
+    int window_size = config->GetAsInt("jobs.analysis.window", 100);
+    int worker_count = config->GetAsInt("jobs.concurrency", 4);
+    m_tracer = std::make_unique<profiling::CycleTracer>(window_size,
+                                                        worker_count);
+    LOG_DEBUG("critical path analysis enabled over a window of "
+              << window_size << " cycles")
+  }
+
 #ifndef NDEBUG
   auto stats_job = std::make_shared<TimerJob>(
       [&](JobContext *) {
@@ -135,19 +157,60 @@ void JobManager::ScheduleAllJobsInQueue(std::queue<SharedJob> &queue,
       continue;
     }
 
+    // jobs of noisy categories are deferred instead of dropped
+    if (!m_category_limiter.TryConsumeToken(job)) {
+      KickJobForNextCycle(job);
+      continue;
+    }
+
     // some jobs are long-running and should not be waited for
     bool cycle_should_wait_for_completion = !job->IsAsync();
     if (cycle_should_wait_for_completion) {
       job->AddCounter(counter);
     }
 
-    m_execution.Schedule(job);
+    // let the watchdog know the job before it can start running
+    if (m_watchdog && cycle_should_wait_for_completion) {
+      m_watchdog->OnJobScheduled(job);
+    }
+
+    // only jobs the cycle waits for can be part of its critical path
+    if (m_tracer && cycle_should_wait_for_completion) {
+      job->SetTrace(m_tracer->OnJobScheduled(job));
+    }
+
+    // the limiter keeps the job until its category has a free slot
+    if (!m_category_limiter.TryAcquireSlot(job)) {
+      continue;
+    }
+
+    ScheduleJob(job);
+  }
+}
+
+void JobManager::ScheduleJob(const SharedJob &job) {
+  m_execution.Schedule(job);
 #ifndef NDEBUG
-    m_job_execution_counter++;
+  m_job_execution_counter++;
 #endif
+}
+
+void JobManager::OnJobExecuted(const SharedJob &job) {
+  // the held job has already been counted by the phase it was kicked in
+  if (auto next_job = m_category_limiter.ReleaseSlot(job)) {
+    ScheduleJob(next_job);
   }
 }
 
+void JobManager::SetJobCategoryLimits(const std::string &category,
+                                      const JobCategoryLimits &limits) {
+  m_category_limiter.SetLimits(category, limits);
+}
+
+size_t JobManager::GetHeldJobCount(const std::string &category) const {
+  return m_category_limiter.GetHeldJobCount(category);
+}
+
 void JobManager::ExecuteQueueAndWait(std::queue<SharedJob> &queue,
                                      recursive_mutex &queue_mutex,
                                      const SharedJobCounter &counter) {
@@ -170,6 +233,23 @@ void JobManager::ResetContinuationRequeueBlacklist() {
   m_continuation_requeue_blacklist.clear();
 }
 
+void JobManager::SetCurrentState(JobManagerState state) {
+  std::unique_lock lock(m_current_state_mutex);
+  m_current_state = state;
+
+  if (m_watchdog) {
+    if (state == READY) {
+      m_watchdog->OnCycleFinished();
+    } else {
+      m_watchdog->OnPhaseStarted(m_total_cycle_count, state);
+    }
+  }
+
+  if (m_tracer) {
+    m_tracer->OnStateChanged(m_total_cycle_count, state);
+  }
+}
+
 void JobManager::InvokeCycleAndWait() {
 #ifdef ENABLE_PROFILING
   common::profiling::Timer cycle_timer("job-cycles");
@@ -195,29 +275,17 @@ void JobManager::InvokeCycleAndWait() {
   m_clean_up_phase_counter = std::make_shared<JobCounter>();
 
   // pass different phases consecutively to the execution
-  {
-    std::unique_lock lock(m_current_state_mutex);
-    m_current_state = CYCLE_INIT;
-  }
+  SetCurrentState(CYCLE_INIT);
   ExecuteQueueAndWait(m_init_queue, m_init_queue_mutex, m_init_phase_counter);
 
-  {
-    std::unique_lock lock(m_current_state_mutex);
-    m_current_state = CYCLE_MAIN;
-  }
+  SetCurrentState(CYCLE_MAIN);
   ExecuteQueueAndWait(m_main_queue, m_main_queue_mutex, m_main_phase_counter);
 
-  {
-    std::unique_lock lock(m_current_state_mutex);
-    m_current_state = CYCLE_CLEAN_UP;
-  }
+  SetCurrentState(CYCLE_CLEAN_UP);
   ExecuteQueueAndWait(m_clean_up_queue, m_clean_up_queue_mutex,
                       m_clean_up_phase_counter);
 
-  {
-    std::unique_lock lock(m_current_state_mutex);
-    m_current_state = READY;
-  }
+  SetCurrentState(READY);
 
   ResetContinuationRequeueBlacklist();
 #ifndef NDEBUG
@@ -282,5 +350,38 @@ void JobManager::DetachJob(const std::string &job_id) {
   tryRemoveJobWithIdFromQueue(job_id, m_clean_up_queue, m_clean_up_queue_mutex);
 }
 
+void JobManager::SetStallReportHandler(
+    std::function<void(const StallReport &)> handler) {
+  if (m_watchdog) {
+    m_watchdog->SetStallHandler(std::move(handler));
+  } else {
+    LOG_WARN("stall report handler has no effect because the cycle watchdog "
+             "is disabled (see 'jobs.watchdog.phase-budget-ms')")
+  }
+}
+
+std::optional<StallReport> JobManager::GetLastStallReport() const {
+  if (m_watchdog) {
+    return m_watchdog->GetLastStallReport();
+  }
+  return {};
+}
+
+std::optional<profiling::CycleAnalysis>
+JobManager::GetLastCycleAnalysis() const {
+  if (m_tracer) {
+    return m_tracer->GetLastCycleAnalysis();
+  }
+  return {};
+}
+
+std::optional<profiling::CycleAnalysisSummary>
+JobManager::GetCycleAnalysisSummary() const {
+  if (m_tracer) {
+    return m_tracer->GetSummary();
+  }
+  return {};
+}
+
 void JobManager::StartExecution() { m_execution.Start(BorrowFromThis()); }
 void JobManager::StopExecution() { m_execution.Stop(); }
@@ -0,0 +1,60 @@
+#include "jobsystem/manager/StallReport.h"
+#include <sstream>
+
+using namespace hive::jobsystem;
+
+const char *hive::jobsystem::ToString(JobManagerState state) {
+  switch (state) {
+  case READY:
+    return "READY";
+  case CYCLE_INIT:
+    return "INIT";
+  case CYCLE_MAIN:
+    return "MAIN";
+  case CYCLE_CLEAN_UP:
+    return "CLEAN_UP";
+  }
+  return "UNKNOWN";
+}
+
+const char *hive::jobsystem::ToString(JobState state) {
+  switch (state) {
+  case DETACHED:
+    return "DETACHED";
+  case QUEUED:
+    return "QUEUED";
+  case RESERVED_FOR_NEXT_CYCLE:
+    return "RESERVED_FOR_NEXT_CYCLE";
+  case AWAITING_EXECUTION:
+    return "AWAITING_EXECUTION";
+  case IN_EXECUTION:
+    return "IN_EXECUTION";
+  case EXECUTION_FINISHED:
+    return "EXECUTION_FINISHED";
+  case FAILED:
+    return "FAILED";
+  }
+  return "UNKNOWN";
+}
+
+std::string StallReport::ToString() const {
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+
+  std::stringstream ss;
+  ss << "phase " << jobsystem::ToString(phase) << " of cycle " << cycle
+     << " stalled: running for "
+     << duration_cast<milliseconds>(phase_elapsed).count() << "ms (budget "
+     << duration_cast<milliseconds>(budget).count() << "ms), waiting for "
+     << unfinished_jobs.size() << " job(s)";
+
+  for (const auto &job : unfinished_jobs) {
+    ss << "\n  - '" << job.id << "' " << jobsystem::ToString(job.state);
+    if (job.state == IN_EXECUTION) {
+      ss << " for " << duration_cast<milliseconds>(job.elapsed).count()
+         << "ms on worker " << job.worker;
+    }
+  }
+
+  return ss.str();
+}
@@ -1,6 +1,8 @@
 #include "common/test/TryAssertUntilTimeout.h"
 #include "jobsystem/manager/JobManager.h"
+#include "jobsystem/synchronization/JobChannel.h"
 #include "jobsystem/synchronization/JobMutex.h"
+#include <algorithm>
 #include <boost/atomic/atomic.hpp>
 #include <future>
 #include <gtest/gtest.h>
@@ -468,6 +470,285 @@ TEST(JobSystem, async_jobs) {
   manager->StopExecution();
 }
 
+TEST(JobSystem, watchdog_reports_stalling_phase) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("jobs.watchdog.phase-budget-ms", 100);
+  config->Set("jobs.watchdog.interval-ms", 10);
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  std::atomic_size_t reports = 0;
+  manager->SetStallReportHandler(
+      [&reports](const StallReport &) { reports++; });
+
+  auto quick_job = std::make_shared<Job>(
+      [](JobContext *) { return JobContinuation::DISPOSE; }, "quick-job");
+  auto stalling_job = std::make_shared<Job>(
+      [](JobContext *) {
+        std::this_thread::sleep_for(500ms);
+        return JobContinuation::DISPOSE;
+      },
+      "stalling-job");
+
+  manager->KickJob(quick_job);
+  manager->KickJob(stalling_job);
+  manager->InvokeCycleAndWait();
+
+  auto report = manager->GetLastStallReport();
+  ASSERT_TRUE(report.has_value());
+  ASSERT_EQ(1, reports);
+  ASSERT_EQ(CYCLE_MAIN, report->phase);
+
+  auto &jobs = report->unfinished_jobs;
+  auto stalled_job = std::find_if(jobs.begin(), jobs.end(), [](auto &job) {
+    return job.id == "stalling-job";
+  });
+  ASSERT_NE(jobs.end(), stalled_job);
+  ASSERT_EQ(IN_EXECUTION, stalled_job->state);
+  ASSERT_GT(stalled_job->elapsed, 0ms);
+  ASSERT_NE(std::thread::id(), stalled_job->worker);
+
+  // cycles that stay within budget are not reported
+  manager->InvokeCycleAndWait();
+  ASSERT_EQ(1, reports);
+
+  manager->StopExecution();
+}
+
+TEST(JobSystem, critical_path_follows_wait_for_completion) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("jobs.analysis.enabled", true);
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  auto parent_job = std::make_shared<Job>(
+      [](JobContext *context) {
+        auto counter = std::make_shared<JobCounter>();
+        auto child_job = std::make_shared<Job>(
+            [](JobContext *) {
+              std::this_thread::sleep_for(50ms);
+              return JobContinuation::DISPOSE;
+            },
+            "child-job");
+        child_job->AddCounter(counter);
+        context->GetJobManager()->KickJob(child_job);
+        context->GetJobManager()->WaitForCompletion(counter);
+        return JobContinuation::DISPOSE;
+      },
+      "parent-job");
+
+  manager->KickJob(parent_job);
+  manager->InvokeCycleAndWait();
+
+  auto analysis = manager->GetLastCycleAnalysis();
+  ASSERT_TRUE(analysis.has_value());
+  ASSERT_EQ(2, analysis->job_count);
+
+  // the critical path covers the entire cycle
+  std::chrono::nanoseconds path_length{0};
+  for (const auto &segment : analysis->segments) {
+    path_length += segment.duration;
+  }
+  ASSERT_EQ(analysis->duration, path_length);
+
+  // the parent waited for its child, so the child's work is on the path
+  auto child_work = std::find_if(
+      analysis->segments.begin(), analysis->segments.end(), [](auto &segment) {
+        return segment.job_id == "child-job" &&
+               segment.kind == profiling::WORK;
+      });
+  ASSERT_NE(analysis->segments.end(), child_work);
+  ASSERT_GE(child_work->duration, 50ms);
+  ASSERT_GE(analysis->critical_path.work, 50ms);
+
+  auto summary = manager->GetCycleAnalysisSummary();
+  ASSERT_TRUE(summary.has_value());
+  ASSERT_EQ(1, summary->cycles);
+  ASSERT_EQ("child-job", summary->top_contributors.at(0).job_id);
+
+  manager->StopExecution();
+}
+
+TEST(JobSynchronization, channel_passes_values_between_jobs) {
+  auto config = std::make_shared<common::config::Configuration>();
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  // the channel is much smaller than the amount of values, so the producer
+  // has to wait for the consumer
+  auto channel = std::make_shared<JobChannel<int>>(4);
+  std::atomic_int sum = 0;
+  std::atomic_int received = 0;
+
+  auto producer = std::make_shared<Job>(
+      [channel](JobContext *) {
+        for (int i = 1; i <= 100; i++) {
+          channel->Send(i);
+        }
+        channel->Close();
+        return JobContinuation::DISPOSE;
+      },
+      "producer-job");
+
+  auto consumer = std::make_shared<Job>(
+      [channel, &sum, &received](JobContext *) {
+        std::vector<int> batch;
+        while (channel->ReceiveBatch(batch, 8) > 0) {
+          for (int value : batch) {
+            sum += value;
+            received++;
+          }
+          batch.clear();
+        }
+        return JobContinuation::DISPOSE;
+      },
+      "consumer-job");
+
+  manager->KickJob(consumer);
+  manager->KickJob(producer);
+  manager->InvokeCycleAndWait();
+
+  ASSERT_EQ(100, received);
+  ASSERT_EQ(5050, sum);
+  ASSERT_TRUE(channel->IsClosed());
+
+  manager->StopExecution();
+}
+
+TEST(JobSynchronization, channel_close_semantics) {
+  JobChannel<int> channel(2);
+  ASSERT_EQ(CHANNEL_SUCCESS, channel.TrySend(1));
+  ASSERT_EQ(CHANNEL_SUCCESS, channel.TrySend(2));
+  ASSERT_EQ(CHANNEL_FULL, channel.TrySend(3));
+
+  channel.Close();
+  ASSERT_EQ(CHANNEL_CLOSED, channel.Send(4));
+
+  // buffered values can still be received after closing
+  int value;
+  ASSERT_EQ(CHANNEL_SUCCESS, channel.Receive(value));
+  ASSERT_EQ(1, value);
+  ASSERT_EQ(CHANNEL_SUCCESS, channel.TryReceive(value));
+  ASSERT_EQ(2, value);
+  ASSERT_EQ(CHANNEL_CLOSED, channel.Receive(value));
+  ASSERT_EQ(CHANNEL_CLOSED, channel.TryReceive(value));
+}
+
+TEST(JobSystem, job_category_limits_concurrency) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("jobs.categories.noisy.max-concurrency", 1);
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  int job_count = 10;
+  std::atomic_int running = 0;
+  std::atomic_int max_running = 0;
+  std::atomic_int executed = 0;
+  for (int i = 0; i < job_count; i++) {
+    auto job = std::make_shared<Job>(
+        [&](JobContext *context) {
+          int now_running = ++running;
+          int expected = max_running;
+          while (now_running > expected &&
+                 !max_running.compare_exchange_weak(expected, now_running)) {
+          }
+
+          context->GetJobManager()->WaitForDuration(5ms);
+          running--;
+          executed++;
+          return JobContinuation::DISPOSE;
+        },
+        "noisy-job-" + std::to_string(i));
+    job->SetCategory("noisy");
+    manager->KickJob(job);
+  }
+
+  // held back jobs are still executed in the same cycle
+  manager->InvokeCycleAndWait();
+  ASSERT_EQ(job_count, executed);
+  ASSERT_EQ(1, max_running);
+  ASSERT_EQ(0, manager->GetHeldJobCount("noisy"));
+
+  manager->StopExecution();
+}
+
+TEST(JobSystem, job_category_limits_ignore_async_jobs) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("jobs.categories.noisy.max-concurrency", 1);
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  std::atomic_bool released = false;
+  SharedJob async_job = std::make_shared<Job>(
+      [&released](JobContext *context) {
+        while (!released) {
+          std::this_thread::sleep_for(1ms);
+        }
+        return JobContinuation::DISPOSE;
+      },
+      "noisy-async-job", MAIN, true);
+  async_job->SetCategory("noisy");
+
+  std::atomic_int executed = 0;
+  SharedJob job = std::make_shared<Job>(
+      [&executed](JobContext *) {
+        executed++;
+        return JobContinuation::DISPOSE;
+      },
+      "noisy-job");
+  job->SetCategory("noisy");
+
+  manager->KickJob(async_job);
+  manager->KickJob(job);
+
+  // the long-running asynchronous job must not hold back the cycle
+  auto cycle = std::async(std::launch::async,
+                          [&manager]() { manager->InvokeCycleAndWait(); });
+  bool cycle_completed = cycle.wait_for(5s) == std::future_status::ready;
+  released = true;
+  cycle.wait();
+
+  ASSERT_TRUE(cycle_completed);
+  ASSERT_EQ(1, executed);
+  ASSERT_EQ(0, manager->GetHeldJobCount("noisy"));
+
+  manager->StopExecution();
+}
+
+TEST(JobSystem, job_category_rate_defers_jobs) {
+  auto config = std::make_shared<common::config::Configuration>();
+  auto manager = common::memory::Owner<JobManager>(config);
+  manager->StartExecution();
+
+  JobCategoryLimits limits;
+  limits.rate = 0.001;
+  limits.burst = 2;
+  manager->SetJobCategoryLimits("noisy", limits);
+
+  std::atomic_int executed = 0;
+  for (int i = 0; i < 3; i++) {
+    auto job = std::make_shared<Job>(
+        [&](JobContext *) {
+          executed++;
+          return JobContinuation::DISPOSE;
+        },
+        "noisy-job-" + std::to_string(i));
+    job->SetCategory("noisy");
+    manager->KickJob(job);
+  }
+
+  // only the burst is executed, the remaining job is deferred (not dropped)
+  manager->InvokeCycleAndWait();
+  ASSERT_EQ(2, executed);
+
+  limits.rate = 0;
+  manager->SetJobCategoryLimits("noisy", limits);
+  manager->InvokeCycleAndWait();
+  ASSERT_EQ(3, executed);
+
+  manager->StopExecution();
+}
+
 int main(int argc, char **argv) {
 
   ::testing::InitGoogleTest(&argc, argv);
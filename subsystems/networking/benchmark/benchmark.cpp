@@ -0,0 +1,776 @@
+#include "data/DataLayer.h"
+#include "events/broker/impl/JobBasedEventBroker.h"
+#include "networking/NetworkingManager.h"
+#include "networking/messaging/BinaryMessageConverter.h"
+#include "networking/messaging/MessageConverter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace hive;
+using namespace hive::networking;
+using namespace hive::networking::messaging;
+using namespace std::chrono_literals;
+
+/**
+ * Result of a single benchmark run. Parameters describe the scenario, metrics
+ * contain the measurements. Both are written as JSON, so results of different
+ * builds can be compared.
+ */
+struct BenchmarkResult {
+  std::string name;
+  std::vector<std::pair<std::string, std::string>> parameters;
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+static std::vector<BenchmarkResult> s_results;
+
+static void WriteJson(std::ostream &out,
+                      const std::vector<BenchmarkResult> &results) {
+  out << "{\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &result = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name
+        << "\", \"parameters\": {";
+    for (size_t j = 0; j < result.parameters.size(); j++) {
+      out << (j == 0 ? "" : ", ") << "\"" << result.parameters[j].first
+          << "\": \"" << result.parameters[j].second << "\"";
+    }
+    out << "}, \"metrics\": {";
+    for (size_t j = 0; j < result.metrics.size(); j++) {
+      out << (j == 0 ? "" : ", ") << "\"" << result.metrics[j].first
+          << "\": " << result.metrics[j].second;
+    }
+    out << "}}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+/**
+ * Measures the average duration of an operation.
+ * @param iterations count of times the operation is executed
+ * @param operation operation to measure (receives the iteration index)
+ * @return average duration of a single operation in nanoseconds
+ */
+static double Measure(size_t iterations,
+                      const std::function<void(size_t)> &operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    operation(i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() /
+         static_cast<double>(iterations);
+}
+
+/**
+ * Creates a message resembling a render result: some small attributes
+ * describing it and a single large binary blob.
+ * @param payload_size size of the blob in bytes
+ * @param type type of the message
+ * @return message
+ */
+static SharedMessage CreateMessage(size_t payload_size,
+                                   const std::string &type = "render-result") {
+  auto message = std::make_shared<Message>(type);
+  message->SetAttribute("width", "1920");
+  message->SetAttribute("height", "1080");
+  message->SetAttribute("format", "rgba8");
+
+  std::string blob(payload_size, '\0');
+  for (size_t i = 0; i < payload_size; i++) {
+    blob[i] = static_cast<char>(i * 31 % 251);
+  }
+  message->SetAttribute("data", std::move(blob));
+  return message;
+}
+
+/**
+ * Measures encoding and decoding of a message in the given wire format.
+ * @param format wire format to measure
+ * @param payload_size size of the message's blob in bytes
+ */
+static void BenchmarkConverter(WireFormat format, size_t payload_size) {
+  auto message = CreateMessage(payload_size);
+
+  // large payloads take long, so they are converted less often
+  size_t iterations = std::max<size_t>(10, (64 * 1024 * 1024) / payload_size);
+  iterations = std::min<size_t>(iterations, 10000);
+
+  // received payloads are shared, so attributes can reference them
+  SharedPayload payload = std::make_shared<const std::string>(
+      MessageConverter::ToWireFormat(message, format));
+  double encode_ns = Measure(iterations, [&message, format](size_t) {
+    auto encoded = MessageConverter::ToWireFormat(message, format);
+  });
+  double decode_ns = Measure(iterations, [&payload](size_t) {
+    auto decoded = MessageConverter::FromWireFormat(payload);
+  });
+
+  double bytes = static_cast<double>(payload_size);
+  s_results.push_back(
+      {"converter",
+       {{"format", GetWireFormatName(format)},
+        {"payload_bytes", std::to_string(payload_size)}},
+       {{"encode_ns", encode_ns},
+        {"decode_ns", decode_ns},
+        {"encode_mb_per_s", bytes / encode_ns * 1e3},
+        {"decode_mb_per_s", bytes / decode_ns * 1e3},
+        {"wire_bytes", static_cast<double>(payload->size())}}});
+}
+
+/**
+ * Node with its own subsystems, which communicates over the loopback device.
+ */
+struct BenchmarkNode {
+  std::string id;
+  common::memory::Reference<NetworkingManager> networking_manager;
+  common::memory::Owner<common::subsystems::SubsystemManager> subsystems;
+  common::memory::Reference<jobsystem::JobManager> job_manager;
+};
+
+static BenchmarkNode
+SetupNode(size_t port, const common::config::SharedConfiguration &config) {
+  config->Set("net.port", port);
+  auto subsystems =
+      common::memory::Owner<common::subsystems::SubsystemManager>();
+
+  auto job_manager = common::memory::Owner<jobsystem::JobManager>(config);
+  job_manager->StartExecution();
+  auto job_manager_ref = job_manager.CreateReference();
+  subsystems->AddOrReplaceSubsystem<jobsystem::JobManager>(
+      std::move(job_manager));
+
+  auto event_broker =
+      common::memory::Owner<events::brokers::JobBasedEventBroker>(
+          subsystems.CreateReference());
+  subsystems->AddOrReplaceSubsystem<events::IEventBroker>(
+      std::move(event_broker));
+
+  auto data_layer = common::memory::Owner<data::DataLayer>(subsystems.Borrow());
+  subsystems->AddOrReplaceSubsystem<data::DataLayer>(std::move(data_layer));
+
+  auto networking_manager = common::memory::Owner<NetworkingManager>(
+      subsystems.CreateReference(), config);
+  auto networking_manager_ref = networking_manager.CreateReference();
+  subsystems->AddOrReplaceSubsystem<NetworkingManager>(
+      std::move(networking_manager));
+
+  std::string id = subsystems->RequireSubsystem<data::DataLayer>()
+                       ->Get("net.node.id")
+                       .get()
+                       .value();
+
+  return BenchmarkNode{id, networking_manager_ref, std::move(subsystems),
+                       job_manager_ref};
+}
+
+/**
+ * Counts received messages and their payload.
+ */
+class CountingConsumer : public IMessageConsumer {
+public:
+  std::atomic<size_t> messages{0};
+  std::atomic<size_t> bytes{0};
+
+  std::string GetMessageType() const override { return "render-result"; }
+
+  void ProcessReceivedMessage(SharedMessage received_message,
+                              ConnectionInfo connection_info) override {
+    // a copy of the payload would dominate the measured time
+    auto data = received_message->GetAttributeView("data");
+    bytes += data ? data->size() : 0;
+    messages++;
+  }
+};
+
+/**
+ * Measures the aggregate throughput of a single node receiving messages from
+ * many peers at once.
+ * @param peer_count count of nodes sending messages concurrently
+ * @param receiver_threads count of I/O threads of the receiving node
+ * @param payload_size size of each message's blob in bytes
+ */
+static void BenchmarkReceiveThroughput(size_t peer_count,
+                                       size_t receiver_threads,
+                                       size_t payload_size) {
+  const size_t receiver_port = 9500;
+  auto receiver_config = std::make_shared<common::config::Configuration>();
+  receiver_config->Set("net.threads", receiver_threads);
+  auto receiver = SetupNode(receiver_port, receiver_config);
+
+  auto consumer = std::make_shared<CountingConsumer>();
+  receiver.networking_manager.Borrow()->AddMessageConsumer(consumer);
+
+  std::vector<BenchmarkNode> peers;
+  std::vector<common::memory::Borrower<IMessageEndpoint>> endpoints;
+  for (size_t i = 0; i < peer_count; i++) {
+    auto peer = SetupNode(receiver_port + 1 + i,
+                          std::make_shared<common::config::Configuration>());
+    auto endpoint =
+        peer.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+    endpoint
+        ->EstablishConnectionTo("ws://127.0.0.1:" +
+                                std::to_string(receiver_port))
+        .get();
+    endpoints.push_back(endpoint);
+    peers.push_back(std::move(peer));
+  }
+
+  auto receiver_endpoint = receiver.networking_manager.Borrow()
+                               ->GetDefaultMessageEndpoint()
+                               .value();
+  while (receiver_endpoint->GetActiveConnectionCount() < peer_count) {
+    receiver.job_manager.Borrow()->InvokeCycleAndWait();
+  }
+
+  // every scenario transfers roughly the same amount of data
+  size_t messages_per_peer = (256 * 1024 * 1024) / peer_count / payload_size;
+  messages_per_peer = std::clamp<size_t>(messages_per_peer, 16, 2000);
+  size_t expected_messages = messages_per_peer * peer_count;
+  auto message = CreateMessage(payload_size);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> senders;
+  for (size_t i = 0; i < peer_count; i++) {
+    senders.emplace_back([&endpoint = endpoints[i], &receiver, &message,
+                          messages_per_peer]() {
+      // wait for some messages now and then to respect the send queue limits
+      std::vector<std::future<void>> sending;
+      for (size_t j = 0; j < messages_per_peer; j++) {
+        try {
+          sending.push_back(endpoint->Send(receiver.id, message));
+        } catch (const std::exception &exception) {
+          // lost messages are reported as part of the results
+          std::cerr << "peer stopped sending: " << exception.what()
+                    << std::endl;
+          break;
+        }
+
+        if (sending.size() == 32) {
+          for (auto &future : sending) {
+            future.wait();
+          }
+          sending.clear();
+        }
+      }
+
+      for (auto &future : sending) {
+        future.wait();
+      }
+    });
+  }
+
+  // consumers are invoked by jobs, so the receiver's cycles must run
+  auto deadline = start + 60s;
+  while (consumer->messages < expected_messages &&
+         std::chrono::steady_clock::now() < deadline) {
+    receiver.job_manager.Borrow()->InvokeCycleAndWait();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  for (auto &sender : senders) {
+    sender.join();
+  }
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double received_messages = static_cast<double>(consumer->messages);
+  s_results.push_back(
+      {"receive_throughput",
+       {{"peers", std::to_string(peer_count)},
+        {"receiver_threads", std::to_string(receiver_threads)},
+        {"payload_bytes", std::to_string(payload_size)}},
+       {{"messages_per_s", received_messages / seconds},
+        {"mb_per_s", static_cast<double>(consumer->bytes) / seconds / 1e6},
+        {"received_ratio",
+         received_messages / static_cast<double>(expected_messages)}}});
+}
+
+/**
+ * Keeps invoking cycles of some job managers on a separate thread, so
+ * consumers of their nodes are executed while the benchmark waits for them.
+ * @note A single thread serves all job managers, so idle nodes do not occupy
+ * a core each.
+ */
+class CycleRunner {
+  std::vector<common::memory::Reference<jobsystem::JobManager>> m_job_managers;
+  std::atomic<bool> m_running{true};
+  std::thread m_thread;
+
+public:
+  explicit CycleRunner(
+      std::vector<common::memory::Reference<jobsystem::JobManager>>
+          job_managers)
+      : m_job_managers(std::move(job_managers)) {
+    m_thread = std::thread([this]() {
+      while (m_running) {
+        for (auto &job_manager : m_job_managers) {
+          job_manager.Borrow()->InvokeCycleAndWait();
+        }
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  ~CycleRunner() {
+    m_running = false;
+    m_thread.join();
+  }
+};
+
+/**
+ * Waits until a condition is met.
+ * @param condition condition to wait for
+ * @param timeout maximum duration to wait
+ * @return true, if the condition has been met in time
+ */
+static bool WaitUntil(const std::function<bool()> &condition,
+                      std::chrono::steady_clock::duration timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+/**
+ * @param samples measured values
+ * @param percentile percentile to determine (between 0 and 1)
+ * @return value below which the given share of samples falls
+ */
+static double Percentile(std::vector<double> samples, double percentile) {
+  if (samples.empty()) {
+    return 0;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto index = static_cast<size_t>(percentile * samples.size());
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+/**
+ * Connects some nodes to another one over its default endpoint and waits
+ * until the other node has registered all of them.
+ * @param nodes nodes to connect
+ * @param target node to connect to
+ * @param target_port port the target is listening on
+ */
+static void ConnectAll(std::vector<BenchmarkNode> &nodes,
+                       BenchmarkNode &target, size_t target_port) {
+  for (auto &node : nodes) {
+    node.networking_manager.Borrow()
+        ->GetDefaultMessageEndpoint()
+        .value()
+        ->EstablishConnectionTo("ws://127.0.0.1:" + std::to_string(target_port))
+        .get();
+  }
+
+  auto target_endpoint =
+      target.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  while (target_endpoint->GetActiveConnectionCount() < nodes.size()) {
+    target.job_manager.Borrow()->InvokeCycleAndWait();
+  }
+}
+
+/**
+ * Measures the throughput of a single connection between two nodes.
+ * @param payload_size size of each message's blob in bytes
+ */
+static void BenchmarkThroughput(size_t payload_size) {
+  const size_t receiver_port = 9600;
+  auto receiver = SetupNode(receiver_port,
+                            std::make_shared<common::config::Configuration>());
+  auto consumer = std::make_shared<CountingConsumer>();
+  receiver.networking_manager.Borrow()->AddMessageConsumer(consumer);
+
+  std::vector<BenchmarkNode> senders;
+  senders.push_back(SetupNode(
+      receiver_port + 1, std::make_shared<common::config::Configuration>()));
+  ConnectAll(senders, receiver, receiver_port);
+  auto endpoint = senders[0]
+                      .networking_manager.Borrow()
+                      ->GetDefaultMessageEndpoint()
+                      .value();
+
+  // every payload size transfers roughly the same amount of data
+  size_t message_count = (256 * 1024 * 1024) / payload_size;
+  message_count = std::clamp<size_t>(message_count, 16, 20000);
+  auto message = CreateMessage(payload_size);
+
+  CycleRunner cycles({receiver.job_manager});
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::future<void>> sending;
+  for (size_t i = 0; i < message_count; i++) {
+    try {
+      sending.push_back(endpoint->Send(receiver.id, message));
+    } catch (const std::exception &exception) {
+      std::cerr << "stopped sending: " << exception.what() << std::endl;
+      break;
+    }
+
+    // wait for some messages now and then to respect the send queue limits
+    if (sending.size() == 64) {
+      for (auto &future : sending) {
+        future.wait();
+      }
+      sending.clear();
+    }
+  }
+
+  WaitUntil(
+      [&consumer, message_count]() {
+        return consumer->messages >= message_count;
+      },
+      60s);
+  auto end = std::chrono::steady_clock::now();
+
+  for (auto &future : sending) {
+    future.wait();
+  }
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double received_messages = static_cast<double>(consumer->messages);
+  s_results.push_back(
+      {"throughput",
+       {{"payload_bytes", std::to_string(payload_size)}},
+       {{"messages_per_s", received_messages / seconds},
+        {"gb_per_s", static_cast<double>(consumer->bytes) / seconds / 1e9},
+        {"received_ratio",
+         received_messages / static_cast<double>(message_count)}}});
+}
+
+/**
+ * Replies to each request by sending its payload back to the requesting node.
+ */
+class EchoConsumer : public IMessageConsumer {
+  common::memory::Reference<NetworkingManager> m_networking_manager;
+
+public:
+  explicit EchoConsumer(
+      common::memory::Reference<NetworkingManager> networking_manager)
+      : m_networking_manager(std::move(networking_manager)) {}
+
+  std::string GetMessageType() const override { return "echo-request"; }
+
+  void ProcessReceivedMessage(SharedMessage received_message,
+                              ConnectionInfo connection_info) override {
+    // the response shares the received payload instead of copying it
+    auto response = std::make_shared<Message>("echo-response");
+    if (auto data = received_message->GetSharedAttribute("data")) {
+      response->SetAttribute("data", std::move(data.value()));
+    }
+    m_networking_manager.Borrow()
+        ->GetDefaultMessageEndpoint()
+        .value()
+        ->Send(connection_info.endpoint_id, response);
+  }
+};
+
+/**
+ * Counts responses to echo requests.
+ */
+class ResponseConsumer : public IMessageConsumer {
+public:
+  std::atomic<size_t> responses{0};
+
+  std::string GetMessageType() const override { return "echo-response"; }
+
+  void ProcessReceivedMessage(SharedMessage received_message,
+                              ConnectionInfo connection_info) override {
+    responses++;
+  }
+};
+
+/**
+ * Measures the round-trip time of a request answered by another node. It
+ * includes the dispatch of both messages to their consumers.
+ * @param payload_size size of the request's and response's blob in bytes
+ */
+static void BenchmarkRoundTripLatency(size_t payload_size) {
+  const size_t responder_port = 9610;
+  const size_t warm_up_count = 50;
+  const size_t sample_count = 1000;
+
+  auto responder = SetupNode(responder_port,
+                             std::make_shared<common::config::Configuration>());
+  auto echo = std::make_shared<EchoConsumer>(responder.networking_manager);
+  responder.networking_manager.Borrow()->AddMessageConsumer(echo);
+
+  std::vector<BenchmarkNode> requesters;
+  requesters.push_back(SetupNode(
+      responder_port + 1, std::make_shared<common::config::Configuration>()));
+  ConnectAll(requesters, responder, responder_port);
+  auto &requester = requesters[0];
+  auto responses = std::make_shared<ResponseConsumer>();
+  requester.networking_manager.Borrow()->AddMessageConsumer(responses);
+  auto endpoint = requester.networking_manager.Borrow()
+                      ->GetDefaultMessageEndpoint()
+                      .value();
+
+  auto request = CreateMessage(payload_size, "echo-request");
+
+  CycleRunner cycles({responder.job_manager, requester.job_manager});
+  std::vector<double> samples;
+  for (size_t i = 0; i < warm_up_count + sample_count; i++) {
+    auto start = std::chrono::steady_clock::now();
+    endpoint->Send(responder.id, request);
+    if (!WaitUntil([&responses, i]() { return responses->responses > i; },
+                   5s)) {
+      std::cerr << "echo request has not been answered in time" << std::endl;
+      break;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (i >= warm_up_count) {
+      samples.push_back(
+          std::chrono::duration<double, std::micro>(end - start).count());
+    }
+  }
+
+  s_results.push_back(
+      {"round_trip_latency",
+       {{"payload_bytes", std::to_string(payload_size)}},
+       {{"p50_us", Percentile(samples, 0.5)},
+        {"p99_us", Percentile(samples, 0.99)},
+        {"completed_ratio", static_cast<double>(samples.size()) /
+                                static_cast<double>(sample_count)}}});
+}
+
+/**
+ * Measures how long broadcasting a message to many peers takes.
+ * @param peer_count count of nodes connected to the broadcasting node
+ * @param payload_size size of the broadcast message's blob in bytes
+ */
+static void BenchmarkBroadcastFanOut(size_t peer_count, size_t payload_size) {
+  const size_t broadcaster_port = 9700;
+  const size_t broadcast_count = 100;
+
+  auto broadcaster = SetupNode(
+      broadcaster_port, std::make_shared<common::config::Configuration>());
+
+  std::vector<BenchmarkNode> peers;
+  std::vector<std::shared_ptr<CountingConsumer>> consumers;
+  std::vector<common::memory::Reference<jobsystem::JobManager>> job_managers;
+  for (size_t i = 0; i < peer_count; i++) {
+    auto peer = SetupNode(broadcaster_port + 1 + i,
+                          std::make_shared<common::config::Configuration>());
+    auto consumer = std::make_shared<CountingConsumer>();
+    peer.networking_manager.Borrow()->AddMessageConsumer(consumer);
+    consumers.push_back(consumer);
+    job_managers.push_back(peer.job_manager);
+    peers.push_back(std::move(peer));
+  }
+  ConnectAll(peers, broadcaster, broadcaster_port);
+
+  auto endpoint = broadcaster.networking_manager.Borrow()
+                      ->GetDefaultMessageEndpoint()
+                      .value();
+  auto message = CreateMessage(payload_size);
+  auto received_messages = [&consumers]() {
+    size_t count = 0;
+    for (const auto &consumer : consumers) {
+      count += consumer->messages;
+    }
+    return count;
+  };
+
+  // broadcasts are sent one after another, so each one is timed on its own
+  std::vector<double> samples;
+  size_t failed_sends = 0;
+
+  CycleRunner cycles(job_managers);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < broadcast_count; i++) {
+    auto broadcast_start = std::chrono::steady_clock::now();
+    auto result = endpoint->Broadcast(message).get();
+    samples.push_back(std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - broadcast_start)
+                          .count());
+    failed_sends += result.failed.size();
+  }
+
+  // consumers of peers are invoked by their cycles, which run in between
+  size_t expected_messages = broadcast_count * peer_count - failed_sends;
+  WaitUntil(
+      [&received_messages, expected_messages]() {
+        return received_messages() >= expected_messages;
+      },
+      60s);
+  auto end = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double delivered_messages = static_cast<double>(received_messages());
+  s_results.push_back(
+      {"broadcast_fan_out",
+       {{"peers", std::to_string(peer_count)},
+        {"payload_bytes", std::to_string(payload_size)}},
+       {{"sent_p50_us", Percentile(samples, 0.5)},
+        {"sent_p99_us", Percentile(samples, 0.99)},
+        {"deliveries_per_s", delivered_messages / seconds},
+        {"delivered_ratio",
+         delivered_messages /
+             static_cast<double>(broadcast_count * peer_count)}}});
+}
+
+/**
+ * Measures how fast a node accepts connections of other nodes, including
+ * their handshakes.
+ * @param peer_count count of nodes connecting to the node
+ * @param concurrent if true, all nodes connect at once (otherwise one after
+ * another)
+ */
+static void BenchmarkConnectionSetup(size_t peer_count, bool concurrent) {
+  const size_t acceptor_port = 9800;
+  auto acceptor = SetupNode(acceptor_port,
+                            std::make_shared<common::config::Configuration>());
+  auto acceptor_endpoint =
+      acceptor.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+
+  // setting up nodes is not part of the measurement
+  std::vector<BenchmarkNode> peers;
+  std::vector<common::memory::Borrower<IMessageEndpoint>> endpoints;
+  for (size_t i = 0; i < peer_count; i++) {
+    auto peer = SetupNode(acceptor_port + 1 + i,
+                          std::make_shared<common::config::Configuration>());
+    endpoints.push_back(
+        peer.networking_manager.Borrow()->GetDefaultMessageEndpoint().value());
+    peers.push_back(std::move(peer));
+  }
+
+  std::string uri = "ws://127.0.0.1:" + std::to_string(acceptor_port);
+  std::vector<double> samples;
+  size_t failed_connections = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  if (concurrent) {
+    std::vector<std::future<ConnectionInfo>> connecting;
+    for (auto &endpoint : endpoints) {
+      connecting.push_back(endpoint->EstablishConnectionTo(uri));
+    }
+    for (auto &future : connecting) {
+      try {
+        future.get();
+      } catch (const std::exception &exception) {
+        failed_connections++;
+      }
+    }
+  } else {
+    for (auto &endpoint : endpoints) {
+      auto connection_start = std::chrono::steady_clock::now();
+      try {
+        endpoint->EstablishConnectionTo(uri).get();
+      } catch (const std::exception &exception) {
+        failed_connections++;
+        continue;
+      }
+      samples.push_back(std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - connection_start)
+                            .count());
+    }
+  }
+
+  // connections only count once the acceptor has registered them as well
+  size_t expected_connections = peer_count - failed_connections;
+  auto deadline = std::chrono::steady_clock::now() + 30s;
+  while (acceptor_endpoint->GetActiveConnectionCount() < expected_connections &&
+         std::chrono::steady_clock::now() < deadline) {
+    acceptor.job_manager.Borrow()->InvokeCycleAndWait();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  BenchmarkResult result{
+      "connection_setup",
+      {{"peers", std::to_string(peer_count)},
+       {"concurrent", concurrent ? "true" : "false"}},
+      {{"connections_per_s",
+        static_cast<double>(acceptor_endpoint->GetActiveConnectionCount()) /
+            seconds},
+       {"failed_ratio", static_cast<double>(failed_connections) /
+                            static_cast<double>(peer_count)}}};
+  if (!concurrent) {
+    result.metrics.emplace_back("p50_us", Percentile(samples, 0.5));
+    result.metrics.emplace_back("p99_us", Percentile(samples, 0.99));
+  }
+  s_results.push_back(std::move(result));
+}
+
+/**
+ * Runs all benchmarks of the networking subsystem and prints their results as
+ * JSON.
+ * Usage: networkingbenchmarks [output file or -] [benchmark name]
+ * @note Logs are written to stderr, so stdout only contains the results.
+ */
+int main(int argc, char **argv) {
+  // transport changes only have to run the affected benchmark
+  std::string filter = argc > 2 ? argv[2] : "";
+  auto selected = [&filter](const std::string &name) {
+    return filter.empty() || filter == name;
+  };
+
+  if (selected("converter")) {
+    for (size_t payload_size : {64, 4 * 1024, 256 * 1024, 4 * 1024 * 1024}) {
+      for (auto format :
+           {WireFormat::MULTIPART_FORMDATA, WireFormat::BINARY}) {
+        BenchmarkConverter(format, payload_size);
+      }
+    }
+  }
+
+  if (selected("throughput")) {
+    for (size_t payload_size :
+         {64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024}) {
+      BenchmarkThroughput(payload_size);
+    }
+  }
+
+  if (selected("receive_throughput")) {
+    for (size_t peer_count : {16, 32}) {
+      for (size_t receiver_threads : {1, 4}) {
+        for (size_t payload_size : {4 * 1024, 256 * 1024}) {
+          BenchmarkReceiveThroughput(peer_count, receiver_threads,
+                                     payload_size);
+        }
+      }
+    }
+  }
+
+  if (selected("round_trip_latency")) {
+    for (size_t payload_size : {64, 4 * 1024, 256 * 1024}) {
+      BenchmarkRoundTripLatency(payload_size);
+    }
+  }
+
+  if (selected("broadcast_fan_out")) {
+    for (size_t peer_count : {4, 16, 32}) {
+      for (size_t payload_size : {4 * 1024, 256 * 1024}) {
+        BenchmarkBroadcastFanOut(peer_count, payload_size);
+      }
+    }
+  }
+
+  if (selected("connection_setup")) {
+    for (size_t peer_count : {16, 64}) {
+      BenchmarkConnectionSetup(peer_count, false);
+      BenchmarkConnectionSetup(peer_count, true);
+    }
+  }
+
+  if (argc > 1 && std::string(argv[1]) != "-") {
+    std::ofstream file(argv[1]);
+    WriteJson(file, s_results);
+  } else {
+    WriteJson(std::cout, s_results);
+  }
+
+  return 0;
+}
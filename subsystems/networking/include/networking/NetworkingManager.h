@@ -6,8 +6,14 @@
 #include "networking/messaging/IMessageConsumer.h"
 #include "networking/messaging/IMessageEndpoint.h"
 #include "networking/messaging/impl/websockets/boost/BoostWebSocketEndpoint.h"
+#include "networking/messaging/streams/IMessageStreamConsumer.h"
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace hive::networking {
 
@@ -26,14 +32,52 @@ class NetworkingManager
   common::memory::Reference<common::subsystems::SubsystemManager> m_subsystems;
   common::config::SharedConfiguration m_config;
 
-  /** maps message type names to their consumers */
-  std::map<std::string, std::list<std::weak_ptr<messaging::IMessageConsumer>>>
-      m_consumers;
+public:
+  /** interned name of a message type */
+  typedef uint32_t MessageTypeId;
+
+  /** immutable consumers of a single message type */
+  typedef std::vector<std::weak_ptr<messaging::IMessageConsumer>> ConsumerList;
+  typedef std::shared_ptr<const ConsumerList> SharedConsumerList;
+
+private:
+  /**
+   * Immutable snapshot of all registered consumers. It is replaced as a whole
+   * when consumers are added or removed, so received messages are dispatched
+   * without locking or allocating.
+   */
+  struct ConsumerTable {
+    /**
+     * Maps interned message types to their ids. The keys point into the type
+     * storage, which only grows, so they stay valid for all snapshots.
+     */
+    std::unordered_map<std::string_view, MessageTypeId> type_ids;
+
+    /** consumers of each message type (indexed by its id) */
+    std::vector<SharedConsumerList> consumers;
+  };
+
+  std::atomic<std::shared_ptr<const ConsumerTable>> m_consumer_table;
+  std::deque<std::string> m_message_type_storage;
+
+  /** serializes writers of the consumer table, readers never acquire it */
   mutable jobsystem::mutex m_consumers_mutex;
 
+  /** maps stream type names to their consumer */
+  std::map<std::string,
+           std::weak_ptr<messaging::streams::IMessageStreamConsumer>>
+      m_stream_consumers;
+  mutable jobsystem::mutex m_stream_consumers_mutex;
+
   /** default protocol name */
   std::string m_default_endpoint_protocol;
 
+  /**
+   * Protocols that are preferred over the default one when looking for an
+   * endpoint connected to some node (e.g. cheaper ones like raw sockets)
+   */
+  std::vector<std::string> m_preferred_protocols;
+
   /** stores registered message endpoints according to their protocol */
   std::map<std::string,
            std::shared_ptr<common::memory::Owner<messaging::IMessageEndpoint>>>
@@ -42,22 +86,23 @@ class NetworkingManager
 
   void StartDefaultEndpointImplementation();
   void ConfigureNode(const common::config::SharedConfiguration &config);
-  void SetupConsumerCleanUpJob();
 
   /**
-   * Consumers are stored as expiring weak-pointers. Once the actual consumer
-   * has been destroyed (outside this component), its weak-pointer becomes
-   * unusable and can be removed.
-   * @param type message type name of consumers to clean up
+   * Get a snapshot of the consumers of a message type without locking.
+   * @param type_name name of the message type
+   * @return immutable list of consumers or nullptr, if there are none
+   * @note The snapshot could contain expired consumers.
    */
-  void CleanUpConsumersOfMessageType(const std::string &type);
+  SharedConsumerList GetConsumerList(std::string_view type_name) const;
 
   /**
-   * Consumers are stored as expiring weak-pointers. Once the actual consumer
-   * has been destroyed (outside this component), its weak-pointer becomes
-   * unusable and can be removed. This is done for all message types.
+   * Replaces the consumers of a message type. Expired consumers are dropped.
+   * @param type_name name of the message type (interned if necessary)
+   * @param modify modifies a copy of the current consumers
+   * @note The consumers mutex must be acquired by the caller.
    */
-  void CleanUpAllConsumers();
+  void ModifyConsumerList(const std::string &type_name,
+                          const std::function<void(ConsumerList &)> &modify);
 
 public:
   NetworkingManager(
@@ -68,19 +113,26 @@ public:
   /**
    * Registers a consumer for a certain type of message. Incoming messages of
    * this type will be redirected to the consumer.
-   * @attention Every type of message can only have a single consumer at a time,
-   * so the type must be unique.
    * @param consumer consumer of specific type to add to the register
-   * @throws DuplicateConsumerTypeException if there is already a consumer for
-   * that type registered.
+   * @note Consumers are not kept alive by the networking manager. Expired
+   * consumers are removed when consumers of their type are added or removed.
    */
   void AddMessageConsumer(std::weak_ptr<messaging::IMessageConsumer> consumer);
 
+  /**
+   * Unregisters a consumer, so it does not receive messages anymore.
+   * @param consumer consumer to remove from the register
+   */
+  void
+  RemoveMessageConsumer(const messaging::SharedMessageConsumer &consumer);
+
   /**
    * Tries to retrieve a valid consumer for the given message type (if
    * one is registered and has not expired yet)
    * @param type_name type name of the events that the consumer processes
    * @return a consumer if one has been found for the given type
+   * @note Received messages are dispatched using the consumer table directly,
+   * so this is only meant for inspection.
    */
   std::list<messaging::SharedMessageConsumer>
   GetConsumersOfMessageType(const std::string &type_name);
@@ -93,6 +145,25 @@ public:
   void ProcessMessage(const messaging::SharedMessage &message,
                       const messaging::ConnectionInfo &info);
 
+  /**
+   * Registers the consumer of a certain type of stream. Streams of this type
+   * opened by other nodes will be passed to the consumer.
+   * @note Streams can only be read by a single consumer, so a consumer that
+   * has already been registered for the type will be replaced.
+   * @param consumer consumer of specific stream type to add to the register
+   */
+  void AddMessageStreamConsumer(
+      std::weak_ptr<messaging::streams::IMessageStreamConsumer> consumer);
+
+  /**
+   * Processes a stream opened by another node by passing it to its consumer.
+   * @param reader reader of the stream
+   * @param info connection information of the sender
+   * @return false, if there is no consumer for the type of stream
+   */
+  bool ProcessMessageStream(messaging::streams::SharedMessageStreamReader reader,
+                            const messaging::ConnectionInfo &info);
+
   /**
    * Installs a messaging endpoint implementation for a specific protocol.
    * @note The messaging endpoint will be initialized and started at
@@ -172,8 +243,9 @@ public:
   /**
    * Retrieves some message endpoint which is connected to a certain node if one
    * exists.
-   * @note default endpoint will be preferred if it is connected to the given
-   * node. Otherwise, some other endpoint will be selected.
+   * @note Endpoints of preferred protocols (net.endpoints.preferred, "shm,tcp"
+   * by default) are checked first in the configured order, then the default
+   * endpoint. Otherwise, some other endpoint will be selected.
    * @return some message endpoint connected to the given node if one exists.
    */
   std::optional<common::memory::Borrower<messaging::IMessageEndpoint>>
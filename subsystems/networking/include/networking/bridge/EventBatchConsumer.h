@@ -0,0 +1,48 @@
+#pragma once
+
+#include "networking/bridge/EventBatchMessage.h"
+#include "networking/messaging/IMessageConsumer.h"
+#include <functional>
+
+namespace hive::networking::bridge {
+
+/**
+ * Consumes batches of events sent by the event bridges of other nodes and
+ * passes them on for re-firing.
+ */
+class EventBatchConsumer : public messaging::IMessageConsumer {
+  std::function<void(const EventBatchMessage &,
+                     const messaging::ConnectionInfo &)>
+      m_consumer;
+
+public:
+  EventBatchConsumer() = delete;
+  explicit EventBatchConsumer(
+      std::function<void(const EventBatchMessage &,
+                         const messaging::ConnectionInfo &)>
+          consumer);
+
+  std::string GetMessageType() const override;
+
+  void
+  ProcessReceivedMessage(messaging::SharedMessage received_message,
+                         messaging::ConnectionInfo connection_info) override;
+};
+
+inline EventBatchConsumer::EventBatchConsumer(
+    std::function<void(const EventBatchMessage &,
+                       const messaging::ConnectionInfo &)>
+        consumer)
+    : m_consumer(std::move(consumer)) {}
+
+inline std::string EventBatchConsumer::GetMessageType() const {
+  return MESSAGE_TYPE_EVENT_BATCH;
+}
+
+inline void EventBatchConsumer::ProcessReceivedMessage(
+    messaging::SharedMessage received_message,
+    messaging::ConnectionInfo connection_info) {
+  m_consumer(EventBatchMessage(std::move(received_message)), connection_info);
+}
+
+} // namespace hive::networking::bridge
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "networking/messaging/Message.h"
+
+#define MESSAGE_TYPE_EVENT_BATCH "event-batch"
+
+namespace hive::networking::bridge {
+
+/**
+ * Message carrying a batch of serialized events (see EventBatchSerializer)
+ * from one node's event bridge to another.
+ */
+class EventBatchMessage {
+private:
+  messaging::SharedMessage m_message;
+
+public:
+  explicit EventBatchMessage(messaging::SharedMessage message =
+                                 std::make_shared<messaging::Message>(
+                                     MESSAGE_TYPE_EVENT_BATCH));
+
+  messaging::SharedMessage GetMessage() const;
+
+  /**
+   * Sets the id of the node on which the events have been fired originally.
+   * @param node_id id of the originating node
+   */
+  void SetOrigin(const std::string &node_id);
+  std::string GetOrigin() const;
+
+  void SetSerializedEvents(std::string events);
+  std::string GetSerializedEvents() const;
+};
+
+inline EventBatchMessage::EventBatchMessage(messaging::SharedMessage message)
+    : m_message(std::move(message)) {}
+
+inline messaging::SharedMessage EventBatchMessage::GetMessage() const {
+  return m_message;
+}
+
+inline void EventBatchMessage::SetOrigin(const std::string &node_id) {
+  m_message->SetAttribute("origin", node_id);
+}
+
+inline std::string EventBatchMessage::GetOrigin() const {
+  return m_message->GetAttribute("origin").value_or("");
+}
+
+inline void EventBatchMessage::SetSerializedEvents(std::string events) {
+  m_message->SetAttribute("events", std::move(events));
+}
+
+inline std::string EventBatchMessage::GetSerializedEvents() const {
+  return m_message->GetAttribute("events").value_or("");
+}
+
+} // namespace hive::networking::bridge
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common/exceptions/ExceptionsBase.h"
+#include "events/Event.h"
+#include <any>
+#include <string>
+#include <vector>
+
+namespace hive::networking::bridge {
+
+DECLARE_EXCEPTION(EventBatchInvalidException);
+
+/**
+ * Converts batches of events into a compact binary representation and vice
+ * versa, so they can be sent to other nodes as a single message attribute.
+ *
+ * Event payloads are type-erased, so only payloads of the following types can
+ * be transported: std::string, bool, int, long, size_t, float and double.
+ * Other payloads are skipped.
+ *
+ * @note Numeric values are encoded in the byte order of the host. All nodes
+ * of a hive are expected to share the same byte order.
+ */
+class EventBatchSerializer {
+public:
+  /**
+   * Serializes a batch of events including their topic, id and payload.
+   * @param events events to serialize
+   * @return binary representation of the batch
+   */
+  static std::string Serialize(const std::vector<events::SharedEvent> &events);
+
+  /**
+   * Restores a batch of events from its binary representation.
+   * @param data binary representation of the batch
+   * @return restored events (with their original ids)
+   * @throws EventBatchInvalidException if the data is truncated or corrupt
+   */
+  static std::vector<events::SharedEvent> Deserialize(const std::string &data);
+
+  /**
+   * Checks if a payload value can be transported to other nodes.
+   * @param value payload value of an event
+   * @return true, if its type is supported
+   */
+  static bool IsSerializable(const std::any &value);
+};
+
+} // namespace hive::networking::bridge
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common/config/Configuration.h"
+#include "common/memory/ExclusiveOwnership.h"
+#include "common/subsystems/SubsystemManager.h"
+#include "events/broker/impl/EventCoalescer.h"
+#include "events/listener/IEventListener.h"
+#include "jobsystem/manager/JobManager.h"
+#include "networking/bridge/EventBatchMessage.h"
+#include "networking/messaging/IMessageConsumer.h"
+#include <memory>
+#include <set>
+#include <string>
+
+namespace hive::networking::bridge {
+
+/**
+ * Forwards events of selected topics to all connected peers, which re-fire
+ * them in their own event broker. This extends publish-subscribe to the whole
+ * hive without sending a message per event and peer.
+ *
+ * Forwarded events are collected and sent as batches: All events fired until
+ * the next execution cycle (or configured window) are serialized once and
+ * broadcast as a single message. Batches are sent earlier, if they reach the
+ * configured size.
+ *
+ * Re-fired events carry the id of their originating node as payload (see
+ * c_origin_payload_key) and are never forwarded again, so events cannot
+ * circulate between bridges.
+ *
+ * @note Only events fired on this node are forwarded to directly connected
+ * peers. Peers only re-fire events, if they run an event bridge as well.
+ * @note Only payloads of basic types can be forwarded (see
+ * EventBatchSerializer).
+ */
+class EventBridge : public common::memory::EnableBorrowFromThis<EventBridge> {
+  common::memory::Reference<common::subsystems::SubsystemManager> m_subsystems;
+
+  /** id of this node, used to recognize events fired here */
+  std::string m_node_id;
+
+  /** topics and topic patterns whose events are forwarded */
+  std::set<std::string> m_forwarded_topics;
+  mutable jobsystem::mutex m_forwarded_topics_mutex;
+
+  /** collects events of all forwarded topics (dispatched inline) */
+  events::SharedEventListener m_forwarding_listener;
+
+  /** re-fires batches of events received from other nodes */
+  messaging::SharedMessageConsumer m_batch_consumer;
+
+  /** pending events of all forwarded topics until they are sent */
+  std::shared_ptr<events::brokers::EventCoalescer> m_pending_events;
+
+  /** when this shared pointer expired, this has been destroyed */
+  std::shared_ptr<bool> m_this_alive_checker;
+
+  /**
+   * Adds a locally fired event to the pending batch.
+   * @param event event of a forwarded topic
+   */
+  void Enqueue(events::SharedEvent event);
+
+  /**
+   * Serializes a batch of events once and broadcasts it to all peers.
+   * @param batch events to send
+   */
+  void SendBatch(const std::vector<events::SharedEvent> &batch);
+
+  /**
+   * Re-fires events received from another node in the local event broker.
+   * @param message received batch of events
+   * @param info connection information of the sender
+   */
+  void ReceiveBatch(const EventBatchMessage &message,
+                    const messaging::ConnectionInfo &info);
+
+public:
+  /** payload key containing the id of the node an event has been fired on */
+  static constexpr const char *c_origin_payload_key = "bridge-origin";
+
+  /**
+   * Creates an event bridge and starts to accept batches of events from
+   * other nodes.
+   * @param subsystems subsystems providing the event broker, job manager, data
+   * layer and networking manager.
+   * @param config configuration of the bridge ('net.bridge.batch-size',
+   * 'net.bridge.window-ms' and 'net.bridge.topics', a comma-separated list of
+   * topics forwarded right away)
+   */
+  EventBridge(
+      const common::memory::Reference<common::subsystems::SubsystemManager>
+          &subsystems,
+      const common::config::SharedConfiguration &config);
+
+  ~EventBridge();
+
+  /**
+   * Starts to forward events of a topic to all connected peers.
+   * @param topic topic or topic pattern (wildcards are allowed)
+   */
+  void Forward(const std::string &topic);
+
+  /**
+   * Stops to forward events of a topic to other peers.
+   * @param topic topic or topic pattern that has been forwarded before
+   */
+  void StopForwarding(const std::string &topic);
+
+  /**
+   * Checks if events of a topic are forwarded.
+   * @param topic topic or topic pattern exactly like it has been passed to
+   * Forward
+   * @return true, if events of this topic are forwarded
+   */
+  bool IsForwarding(const std::string &topic) const;
+
+  /**
+   * Checks if an event has been received from another node.
+   * @param event some event
+   * @return true, if the event has been re-fired by an event bridge
+   */
+  static bool IsBridged(const events::SharedEvent &event);
+};
+
+} // namespace hive::networking::bridge
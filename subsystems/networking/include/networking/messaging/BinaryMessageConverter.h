@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Message.h"
+#include "common/exceptions/ExceptionsBase.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hive::networking::messaging {
+
+DECLARE_EXCEPTION(BinaryFrameInvalidException);
+DECLARE_EXCEPTION(BinaryFrameOverflowException);
+
+/**
+ * Converts messages into length-prefixed binary frames and vice versa. In
+ * contrast to multipart form-data, frames can be parsed without searching for
+ * boundaries and attribute values are raw blobs that are never escaped.
+ *
+ * All integers are little-endian. A frame is laid out like this:
+ * - header (16 bytes): magic 'HIVB', version (uint8), flags (uint8),
+ *   attribute count (uint16), id length (uint32), type length (uint32)
+ * - attribute table: for each attribute the offset and length of its name
+ *   (uint32 each) and the offset and length of its value (uint64 each).
+ *   Offsets are relative to the beginning of the frame.
+ * - data: id, type, then names and values of all attributes
+ *
+ * Several frames can be packed into a batch, which is sent as a single
+ * web-socket message:
+ * - header (12 bytes): magic 'HIVM', version (uint8), flags (uint8),
+ *   reserved (uint16), frame count (uint32)
+ * - for each frame its length (uint64) followed by the frame itself
+ */
+class BinaryMessageConverter {
+public:
+  static constexpr uint8_t c_version = 1;
+  static constexpr size_t c_header_size = 16;
+  static constexpr size_t c_attribute_entry_size = 24;
+  static constexpr size_t c_batch_header_size = 12;
+
+  /**
+   * Generates a binary frame from a message.
+   * @param message message to convert
+   * @return binary frame
+   * @throws BinaryFrameOverflowException if the message has more than 65535
+   * attributes or its id, type or attribute names do not fit into the
+   * 32-bit fields of the frame.
+   */
+  static std::string ToBinary(const SharedMessage &message);
+
+  /**
+   * Generates a message from a binary frame.
+   * @param frame binary frame
+   * @return message
+   * @throws BinaryFrameInvalidException if the frame is truncated, corrupt or
+   * of an unsupported version.
+   * @note The frame is copied once, so its attributes can reference it.
+   */
+  static SharedMessage FromBinary(const std::string &frame);
+
+  /**
+   * Generates a message from a received binary frame. Attribute values are
+   * not copied, but reference ranges of the frame.
+   * @param payload received binary frame
+   * @return message
+   * @throws BinaryFrameInvalidException if the frame is truncated, corrupt or
+   * of an unsupported version.
+   */
+  static SharedMessage FromBinary(const SharedPayload &payload);
+
+  /**
+   * Generates a message from a binary frame located somewhere inside a
+   * received payload (e.g. in a batch). Attribute values are not copied, but
+   * reference ranges of the payload.
+   * @param payload received payload containing the frame
+   * @param frame_offset position of the frame inside the payload
+   * @param frame_length size of the frame in bytes
+   * @return message
+   * @throws BinaryFrameInvalidException if the frame is truncated, corrupt or
+   * of an unsupported version.
+   */
+  static SharedMessage FromBinary(const SharedPayload &payload,
+                                  size_t frame_offset, size_t frame_length);
+
+  /**
+   * Packs binary frames into a single batch.
+   * @param frames binary frames generated by ToBinary
+   * @return batch of frames
+   * @throws BinaryFrameOverflowException if there are more frames than the
+   * batch header can count.
+   */
+  static std::string ToBinaryBatch(const std::vector<SharedPayload> &frames);
+
+  /**
+   * Generates all messages of a received batch. Attribute values are not
+   * copied, but reference ranges of the batch.
+   * @param payload received batch
+   * @return messages in the order they have been packed
+   * @throws BinaryFrameInvalidException if the batch or one of its frames is
+   * truncated, corrupt or of an unsupported version.
+   */
+  static std::vector<SharedMessage>
+  FromBinaryBatch(const SharedPayload &payload);
+
+  /**
+   * Checks if a payload looks like a binary frame (by its magic bytes).
+   * @param payload received payload
+   * @return true, if the payload starts like a binary frame
+   */
+  static bool IsBinary(const std::string &payload);
+
+  /**
+   * Checks if a payload looks like a batch of binary frames (by its magic
+   * bytes).
+   * @param payload received payload
+   * @return true, if the payload starts like a batch
+   */
+  static bool IsBinaryBatch(const std::string &payload);
+};
+
+} // namespace hive::networking::messaging
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "jobsystem/manager/JobManager.h"
+#include <exception>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace hive::networking::messaging {
+
+/**
+ * Outcome of broadcasting a message to all connected nodes.
+ */
+struct BroadcastResult {
+  /** ids of nodes the message has been sent to */
+  std::vector<std::string> delivered;
+
+  /** ids of nodes the message could not be sent to and the reason why */
+  std::map<std::string, std::string> failed;
+};
+
+/**
+ * Collects the outcomes of sending a broadcast message to each node. The
+ * result is complete as soon as every send has been reported, so sends do not
+ * have to be awaited one after another.
+ */
+class BroadcastProgress {
+private:
+  mutable jobsystem::mutex m_mutex;
+  BroadcastResult m_result;
+  std::promise<BroadcastResult> m_promise;
+
+  /** Count of sends that have not been reported yet */
+  size_t m_pending_count{0};
+
+  /** True, if no more sends will be added */
+  bool m_sealed{false};
+
+  /** Resolves the promise, if all sends have been reported */
+  void TryComplete(std::unique_lock<jobsystem::mutex> &lock);
+
+public:
+  /**
+   * @return future resolved with the result as soon as it is complete
+   */
+  std::future<BroadcastResult> GetFuture();
+
+  /**
+   * Announces a send to some node, which will be reported later on.
+   */
+  void AddPendingSend();
+
+  /**
+   * Reports the outcome of a send announced before.
+   * @param node_id id of the receiving node
+   * @param error exception, if sending failed (nullptr otherwise)
+   */
+  void ReportSend(const std::string &node_id, const std::exception_ptr &error);
+
+  /**
+   * Reports a node the message could not even be sent to.
+   * @param node_id id of the node
+   * @param reason reason why sending is not possible
+   */
+  void ReportFailure(const std::string &node_id, const std::string &reason);
+
+  /**
+   * Declares that all sends have been added. The result is completed once
+   * they have been reported.
+   */
+  void Seal();
+};
+
+typedef std::shared_ptr<BroadcastProgress> SharedBroadcastProgress;
+
+} // namespace hive::networking::messaging
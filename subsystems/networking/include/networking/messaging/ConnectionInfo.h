@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PayloadCompression.h"
+#include "WireFormat.h"
 #include <string>
 
 namespace hive::networking::messaging {
@@ -12,6 +14,10 @@ struct ConnectionInfo {
   std::string hostname;
   /** unique and unambiguous id of the other node in the hive */
   std::string endpoint_id;
+  /** encoding of sent messages negotiated with the other node */
+  WireFormat wire_format{WireFormat::MULTIPART_FORMDATA};
+  /** compression of sent payloads negotiated with the other node */
+  PayloadCompression compression{PayloadCompression::NO_COMPRESSION};
 };
 
 } // namespace hive::networking::messaging
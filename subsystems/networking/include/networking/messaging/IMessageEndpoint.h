@@ -2,6 +2,8 @@
 
 #include "IMessageConsumer.h"
 #include "common/exceptions/ExceptionsBase.h"
+#include "networking/messaging/BroadcastResult.h"
+#include "networking/messaging/streams/MessageStreamWriter.h"
 #include <future>
 #include <list>
 #include <memory>
@@ -47,6 +49,20 @@ public:
   virtual std::future<void> Send(const std::string &node_id,
                                  SharedMessage message) = 0;
 
+  /**
+   * Opens a stream to another node, over which large payloads can be sent in
+   * fragments without holding them in memory as a whole. Fragments are sent
+   * as separate messages, so other messages are not blocked by the stream.
+   * The receiver limits how much of the stream it buffers (flow control).
+   * @param node_id unique identifier of a node in the hive. There must be a
+   * connection between this endpoint and the node with this id.
+   * @param stream_type type of the stream, which is used to find its consumer
+   * (see streams::IMessageStreamConsumer) on the receiving node
+   * @return writer of the stream
+   */
+  virtual streams::SharedMessageStreamWriter
+  OpenStream(const std::string &node_id, const std::string &stream_type) = 0;
+
   /**
    * Sends some message to all currently connected peers.
    * @param message message that will be broadcast
@@ -56,6 +72,17 @@ public:
   virtual std::future<size_t>
   IssueBroadcastAsJob(const SharedMessage &message) = 0;
 
+  /**
+   * Sends some message to all currently connected peers without blocking the
+   * caller. The message is converted only once per wire format, no matter how
+   * many peers are connected.
+   * @param message message that will be broadcast
+   * @return a future resolved as soon as the message has been sent to all
+   * peers, containing the outcome for each of them.
+   */
+  virtual std::future<BroadcastResult>
+  Broadcast(const SharedMessage &message) = 0;
+
   /**
    * Counts active and usable connections of this endpoint to others.
    * @return count of active and usable connections
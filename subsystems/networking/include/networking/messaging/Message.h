@@ -1,10 +1,12 @@
 #pragma once
 
+#include "networking/messaging/MessageAttribute.h"
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 
 namespace hive::networking::messaging {
 
@@ -21,8 +23,17 @@ protected:
   /** Unique id of this message. */
   const std::string m_uuid;
 
-  /** Attributes containing the payload of this message. */
-  std::map<std::string, std::string> m_attributes;
+  /**
+   * Attributes containing the payload of this message. Received messages
+   * slice them from the received payload instead of copying them.
+   */
+  std::map<std::string, MessageAttribute> m_attributes;
+
+  /**
+   * If set, this message is sent right away instead of waiting to be batched
+   * with other messages. This is a local hint and not transmitted.
+   */
+  bool m_immediate_flush{false};
 
 public:
   explicit Message(std::string message_type);
@@ -49,18 +60,70 @@ public:
                     std::string attribute_value);
 
   /**
-   * Returns the value of an attribute (if it exists)
+   * Sets or overwrites an attribute of this message without copying its value.
+   * @param attribute_key key of the attribute
+   * @param attribute_value new value of the attribute (e.g. a slice of some
+   * received payload)
+   */
+  void SetAttribute(const std::string &attribute_key,
+                    MessageAttribute attribute_value);
+
+  /**
+   * Returns a copy of the value of an attribute (if it exists)
    * @param attribute_key key of the attribute
    * @return value of the attribute (if it exists)
+   * @note Prefer GetAttributeView for large attributes, which does not copy.
    */
   std::optional<std::string> GetAttribute(const std::string &attribute_key);
 
+  /**
+   * Returns the value of an attribute (if it exists) without copying it.
+   * @param attribute_key key of the attribute
+   * @return view of the value, which is valid as long as this message exists
+   */
+  std::optional<std::string_view>
+  GetAttributeView(const std::string &attribute_key) const;
+
+  /**
+   * Returns an attribute (if it exists) sharing its payload, so its value can
+   * outlive this message without being copied.
+   * @param attribute_key key of the attribute
+   * @return attribute (if it exists)
+   */
+  std::optional<MessageAttribute>
+  GetSharedAttribute(const std::string &attribute_key) const;
+
   /**
    * Returns a set of attribute names contained in the message
    * @return set of attribute names
    */
   std::set<std::string> GetAttributeNames() const ;
 
+  /**
+   * Returns all attributes of this message without copying them.
+   * @return attribute names mapped to their values
+   */
+  const std::map<std::string, MessageAttribute> &GetAttributes() const;
+
+  /**
+   * Sums up the sizes of all attribute values, which approximates the size of
+   * this message on the wire without converting it.
+   * @return total size of the attribute values in bytes
+   */
+  size_t GetPayloadSize() const;
+
+  /**
+   * Marks this message as latency-critical, so it is not held back for
+   * batching with other messages when being sent.
+   * @param immediate_flush true, if the message must be sent right away
+   */
+  void SetImmediateFlush(bool immediate_flush);
+
+  /**
+   * @return true, if this message must be sent right away
+   */
+  bool IsImmediateFlush() const;
+
   /**
    * Compares this message with another message for equality.
    * @param other other message
@@ -71,6 +134,14 @@ public:
 
 inline std::string Message::GetId() const  { return m_uuid; }
 inline std::string Message::GetType() const  { return m_type; }
+inline void Message::SetImmediateFlush(bool immediate_flush) {
+  m_immediate_flush = immediate_flush;
+}
+inline bool Message::IsImmediateFlush() const { return m_immediate_flush; }
+inline const std::map<std::string, MessageAttribute> &
+Message::GetAttributes() const {
+  return m_attributes;
+}
 
 typedef std::shared_ptr<Message> SharedMessage;
 
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace hive::networking::messaging {
+
+/** Immutable payload shared by all attributes that have been sliced from it */
+typedef std::shared_ptr<const std::string> SharedPayload;
+
+/**
+ * Value of a message attribute. It does not own its bytes, but references a
+ * range (offset and length) of a shared payload. Received messages slice all
+ * of their attributes out of the payload they have been received in, so
+ * attribute values are not copied after reading them from the socket.
+ * @attention An attribute keeps its whole payload alive. Consumers storing a
+ * small attribute of a large message for a long time should copy it using
+ * ToString().
+ */
+class MessageAttribute {
+  /** Payload containing the value of this attribute */
+  SharedPayload m_payload;
+
+  /** Position of the value inside the payload */
+  size_t m_offset{0};
+
+  /** Size of the value in bytes */
+  size_t m_length{0};
+
+public:
+  MessageAttribute() = default;
+
+  /**
+   * Creates an attribute owning its value (without copying it).
+   * @param value value of the attribute
+   */
+  explicit MessageAttribute(std::string value);
+
+  /**
+   * Creates an attribute referencing a range of a shared payload.
+   * @param payload payload containing the value
+   * @param offset position of the value inside the payload
+   * @param length size of the value in bytes
+   */
+  MessageAttribute(SharedPayload payload, size_t offset, size_t length);
+
+  /**
+   * @return view of the value, which is valid as long as this attribute (or
+   * its payload) exists
+   */
+  std::string_view GetView() const;
+
+  /**
+   * @return copy of the value
+   */
+  std::string ToString() const;
+
+  /**
+   * @return size of the value in bytes
+   */
+  size_t GetSize() const;
+
+  /**
+   * @return payload containing the value
+   */
+  const SharedPayload &GetPayload() const;
+
+  /**
+   * @return position of the value inside its payload
+   */
+  size_t GetOffset() const;
+};
+
+inline MessageAttribute::MessageAttribute(std::string value)
+    : m_payload{std::make_shared<const std::string>(std::move(value))},
+      m_length{m_payload->size()} {}
+
+inline MessageAttribute::MessageAttribute(SharedPayload payload, size_t offset,
+                                          size_t length)
+    : m_payload{std::move(payload)}, m_offset{offset}, m_length{length} {}
+
+inline std::string_view MessageAttribute::GetView() const {
+  if (!m_payload) {
+    return {};
+  }
+  return std::string_view(*m_payload).substr(m_offset, m_length);
+}
+
+inline std::string MessageAttribute::ToString() const {
+  return std::string(GetView());
+}
+
+inline size_t MessageAttribute::GetSize() const { return m_length; }
+
+inline const SharedPayload &MessageAttribute::GetPayload() const {
+  return m_payload;
+}
+
+inline size_t MessageAttribute::GetOffset() const { return m_offset; }
+
+} // namespace hive::networking::messaging
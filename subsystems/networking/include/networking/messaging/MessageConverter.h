@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Message.h"
+#include "WireFormat.h"
 #include "common/exceptions/ExceptionsBase.h"
+#include <vector>
 
 namespace hive::networking::messaging {
 
@@ -44,5 +46,50 @@ public:
    * @return the multipart-formdata encoded string
    */
   static std::string ToMultipartFormData(const SharedMessage &message);
+
+  /**
+   * Generates the payload of a message in the given wire format
+   * @param message message object that will be converted
+   * @param format wire format negotiated for the connection
+   * @return encoded payload
+   */
+  static std::string ToWireFormat(const SharedMessage &message,
+                                  WireFormat format);
+
+  /**
+   * Generates a message data object from a received payload. Its wire format
+   * is detected automatically, so peers can always receive all formats.
+   * @param payload received payload
+   * @return a message data object
+   * @throws MessagePayloadInvalidException if the payload is not convertible
+   * to a message object
+   * @note The payload is copied once, so attributes can reference it.
+   */
+  static SharedMessage FromWireFormat(const std::string &payload);
+
+  /**
+   * Generates a message data object from a received payload without copying
+   * its attributes (if the wire format allows it). Its wire format is detected
+   * automatically.
+   * @param payload received payload, which is referenced by the attributes of
+   * the resulting message
+   * @return a message data object
+   * @throws MessagePayloadInvalidException if the payload is not convertible
+   * to a message object
+   */
+  static SharedMessage FromWireFormat(const SharedPayload &payload);
+
+  /**
+   * Generates all message data objects contained in a received payload. In
+   * contrast to FromWireFormat, this also unpacks batches of messages (which
+   * are only sent over connections using the binary wire format).
+   * @param payload received payload, which is referenced by the attributes of
+   * the resulting messages
+   * @return messages contained in the payload
+   * @throws MessagePayloadInvalidException if the payload is not convertible
+   * to message objects
+   */
+  static std::vector<SharedMessage>
+  FromWireFormatBatch(const SharedPayload &payload);
 };
 } // namespace hive::networking::messaging
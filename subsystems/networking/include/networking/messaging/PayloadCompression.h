@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/** HTTP header of the web-socket handshake used to negotiate compression */
+#define PAYLOAD_COMPRESSION_HEADER "X-Hive-Compression"
+
+namespace hive::networking::messaging {
+
+/**
+ * Compression applied to payloads before they are sent over a connection.
+ */
+enum PayloadCompression {
+  /** payloads are sent as they are (always supported) */
+  NO_COMPRESSION,
+  /** large payloads are compressed using deflate (see PayloadCompressor) */
+  DEFLATE
+};
+
+/**
+ * @param compression payload compression
+ * @return name of the compression used during negotiation
+ */
+inline std::string GetPayloadCompressionName(PayloadCompression compression) {
+  switch (compression) {
+  case PayloadCompression::DEFLATE:
+    return "deflate";
+  default:
+    return "none";
+  }
+}
+
+/**
+ * Parses the name of a payload compression (e.g. from the configuration).
+ * @param name name of the compression
+ * @return compression or no compression at all, if the name is unknown
+ */
+inline PayloadCompression GetPayloadCompressionByName(const std::string &name) {
+  if (name == GetPayloadCompressionName(PayloadCompression::DEFLATE)) {
+    return PayloadCompression::DEFLATE;
+  }
+  return PayloadCompression::NO_COMPRESSION;
+}
+
+/**
+ * Decides which compression will be used for a connection. Payloads are only
+ * compressed if both peers support and want it.
+ * @param offered compression offered by the remote peer (may be empty, if the
+ * peer does not negotiate compression at all)
+ * @param preferred compression preferred by this peer
+ * @return compression both peers support
+ */
+inline PayloadCompression
+NegotiatePayloadCompression(const std::string &offered,
+                            PayloadCompression preferred) {
+  if (preferred == PayloadCompression::DEFLATE &&
+      GetPayloadCompressionByName(offered) == PayloadCompression::DEFLATE) {
+    return PayloadCompression::DEFLATE;
+  }
+  return PayloadCompression::NO_COMPRESSION;
+}
+
+/**
+ * Measurements of the payload compression of a single connection.
+ */
+struct CompressionStatistics {
+  /** count of sent payloads that have been compressed */
+  size_t compressed_payloads{0};
+  /** size of compressed payloads before compression */
+  size_t uncompressed_bytes{0};
+  /** size of compressed payloads after compression */
+  size_t compressed_bytes{0};
+  /** time spent compressing payloads */
+  std::chrono::nanoseconds compression_time{0};
+  /** count of received payloads that have been decompressed */
+  size_t decompressed_payloads{0};
+  /** time spent decompressing payloads */
+  std::chrono::nanoseconds decompression_time{0};
+
+  /**
+   * @return size of sent payloads before compression divided by their size
+   * after compression (1 if nothing has been compressed yet)
+   */
+  double GetCompressionRatio() const;
+};
+
+inline double CompressionStatistics::GetCompressionRatio() const {
+  if (compressed_bytes == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(uncompressed_bytes) /
+         static_cast<double>(compressed_bytes);
+}
+
+} // namespace hive::networking::messaging
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common/exceptions/ExceptionsBase.h"
+#include "jobsystem/manager/JobManager.h"
+#include "networking/messaging/PayloadCompression.h"
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <optional>
+#include <string>
+
+namespace hive::networking::messaging {
+
+DECLARE_EXCEPTION(PayloadCompressionException);
+
+/**
+ * Compresses payloads of a single connection using deflate and decompresses
+ * the ones it receives. Payloads below a size threshold are not compressed,
+ * because they would hardly get smaller and the overhead would increase their
+ * latency. The deflate and inflate streams are reused for all payloads, so
+ * their buffers are only allocated once per connection.
+ *
+ * Compressed payloads are prefixed with a header (16 bytes): magic 'HIVZ',
+ * version (uint8), compression (uint8), reserved (uint16), and the size of the
+ * payload before compression (uint64, little-endian).
+ *
+ * @attention Compressing and decompressing is not thread-safe and must be
+ * synchronized by the caller (e.g. by the strand of the connection).
+ * Statistics can be read from any thread.
+ */
+class PayloadCompressor {
+  boost::beast::zlib::deflate_stream m_deflate_stream;
+  boost::beast::zlib::inflate_stream m_inflate_stream;
+
+  /** Payloads smaller than this (in bytes) are not compressed */
+  const size_t m_threshold;
+
+  CompressionStatistics m_statistics;
+  mutable jobsystem::mutex m_statistics_mutex;
+
+public:
+  static constexpr uint8_t c_version = 1;
+  static constexpr size_t c_header_size = 16;
+
+  /**
+   * @param threshold size in bytes from which on payloads are compressed
+   * @param level deflate compression level from 1 (fastest) to 9 (smallest)
+   */
+  PayloadCompressor(size_t threshold, int level);
+
+  /**
+   * Compresses a payload, if it is large enough and actually gets smaller.
+   * @param payload payload that will be sent
+   * @return compressed payload or nothing, if it should be sent uncompressed
+   */
+  std::optional<std::string> Compress(const std::string &payload);
+
+  /**
+   * Decompresses a received payload.
+   * @param payload compressed payload
+   * @return payload as it was before compression
+   * @throws PayloadCompressionException if the payload is corrupt or has been
+   * compressed using an unsupported version or compression.
+   */
+  std::string Decompress(const std::string &payload);
+
+  /**
+   * Checks if a payload has been compressed (by its magic bytes).
+   * @param payload received payload
+   * @return true, if the payload needs to be decompressed
+   */
+  static bool IsCompressed(const std::string &payload);
+
+  /**
+   * @return measurements of all compressions and decompressions so far
+   */
+  CompressionStatistics GetStatistics() const;
+};
+
+inline CompressionStatistics PayloadCompressor::GetStatistics() const {
+  std::unique_lock lock(m_statistics_mutex);
+  return m_statistics;
+}
+
+} // namespace hive::networking::messaging
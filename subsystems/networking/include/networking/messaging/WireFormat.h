@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+/** HTTP header of the web-socket handshake used to negotiate wire formats */
+#define WIRE_FORMAT_HEADER "X-Hive-Wire-Format"
+
+namespace hive::networking::messaging {
+
+/**
+ * Encoding of messages when they are sent over a connection.
+ */
+enum WireFormat {
+  /** textual multipart form-data with a JSON meta part (always supported) */
+  MULTIPART_FORMDATA,
+  /** length-prefixed binary frames (see BinaryMessageConverter) */
+  BINARY
+};
+
+/**
+ * @param format wire format
+ * @return name of the wire format used during negotiation
+ */
+inline std::string GetWireFormatName(WireFormat format) {
+  switch (format) {
+  case WireFormat::BINARY:
+    return "binary";
+  default:
+    return "multipart";
+  }
+}
+
+/**
+ * Parses the name of a wire format (e.g. from the configuration).
+ * @param name name of the wire format
+ * @return wire format or multipart form-data, if the name is unknown
+ */
+inline WireFormat GetWireFormatByName(const std::string &name) {
+  if (name == GetWireFormatName(WireFormat::BINARY)) {
+    return WireFormat::BINARY;
+  }
+  return WireFormat::MULTIPART_FORMDATA;
+}
+
+/**
+ * Decides which wire format will be used for a connection. Multipart
+ * form-data is used, unless both peers support something better.
+ * @param offered wire format offered by the remote peer (may be empty, if the
+ * peer does not negotiate wire formats at all)
+ * @param preferred wire format preferred by this peer
+ * @return wire format both peers support
+ */
+inline WireFormat NegotiateWireFormat(const std::string &offered,
+                                      WireFormat preferred) {
+  if (preferred == WireFormat::BINARY &&
+      GetWireFormatByName(offered) == WireFormat::BINARY) {
+    return WireFormat::BINARY;
+  }
+  return WireFormat::MULTIPART_FORMDATA;
+}
+
+} // namespace hive::networking::messaging
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "common/config/Configuration.h"
+#include "common/exceptions/ExceptionsBase.h"
+#include "jobsystem/manager/JobManager.h"
+#include "networking/messaging/ConnectionInfo.h"
+#include "networking/messaging/Message.h"
+#include <array>
+#include <atomic>
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace hive::networking::messaging::sockets {
+
+/**
+ * Stream socket of any protocol family (e.g. Unix domain or TCP sockets)
+ */
+typedef boost::asio::generic::stream_protocol::socket socket_type;
+
+DECLARE_EXCEPTION(ConnectionClosedException);
+DECLARE_EXCEPTION(MessageSendingException);
+DECLARE_EXCEPTION(SendQueueFullException);
+
+/**
+ * A connection between two endpoints over a plain stream socket. Messages are
+ * sent in the binary wire format as frames, each of which is prefixed by its
+ * length, so there is no framing protocol (like web-sockets) in between.
+ */
+class SocketConnection : public std::enable_shared_from_this<SocketConnection> {
+public:
+  /**
+   * Called when a message has been written or sending it failed
+   * @param error exception, if sending failed (nullptr otherwise)
+   */
+  typedef std::function<void(const std::exception_ptr &error)> SendCallback;
+
+  /**
+   * Called when the handshake has been completed or has failed
+   * @param error_code status of the handshake
+   */
+  typedef std::function<void(const boost::system::error_code &error_code)>
+      HandshakeCallback;
+
+  /** Size of the length prefix of each frame */
+  static constexpr size_t c_frame_header_size = 8;
+
+private:
+  /** Called when a frame has been read (data is nullptr on failure) */
+  typedef std::function<void(const boost::system::error_code &error_code,
+                             SharedPayload data)>
+      FrameCallback;
+
+  /**
+   * Socket connected to the remote endpoint. Its asynchronous operations are
+   * executed on its strand.
+   */
+  socket_type m_socket;
+
+  /** True, until the connection is closed by either side */
+  std::atomic<bool> m_open{true};
+
+  /** Length prefix of the frame that is currently received */
+  std::array<char, c_frame_header_size> m_receive_header{};
+
+  /**
+   * Buffer for the frame that is currently received. It is handed over to the
+   * received message as soon as it is complete, so it is not copied.
+   */
+  std::string m_receive_buffer;
+
+  /** Frames larger than this are rejected and the connection is closed */
+  size_t m_max_frame_size;
+
+  /** Aborts the handshake, if the remote endpoint does not respond */
+  boost::asio::steady_timer m_handshake_timer;
+
+  /** Handshake frame sent to the remote endpoint */
+  std::string m_handshake_frame;
+
+  /**
+   * Message waiting in the send queue of this connection
+   */
+  struct PendingMessage {
+    /** called as soon as the message has been written */
+    SendCallback on_sent;
+    SharedMessage message;
+    /**
+     * message converted into the binary wire format (might be shared with
+     * other connections, so it must not be modified)
+     */
+    SharedPayload data;
+  };
+
+  /**
+   * Messages that are waiting to be written. Multiple of them are written by
+   * a single gathering write on the strand of the socket.
+   */
+  std::deque<PendingMessage> m_send_queue;
+  mutable jobsystem::mutex m_send_queue_mutex;
+
+  /** Total size of all messages in the send queue */
+  size_t m_send_queue_bytes{0};
+
+  /** True, if messages at the front of the send queue are being written */
+  bool m_writing{false};
+
+  /** Count of queued messages after which senders are rejected */
+  size_t m_max_queued_messages;
+
+  /** Total size of queued messages after which senders are rejected */
+  size_t m_max_queued_bytes;
+
+  /** Count of messages at the front of the queue that are being written */
+  size_t m_in_flight_count{0};
+
+  /** Length prefixes of the messages that are being written */
+  std::vector<std::array<char, c_frame_header_size>> m_write_headers;
+
+  /**
+   * Will be called to pass the received data on for further processing
+   */
+  const std::function<void(SharedPayload, std::shared_ptr<SocketConnection>)>
+      m_message_received_callback;
+
+  /**
+   * Will be called when the connection was closed by this or the other
+   * peer
+   */
+  const std::function<void(std::shared_ptr<SocketConnection>)>
+      m_connection_closed_callback;
+
+  /**
+   * Info about this connection. The id of the remote endpoint is set by the
+   * handshake.
+   */
+  ConnectionInfo m_connection_info;
+
+  /**
+   * Reads the next length-prefixed frame from the socket.
+   * @param on_frame called with the frame or an error
+   * @attention Must be called on the strand of the socket.
+   */
+  void AsyncReadFrame(FrameCallback on_frame);
+
+  /**
+   * Reads the next message and processes it on arrival
+   */
+  void AsyncReceiveMessage();
+
+  /**
+   * Called when a frame containing a message has been received
+   * @param error_code indicating if the frame was received successfully
+   * @param data received frame
+   */
+  void OnMessageReceived(const boost::system::error_code &error_code,
+                         SharedPayload data);
+
+  /**
+   * Writes the messages at the front of the send queue with a single
+   * gathering write, i.e. without copying them into a contiguous buffer.
+   * @attention Must be called on the strand of the socket.
+   */
+  void WriteNextMessages();
+
+  /**
+   * Called when the messages at the front of the send queue have been written
+   * (or if that operation has failed). It continues with the next ones.
+   * @param error_code status indicating the success of writing
+   * @param bytes_transferred number of bytes that have been written
+   */
+  void OnMessagesSent(const boost::system::error_code &error_code,
+                      std::size_t bytes_transferred);
+
+public:
+  /**
+   * Constructs a new connection handler
+   * @param connection_info connection specification. The id of the remote
+   * endpoint is set by the handshake.
+   * @param socket connected socket that will be handled by this instance
+   * @param config configuration containing the limits of the send queue
+   * @param on_message_received called when a new message has been received
+   * @param on_connection_closed called when the connection has been closed
+   * @attention The connection neither performs the handshake nor receives
+   * messages automatically (see Handshake and StartReceivingMessages).
+   */
+  SocketConnection(
+      ConnectionInfo connection_info, socket_type &&socket,
+      const common::config::SharedConfiguration &config,
+      std::function<void(SharedPayload, std::shared_ptr<SocketConnection>)>
+          on_message_received,
+      std::function<void(std::shared_ptr<SocketConnection>)>
+          on_connection_closed);
+
+  ~SocketConnection();
+
+  /**
+   * Exchanges the ids of both nodes. Both sides send their handshake frame
+   * right away, so neither has to wait for the other.
+   * @param local_node_id id of this node
+   * @param on_complete called when the handshake has been completed or has
+   * failed
+   */
+  void Handshake(const std::string &local_node_id,
+                 HandshakeCallback on_complete);
+
+  /**
+   * Lets connection listen for incoming messages and processes them on
+   * arrival
+   * @attention Must not be called before the handshake has been completed.
+   */
+  void StartReceivingMessages();
+
+  /**
+   * Closes the socket. Outstanding operations are aborted.
+   */
+  void Close();
+
+  /**
+   * Sends a message to the remote peer through this connection. The message
+   * is queued and written asynchronously, so the caller is never blocked by
+   * network I/O.
+   * @param message message that will be sent
+   * @return future that is resolved when the message has been written. It
+   * contains a SendQueueFullException, if too many messages are waiting to
+   * be written (backpressure), or a MessageSendingException, if writing
+   * failed.
+   * @throws ConnectionClosedException if the connection is not open
+   */
+  std::future<void> Send(const SharedMessage &message);
+
+  /**
+   * Sends a message that has already been converted into the binary wire
+   * format. This allows converting a message sent to multiple nodes (e.g.
+   * broadcasts) only once.
+   * @param message message that will be sent
+   * @param data message in the binary wire format
+   * @param on_sent called when the message has been written or sending it
+   * failed (e.g. SendQueueFullException or MessageSendingException)
+   * @throws ConnectionClosedException if the connection is not open
+   */
+  void Send(const SharedMessage &message, SharedPayload data,
+            SendCallback on_sent);
+
+  /**
+   * @return count of messages waiting to be written
+   */
+  size_t GetQueuedMessageCount() const;
+
+  /**
+   * @return true, if the connection can be used for sending/receiving messages
+   */
+  bool IsUsable() const;
+
+  const ConnectionInfo &GetInfo() const;
+};
+
+inline bool SocketConnection::IsUsable() const { return m_open; }
+
+inline size_t SocketConnection::GetQueuedMessageCount() const {
+  std::unique_lock lock(m_send_queue_mutex);
+  return m_send_queue.size();
+}
+
+inline const ConnectionInfo &SocketConnection::GetInfo() const {
+  return m_connection_info;
+}
+
+typedef std::shared_ptr<SocketConnection> SharedSocketConnection;
+
+} // namespace hive::networking::messaging::sockets
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "SocketConnection.h"
+#include "common/memory/ExclusiveOwnership.h"
+#include "common/subsystems/SubsystemManager.h"
+#include "jobsystem/manager/JobManager.h"
+#include "networking/messaging/IMessageEndpoint.h"
+#include "networking/messaging/streams/MessageStreamMultiplexer.h"
+#include "networking/util/ExecutionContextPool.h"
+#include <atomic>
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <map>
+#include <optional>
+
+namespace hive::networking::messaging::sockets {
+
+DECLARE_EXCEPTION(NoSuchEndpointException);
+DECLARE_EXCEPTION(UrlMalformedException);
+DECLARE_EXCEPTION(ConnectionFailedException);
+
+/**
+ * Endpoint communicating over plain stream sockets (see SocketConnection).
+ * Implementations only decide which kind of socket is used by providing the
+ * local endpoint to listen on and by resolving URIs of remote endpoints.
+ * @attention Implementations must shut down a running endpoint in their
+ * destructor, because execution threads call their overrides.
+ */
+class SocketEndpoint : public IMessageEndpoint {
+public:
+  typedef boost::asio::generic::stream_protocol::endpoint endpoint_type;
+  typedef boost::asio::basic_socket_acceptor<
+      boost::asio::generic::stream_protocol>
+      acceptor_type;
+
+  /**
+   * Receives the resolved endpoint or, if resolving has failed, the exception
+   * describing why.
+   */
+  typedef std::function<void(std::exception_ptr, endpoint_type)>
+      resolve_handler_type;
+
+protected:
+  common::memory::Reference<common::subsystems::SubsystemManager> m_subsystems;
+  common::config::SharedConfiguration m_config;
+
+  /**
+   * @return endpoint this endpoint accepts connections on
+   * @throws EndpointSetupException if it cannot be determined
+   */
+  virtual endpoint_type GetLocalEndpoint() const = 0;
+
+  /**
+   * Resolves the URI of some remote endpoint without blocking the caller.
+   * @param uri URI passed to EstablishConnectionTo
+   * @param executor executor of the socket that will connect to the endpoint
+   * @param on_resolved called with the endpoint to connect to or with an
+   * UrlMalformedException, if the URI cannot be resolved. It might be called
+   * before this function returns.
+   */
+  virtual void ResolveEndpoint(const std::string &uri,
+                               const socket_type::executor_type &executor,
+                               resolve_handler_type on_resolved) const = 0;
+
+  /**
+   * Applies options to a connected socket before it is used.
+   * @param socket newly accepted or connected socket
+   */
+  virtual void ConfigureSocket([[maybe_unused]] socket_type &socket) const {}
+
+  /**
+   * @return true, if the endpoint has been started and not shut down yet
+   */
+  bool IsRunning() const;
+
+private:
+  /** Indicates if the endpoint is currently running */
+  std::atomic<bool> m_running{false};
+
+  /** Id of this node, which is sent to others during the handshake */
+  std::string m_node_id;
+
+  /** Threads executing the asynchronous operations of the sockets */
+  std::shared_ptr<util::ExecutionContextPool> m_execution_contexts;
+
+  /**
+   * Routes fragments and credit of message streams from and to this node.
+   * @note Declared before the connections, which outlive it otherwise and
+   * abort its streams when they are closed.
+   */
+  std::shared_ptr<streams::MessageStreamMultiplexer> m_streams;
+
+  /** Accepts connections of other nodes */
+  std::unique_ptr<acceptor_type> m_acceptor;
+
+  /**
+   * Maps node ids to the connection established with the node.
+   */
+  std::map<std::string, SharedSocketConnection> m_connections;
+  mutable jobsystem::mutex m_connections_mutex;
+
+  /**
+   * Creates a connection for a connected socket and performs the handshake.
+   * @param socket connected socket
+   * @param hostname used to identify the remote endpoint in logs
+   * @param on_complete called with the connection, as soon as the handshake
+   * has been completed (or nullptr, if it failed)
+   */
+  void StartHandshake(
+      socket_type &&socket, const std::string &hostname,
+      std::function<void(const SharedSocketConnection &)> on_complete);
+
+  /**
+   * Connects a socket to a resolved remote endpoint and performs the
+   * handshake.
+   * @param socket unconnected socket
+   * @param remote_endpoint endpoint to connect to
+   * @param uri URI passed to EstablishConnectionTo
+   * @param promise receives the connection info or the reason of the failure
+   */
+  void ConnectTo(const std::shared_ptr<socket_type> &socket,
+                 const endpoint_type &remote_endpoint, const std::string &uri,
+                 const std::shared_ptr<std::promise<ConnectionInfo>> &promise);
+
+  /** Waits for the next connection of another node */
+  void AcceptConnection();
+
+  /**
+   * Registers a connection after its handshake has been completed.
+   * @param connection connection ready to use
+   */
+  void AddConnection(const SharedSocketConnection &connection);
+
+  std::optional<SharedSocketConnection>
+  GetConnection(const std::string &node_id) const;
+
+  /**
+   * Converts a received payload into messages and passes them on to the
+   * stream multiplexer or the networking manager.
+   * @param data received payload
+   * @param over_connection connection the payload has been received over
+   */
+  void ProcessReceivedMessage(SharedPayload data,
+                              const SharedSocketConnection &over_connection);
+
+  void OnConnectionClose(const SharedSocketConnection &connection);
+
+public:
+  SocketEndpoint(
+      const common::memory::Reference<common::subsystems::SubsystemManager>
+          &subsystems,
+      common::config::SharedConfiguration config);
+
+  ~SocketEndpoint() override;
+
+  void Startup() override;
+  void Shutdown() override;
+
+  std::future<void> Send(const std::string &node_id,
+                         SharedMessage message) override;
+
+  std::future<ConnectionInfo>
+  EstablishConnectionTo(const std::string &uri) override;
+
+  void CloseConnectionTo(const std::string &node_id) override;
+
+  streams::SharedMessageStreamWriter
+  OpenStream(const std::string &node_id,
+             const std::string &stream_type) override;
+
+  std::future<size_t>
+  IssueBroadcastAsJob(const SharedMessage &message) override;
+
+  std::future<BroadcastResult>
+  Broadcast(const SharedMessage &message) override;
+
+  bool HasConnectionTo(const std::string &node_id) const override;
+
+  size_t GetActiveConnectionCount() const override;
+};
+
+inline bool SocketEndpoint::IsRunning() const { return m_running; }
+
+} // namespace hive::networking::messaging::sockets
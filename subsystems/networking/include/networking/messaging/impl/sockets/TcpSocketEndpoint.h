@@ -0,0 +1,32 @@
+#pragma once
+
+#include "SocketEndpoint.h"
+
+namespace hive::networking::messaging::sockets {
+
+/**
+ * Endpoint for traffic inside the cluster over plain TCP connections. In
+ * contrast to web-sockets, there is neither an HTTP upgrade handshake nor
+ * web-socket framing or masking of each frame. URIs of remote endpoints have
+ * the form tcp://<host>:<port>.
+ */
+class TcpSocketEndpoint : public SocketEndpoint {
+protected:
+  endpoint_type GetLocalEndpoint() const override;
+  void ResolveEndpoint(const std::string &uri,
+                       const socket_type::executor_type &executor,
+                       resolve_handler_type on_resolved) const override;
+  void ConfigureSocket(socket_type &socket) const override;
+
+public:
+  TcpSocketEndpoint(
+      const common::memory::Reference<common::subsystems::SubsystemManager>
+          &subsystems,
+      common::config::SharedConfiguration config);
+
+  ~TcpSocketEndpoint() override;
+
+  std::string GetProtocol() const override;
+};
+
+} // namespace hive::networking::messaging::sockets
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "SocketEndpoint.h"
+
+namespace hive::networking::messaging::sockets {
+
+/**
+ * Endpoint for nodes running on the same host. It communicates over Unix
+ * domain sockets, which bypass the network stack (no TCP/IP, checksums or
+ * web-socket framing), so large payloads are handed over at memory speed.
+ * URIs of remote endpoints are paths of their socket files, optionally
+ * prefixed by "shm://" (e.g. shm:///tmp/hive-9000.sock).
+ * @note Only available on platforms supporting Unix domain sockets.
+ */
+class UnixSocketEndpoint : public SocketEndpoint {
+  /** Path of the socket file this endpoint accepts connections on */
+  std::string m_socket_path;
+
+  /** True, if this endpoint has created the socket file */
+  bool m_owns_socket_file{false};
+
+  /** Removes the socket file, if it has been created by this endpoint */
+  void RemoveSocketFile();
+
+protected:
+  endpoint_type GetLocalEndpoint() const override;
+  void ResolveEndpoint(const std::string &uri,
+                       const socket_type::executor_type &executor,
+                       resolve_handler_type on_resolved) const override;
+
+public:
+  UnixSocketEndpoint(
+      const common::memory::Reference<common::subsystems::SubsystemManager>
+          &subsystems,
+      common::config::SharedConfiguration config);
+
+  ~UnixSocketEndpoint() override;
+
+  void Startup() override;
+  void Shutdown() override;
+  std::string GetProtocol() const override;
+
+  /**
+   * @return path of the socket file this endpoint accepts connections on
+   */
+  const std::string &GetSocketPath() const;
+};
+
+inline const std::string &UnixSocketEndpoint::GetSocketPath() const {
+  return m_socket_path;
+}
+
+} // namespace hive::networking::messaging::sockets
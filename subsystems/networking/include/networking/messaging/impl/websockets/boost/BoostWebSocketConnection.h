@@ -1,13 +1,20 @@
 #pragma once
 
+#include "common/config/Configuration.h"
 #include "common/exceptions/ExceptionsBase.h"
 #include "jobsystem/manager/JobManager.h"
 #include "networking/messaging/ConnectionInfo.h"
 #include "networking/messaging/Message.h"
+#include "networking/messaging/PayloadCompressor.h"
+#include <boost/asio/steady_timer.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <future>
 #include <memory>
+#include <optional>
 
 namespace hive::networking::messaging::websockets {
 
@@ -15,28 +22,116 @@ typedef boost::beast::websocket::stream<boost::beast::tcp_stream> stream_type;
 
 DECLARE_EXCEPTION(ConnectionClosedException);
 DECLARE_EXCEPTION(MessageSendingException);
+DECLARE_EXCEPTION(SendQueueFullException);
 
 /**
  * A connection between two endpoints realized using Boost.Beast websockets.
  */
 class BoostWebSocketConnection
     : public std::enable_shared_from_this<BoostWebSocketConnection> {
+public:
+  /**
+   * Called when a message has been written or sending it failed
+   * @param error exception, if sending failed (nullptr otherwise)
+   */
+  typedef std::function<void(const std::exception_ptr &error)> SendCallback;
+
 private:
   /**
    * TCP stream that allows interaction with the communication partner.
+   * @attention It must only be used on its strand, because asynchronous
+   * reads and writes may be in progress.
    */
   stream_type m_web_socket_stream;
-  mutable jobsystem::recursive_mutex m_web_socket_stream_mutex;
 
   /**
-   * Buffer for received messages
+   * True, until the connection is closed by either side. This is tracked
+   * separately, so other threads never have to query the stream.
+   */
+  std::atomic<bool> m_open{true};
+
+  /**
+   * Buffer for the message that is currently received. It is handed over to
+   * the received message (which slices its attributes from it) as soon as it
+   * is complete, so received data is not copied after reading it.
+   */
+  std::string m_receive_buffer;
+
+  /** Allows the web-socket stream to read into the receive buffer */
+  std::optional<boost::asio::dynamic_string_buffer<
+      char, std::char_traits<char>, std::allocator<char>>>
+      m_receive_dynamic_buffer;
+
+  /**
+   * True, if no further message is read until ResumeReceiving is called. It is
+   * only accessed on the strand of the web-socket stream.
+   */
+  bool m_receive_paused{false};
+
+  /**
+   * Message waiting in the send queue of this connection
    */
-  boost::beast::flat_buffer m_receive_buffer;
+  struct PendingMessage {
+    /** called as soon as the message has been written */
+    SendCallback on_sent;
+    SharedMessage message;
+    /**
+     * message converted into the negotiated wire format (might be shared with
+     * other connections, so it must not be modified)
+     */
+    SharedPayload data;
+  };
+
+  /**
+   * Messages that are waiting to be written. They are written one after
+   * another by async_write calls on the strand of the web-socket stream.
+   */
+  std::deque<PendingMessage> m_send_queue;
+  mutable jobsystem::mutex m_send_queue_mutex;
+
+  /** Total size of all messages in the send queue */
+  size_t m_send_queue_bytes{0};
+
+  /** True, if the front of the send queue is currently being written */
+  bool m_writing{false};
+
+  /** Count of queued messages after which senders are rejected */
+  size_t m_max_queued_messages;
+
+  /** Total size of queued messages after which senders are rejected */
+  size_t m_max_queued_bytes;
+
+  /** Count of messages at the front of the queue that are being written */
+  size_t m_in_flight_count{0};
+
+  /**
+   * Maximum size of a batch of messages written as a single web-socket
+   * message. Batching is disabled if zero.
+   */
+  size_t m_batch_max_bytes;
+
+  /**
+   * Time the writer waits for more messages to batch before writing, if the
+   * send queue was empty.
+   */
+  std::chrono::milliseconds m_batch_window;
+
+  /** Expires when the batch window has elapsed */
+  boost::asio::steady_timer m_batch_timer;
+
+  /** True, if the writer is currently waiting for the batch window */
+  bool m_batch_timer_pending{false};
+
+  /**
+   * Compresses sent and decompresses received payloads (if compression has
+   * been negotiated). It is only used on the strand of the web-socket stream.
+   */
+  PayloadCompressor m_compressor;
 
   /**
    * Will be called to pass the received data on for further processing
    */
-  const std::function<void(const std::string &,
+  const std::function<void(SharedPayload,
                            std::shared_ptr<BoostWebSocketConnection>)>
       m_message_received_callback;
 
@@ -71,18 +166,42 @@ private:
                          [[maybe_unused]] std::size_t bytes_transferred);
 
   /**
-   * Callback function that will be called when a message has been sent to some
-   * remote host (or if that operation has failed)
-   * @param promise promise that must be resolved
-   * @param message message that was sent (or maybe not)
-   * @param sent_data data that has been sent to the other peer.
-   * @param lock locks the async_write call and must be unlocked
+   * @return true, if messages are batched on this connection. Batches can only
+   * be received by nodes supporting the binary wire format.
+   */
+  bool IsBatching() const;
+
+  /**
+   * Writes the message at the front of the send queue asynchronously. If
+   * batching is enabled, following queued messages are packed into the same
+   * web-socket message until the batch size is reached.
+   * @attention Must be called on the strand of the web-socket stream.
+   */
+  void WriteNextMessage();
+
+  /**
+   * Waits for the batch window before writing, so more messages can be
+   * batched.
+   * @attention Must be called on the strand of the web-socket stream.
+   */
+  void StartBatchWindow();
+
+  /**
+   * Called when the batch window has elapsed or has been cut short, because
+   * some message must be sent right away.
+   * @param error_code status of the timer
+   */
+  void OnBatchWindowElapsed(boost::beast::error_code error_code);
+
+  /**
+   * Callback function that will be called when the messages at the front of
+   * the send queue have been written (or if that operation has failed). It
+   * continues with the next queued messages.
+   * @param sent_data data that has been written (a single message or a batch)
    * @param error_code status indicating the success of sending the message
    * @param bytes_transferred number of bytes that have been sent
    */
-  void OnMessageSent(std::promise<void> &&promise, SharedMessage message,
-                     std::shared_ptr<std::string> sent_data,
-                     std::unique_lock<jobsystem::recursive_mutex> lock,
+  void OnMessageSent(SharedPayload sent_data,
                      boost::beast::error_code error_code,
                      [[maybe_unused]] std::size_t bytes_transferred);
 
@@ -96,12 +215,15 @@ public:
    * @param connection_info connection specification.
    * @param web_socket_stream web-socket stream that will be handled by this
    * instance.
+   * @param config configuration containing the limits of the send queue,
+   * batching and compression settings
    * @attention The newly constructed connection won't automatically listen to
    * incoming events. This can be started by calling StartReceivingMessages.
    */
   BoostWebSocketConnection(
       ConnectionInfo connection_info, stream_type &&web_socket_stream,
-      std::function<void(const std::string &,
+      const common::config::SharedConfiguration &config,
+      std::function<void(SharedPayload,
                          std::shared_ptr<BoostWebSocketConnection>)>
           on_message_received,
       std::function<void(const std::string &)> on_connection_closed);
@@ -120,17 +242,68 @@ public:
   void StartReceivingMessages();
 
   /**
-   * Closes the web-socket connection and the underlying tcp stream
+   * Stops reading messages after the current one, so it can be processed on
+   * another thread without losing the order of received messages.
+   * @attention Must only be called by the callback receiving messages.
+   */
+  void PauseReceiving();
+
+  /**
+   * Continues reading messages after PauseReceiving has been called.
+   */
+  void ResumeReceiving();
+
+  /**
+   * Closes the web-socket connection and the underlying tcp stream. The
+   * connection is unusable right away, while the closing handshake is
+   * performed asynchronously on the strand of the stream.
+   * @note The closed-callback is invoked only once and without holding any
+   * lock of this connection.
    */
   void Close();
 
   /**
-   * Sends a message to the remote peer through this connection.
+   * Sends a message to the remote peer through this connection. The message
+   * is queued and written asynchronously, so the caller is never blocked by
+   * network I/O.
    * @param message web-socket message that will be sent
-   * @return future indicating that the message has been sent
+   * @return future that is resolved when the message has been written. It
+   * contains a SendQueueFullException, if too many messages are waiting to
+   * be written (backpressure), or a MessageSendingException, if writing
+   * failed.
+   * @throws ConnectionClosedException if the connection is not open
    */
   std::future<void> Send(const SharedMessage &message);
 
+  /**
+   * Sends a message that has already been converted into the wire format of
+   * this connection. This allows converting a message sent to multiple nodes
+   * (e.g. broadcasts) only once.
+   * @param message message that will be sent
+   * @param data message in the wire format of this connection (see GetInfo)
+   * @param on_sent called when the message has been written or sending it
+   * failed (e.g. SendQueueFullException or MessageSendingException)
+   * @throws ConnectionClosedException if the connection is not open
+   */
+  void Send(const SharedMessage &message, SharedPayload data,
+            SendCallback on_sent);
+
+  /**
+   * @return count of messages waiting to be written
+   */
+  size_t GetQueuedMessageCount() const;
+
+  /**
+   * @return total size of all messages waiting to be written in bytes
+   */
+  size_t GetQueuedBytes() const;
+
+  /**
+   * @return compression ratio and time spent compressing and decompressing
+   * payloads of this connection
+   */
+  CompressionStatistics GetCompressionStatistics() const;
+
   /**
    * @return address of the connected remote endpoint
    */
@@ -140,6 +313,8 @@ public:
    * Checks if the connected endpoint is reachable, i.e. if the connection is
    * still standing.
    * @return true, if the connection can be used for sending/receiving events
+   * @note Does not acquire any lock, so it can be called while holding locks
+   * of the endpoint.
    */
   bool IsUsable() const;
 
@@ -151,9 +326,26 @@ inline std::string BoostWebSocketConnection::GetRemoteHostAddress() const {
          std::to_string(m_remote_endpoint_info.port());
 }
 
-inline bool BoostWebSocketConnection::IsUsable() const {
-  std::unique_lock lock(m_web_socket_stream_mutex);
-  return m_web_socket_stream.is_open();
+inline bool BoostWebSocketConnection::IsUsable() const { return m_open; }
+
+inline bool BoostWebSocketConnection::IsBatching() const {
+  return m_batch_max_bytes > 0 &&
+         m_connection_info.wire_format == WireFormat::BINARY;
+}
+
+inline size_t BoostWebSocketConnection::GetQueuedMessageCount() const {
+  std::unique_lock lock(m_send_queue_mutex);
+  return m_send_queue.size();
+}
+
+inline size_t BoostWebSocketConnection::GetQueuedBytes() const {
+  std::unique_lock lock(m_send_queue_mutex);
+  return m_send_queue_bytes;
+}
+
+inline CompressionStatistics
+BoostWebSocketConnection::GetCompressionStatistics() const {
+  return m_compressor.GetStatistics();
 }
 
 inline const ConnectionInfo &BoostWebSocketConnection::GetInfo() const {
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "BoostWebSocketConnection.h"
+#include "common/config/Configuration.h"
 #include "common/exceptions/ExceptionsBase.h"
+#include "networking/messaging/PayloadCompression.h"
+#include "networking/messaging/WireFormat.h"
+#include "networking/util/ExecutionContextPool.h"
 #include <boost/asio.hpp>
 #include <future>
 
@@ -19,11 +23,17 @@ DECLARE_EXCEPTION(ConnectionFailedException);
 class BoostWebSocketConnectionEstablisher
     : public std::enable_shared_from_this<BoostWebSocketConnectionEstablisher> {
 private:
-  std::shared_ptr<boost::asio::io_context> m_execution_context;
+  std::shared_ptr<util::ExecutionContextPool> m_execution_contexts;
 
   /** Unique ID of this node / endpoint required for their handshake */
   std::string m_this_node_uuid;
 
+  /** wire format offered to the remote node during the handshake */
+  WireFormat m_preferred_wire_format;
+
+  /** payload compression offered to the remote node during the handshake */
+  PayloadCompression m_preferred_compression;
+
   /**
    * Resolves IP addresses from given hostnames
    */
@@ -78,13 +88,15 @@ private:
    * of the process.
    * @param uri URI of the remote endpoint
    * @param web_socket_stream upgraded web-socket stream
+   * @param upgrade_response HTTP response of the remote endpoint containing
+   * the negotiated wire format
    * @param error_code result of the web-socket handshake attempt
    */
-  void
-  ProcessWebSocketHandshake(std::promise<ConnectionInfo> &&connection_promise,
-                            std::string uri,
-                            std::shared_ptr<stream_type> web_socket_stream,
-                            boost::beast::error_code error_code);
+  void ProcessWebSocketHandshake(
+      std::promise<ConnectionInfo> &&connection_promise, std::string uri,
+      std::shared_ptr<stream_type> web_socket_stream,
+      std::shared_ptr<boost::beast::websocket::response_type> upgrade_response,
+      boost::beast::error_code error_code);
 
   /**
    * After the web-socket handshake has been performed and a stable stream
@@ -110,7 +122,8 @@ private:
 public:
   BoostWebSocketConnectionEstablisher(
       std::string this_node_uuid,
-      std::shared_ptr<boost::asio::io_context> execution_context,
+      std::shared_ptr<util::ExecutionContextPool> execution_contexts,
+      const common::config::SharedConfiguration &config,
       std::function<void(ConnectionInfo, stream_type &&)> connection_consumer);
 
   /**
@@ -3,6 +3,9 @@
 #include "BoostWebSocketConnection.h"
 #include "common/config/Configuration.h"
 #include "common/exceptions/ExceptionsBase.h"
+#include "networking/messaging/PayloadCompression.h"
+#include "networking/messaging/WireFormat.h"
+#include "networking/util/ExecutionContextPool.h"
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <functional>
@@ -12,6 +15,9 @@ namespace hive::networking::messaging::websockets {
 
 DECLARE_EXCEPTION(WebSocketTcpServerException);
 
+typedef boost::beast::http::request<boost::beast::http::string_body>
+    upgrade_request_type;
+
 /**
  * Listens to incoming connections and upgrades them to the web-socket
  * protocol.
@@ -29,7 +35,7 @@ private:
   /**
    * Used to create new execution strands for asynchronous operations
    */
-  std::shared_ptr<boost::asio::io_context> m_execution_context;
+  std::shared_ptr<util::ExecutionContextPool> m_execution_contexts;
 
   /**
    * Configuration of this connection listener and possibly other subsystems
@@ -37,11 +43,18 @@ private:
   common::config::SharedConfiguration m_config;
 
   /**
-   * Purpose of this component is listening and accepting incoming
-   * connections
+   * Purpose of these components is listening and accepting incoming
+   * connections. There is either a single acceptor or one per execution
+   * context (sharing the port using SO_REUSEPORT).
    */
-  std::unique_ptr<boost::asio::ip::tcp::acceptor>
-      m_incoming_tcp_connection_acceptor;
+  std::vector<std::unique_ptr<boost::asio::ip::tcp::acceptor>>
+      m_incoming_tcp_connection_acceptors;
+
+  /**
+   * True, if each execution context has its own acceptor, so accepted
+   * connections are already pinned to the context of their acceptor.
+   */
+  bool m_sharded_acceptors{false};
 
   /**
    * Defines the endpoint configuration of this host (port, address,
@@ -52,14 +65,38 @@ private:
   /** UUID of this node in the hive required for node handshake */
   const std::string m_this_node_uuid;
 
+  /** wire format used if the remote node supports it as well */
+  WireFormat m_preferred_wire_format;
+
+  /** payload compression used if the remote node supports it as well */
+  PayloadCompression m_preferred_compression;
+
+  /**
+   * Opens an acceptor listening on the local endpoint.
+   * @param execution_context context executing operations of the acceptor
+   * @param reuse_port if true, other acceptors can listen on the same port
+   * @return acceptor listening for incoming connections
+   * @throws WebSocketTcpServerException if the acceptor cannot be opened
+   */
+  std::unique_ptr<boost::asio::ip::tcp::acceptor>
+  OpenAcceptor(boost::asio::io_context &execution_context, bool reuse_port);
+
+  /**
+   * Asynchronously accepts the next TCP connection using an acceptor.
+   * @param acceptor_index index of the acceptor
+   */
+  void AcceptConnection(size_t acceptor_index);
+
   /**
    * After a TCP connection has been established with a client, the
    * web-socket handshake must commence to upgrade the protocol.
    * @note This is step 2 of the connection process
+   * @param acceptor_index index of the acceptor that accepted the connection
    * @param error_code indicating success of establishing TCP connection
    * @param socket new TCP socket that will be used in further steps
    */
-  void ProcessTcpConnection(boost::beast::error_code error_code,
+  void ProcessTcpConnection(size_t acceptor_index,
+                            boost::beast::error_code error_code,
                             boost::asio::ip::tcp::socket socket);
 
   /**
@@ -68,15 +105,33 @@ private:
    */
   void PerformWebSocketHandshake(std::shared_ptr<stream_type> plain_tcp_stream);
 
+  /**
+   * The HTTP upgrade request of the web-socket handshake is read before
+   * accepting it, because it contains the wire formats offered by the client.
+   * @param plain_tcp_stream established TCP connection
+   * @param request_buffer buffer the request has been read into
+   * @param upgrade_request received HTTP upgrade request
+   * @param ec error code indicating if the request has been read
+   * @param bytes_transferred size of the request
+   */
+  void ProcessUpgradeRequest(
+      std::shared_ptr<stream_type> plain_tcp_stream,
+      std::shared_ptr<boost::beast::flat_buffer> request_buffer,
+      std::shared_ptr<upgrade_request_type> upgrade_request,
+      boost::beast::error_code ec, std::size_t bytes_transferred);
+
   /**
    * After the web-socket handshake has been performed, the resulting
    * connection must be processed for further use.
    * @note This is step 3 of the connection process
    * @param web_socket_stream TCP connection over which the web-socket handshake
    * has been performed
+   * @param connection_info settings negotiated during the handshake (e.g. the
+   * wire format)
    * @param ec error code indicating the handshake's success
    */
   void ProcessWebSocketHandshake(std::shared_ptr<stream_type> web_socket_stream,
+                                 ConnectionInfo connection_info,
                                  boost::beast::error_code ec);
 
   void ProcessNodeHandshakeRequest(
@@ -88,7 +143,7 @@ private:
 public:
   BoostWebSocketConnectionListener(
       std::string this_node_uuid,
-      std::shared_ptr<boost::asio::io_context> execution_context,
+      std::shared_ptr<util::ExecutionContextPool> execution_contexts,
       common::config::SharedConfiguration config,
       std::shared_ptr<boost::asio::ip::tcp::endpoint> local_endpoint,
       std::function<void(ConnectionInfo, stream_type &&)> connection_consumer);
@@ -97,15 +152,16 @@ public:
 
   /**
    * Initializes listener and further components which are necessary for
-   * accepting TCP connections.
+   * accepting TCP connections. If configured (net.server.reuse-port), each
+   * execution context gets its own acceptor.
    * @attention After this call, this endpoint does provide an open port for TCP
    * connections, but it does not accept/process them yet.
    */
   void Init();
 
   /**
-   * Asynchronously accept and wait for new TCP connection to establish
-   * Web-socket connections.
+   * Asynchronously accept and wait for new TCP connections (on all acceptors)
+   * to establish Web-socket connections.
    * @note This must be called in order to incoming connections to be processed
    * and eventually converted into web-socket connections.
    */
@@ -7,6 +7,9 @@
 #include "common/subsystems/SubsystemManager.h"
 #include "jobsystem/manager/JobManager.h"
 #include "networking/messaging/IMessageEndpoint.h"
+#include "networking/messaging/streams/MessageStreamMultiplexer.h"
+#include "networking/util/ExecutionContextPool.h"
+#include <atomic>
 #include <list>
 #include <map>
 
@@ -14,6 +17,16 @@ namespace hive::networking::messaging::websockets {
 
 DECLARE_EXCEPTION(NoSuchEndpointException);
 
+/**
+ * Strategy for distributing messages across the data lanes of a node
+ */
+enum class LaneStriping {
+  /** data lanes are used in turns */
+  ROUND_ROBIN,
+  /** the data lane with the fewest queued bytes is used */
+  QUEUED_BYTES
+};
+
 /**
  * This implementation of IWebSocketServer uses WebSocket++ to provide
  * a web-socket communication peer.
@@ -26,8 +39,13 @@ class BoostWebSocketEndpoint
    * @note The endpoint is not automatically initialized, except the
    * configuration says so.
    */
-  bool m_running{false};
-  mutable jobsystem::recursive_mutex m_running_mutex;
+  std::atomic<bool> m_running{false};
+
+  /**
+   * Received payloads of at least this size are decoded and dispatched by a
+   * job instead of the I/O thread that received them. Disabled if zero.
+   */
+  size_t m_offload_threshold{0};
 
   common::memory::Reference<common::subsystems::SubsystemManager> m_subsystems;
   common::config::SharedConfiguration m_config;
@@ -40,24 +58,53 @@ class BoostWebSocketEndpoint
 
   /**
    * Acts as execution environment for asynchronous operations, such as
-   * receiving events
+   * receiving events. Depending on the configuration, each of its threads
+   * runs its own io_context (net.threads.context-per-thread).
    */
-  std::shared_ptr<boost::asio::io_context> m_execution_context;
+  std::shared_ptr<util::ExecutionContextPool> m_execution_contexts;
 
   /**
-   * Maps host addresses to the connection established with the host.
+   * Routes fragments and credit of message streams from and to this node.
+   * @note Declared before the connections, which outlive it otherwise and
+   * abort its streams when they are closed.
    */
-  std::map<std::string, SharedBoostWebSocketConnection> m_connections;
-  mutable jobsystem::recursive_mutex m_connections_mutex;
+  std::shared_ptr<streams::MessageStreamMultiplexer> m_streams;
 
-  std::shared_ptr<BoostWebSocketConnectionEstablisher> m_connection_establisher;
-  std::shared_ptr<BoostWebSocketConnectionListener> m_connection_listener;
+  /**
+   * Connections established with a single node. Large messages are striped
+   * across its data lanes, while small ones can use a dedicated control lane,
+   * so they are not held up by large ones (head-of-line blocking).
+   */
+  struct ConnectionPool {
+    /** connections in the order they have been registered */
+    std::vector<SharedBoostWebSocketConnection> connections;
+    /** used to pick data lanes in turns */
+    size_t next_lane{0};
+  };
 
   /**
-   * Thread pool that executes asynchronous callbacks certain websocket
-   * events
+   * Maps node ids to the connections established with the node.
+   * @attention Connections must not be closed while holding the mutex, because
+   * they notify this endpoint (see OnConnectionClose), which acquires it again
+   * and might be called with other locks held.
    */
-  std::vector<std::thread> m_execution_threads;
+  std::map<std::string, ConnectionPool> m_connections;
+  mutable jobsystem::recursive_mutex m_connections_mutex;
+
+  /** Count of connections per node that carry large messages */
+  size_t m_data_lanes{1};
+
+  /** True, if small messages are sent over an additional connection */
+  bool m_control_lane{false};
+
+  /** Messages up to this size are sent over the control lane */
+  size_t m_control_lane_max_bytes{0};
+
+  /** Distribution of messages across data lanes */
+  LaneStriping m_striping{LaneStriping::ROUND_ROBIN};
+
+  std::shared_ptr<BoostWebSocketConnectionEstablisher> m_connection_establisher;
+  std::shared_ptr<BoostWebSocketConnectionListener> m_connection_listener;
 
   /**
    * This is the local endpoint over which the peer should communicate
@@ -76,11 +123,32 @@ class BoostWebSocketEndpoint
   void AddConnection(const ConnectionInfo &connection_info,
                      stream_type &&stream);
 
+  /**
+   * @return count of connections established with each node
+   */
+  size_t GetPoolSize() const;
+
+  /**
+   * Picks the connection to a node over which a message is sent. Messages of
+   * a stream always use the same data lane to keep them in order.
+   * @param node_id id of the receiving node
+   * @param message message that will be sent
+   * @return usable connection or nothing, if there is none
+   */
   std::optional<SharedBoostWebSocketConnection>
-  GetConnection(const std::string &connection_id);
+  SelectConnection(const std::string &node_id, const SharedMessage &message);
 
   void
-  ProcessReceivedMessage(const std::string &data,
+  ProcessReceivedMessage(SharedPayload data,
+                         const SharedBoostWebSocketConnection &over_connection);
+
+  /**
+   * Converts a received payload into messages and passes them on to the
+   * stream multiplexer or the networking manager.
+   * @param data received payload
+   * @param over_connection connection the payload has been received over
+   */
+  void DecodeAndDispatch(const SharedPayload &data,
                          const SharedBoostWebSocketConnection &over_connection);
 
   void InitAndStartConnectionListener();
@@ -88,6 +156,11 @@ class BoostWebSocketEndpoint
 
   void SetupCleanUpJob();
 
+  /**
+   * Called by closed connections. Fires a ConnectionClosedEvent and aborts the
+   * streams of the node, as soon as its last lane has been closed.
+   * @param id id of the node the connection has been established with
+   */
   void OnConnectionClose(const std::string &id);
 
 public:
@@ -110,11 +183,39 @@ public:
 
   void CloseConnectionTo(const std::string &node_id) override;
 
+  streams::SharedMessageStreamWriter
+  OpenStream(const std::string &node_id,
+             const std::string &stream_type) override;
+
   std::future<size_t>
   IssueBroadcastAsJob(const SharedMessage &message) override;
 
+  std::future<BroadcastResult>
+  Broadcast(const SharedMessage &message) override;
+
   bool HasConnectionTo(const std::string &node_id) const override;
 
+  /**
+   * @return count of nodes connected by at least one usable connection
+   */
   size_t GetActiveConnectionCount() const override;
+
+  /**
+   * @param node_id id of the connected node
+   * @return count of usable connections (lanes) to the node
+   */
+  size_t GetLaneCount(const std::string &node_id) const;
+
+  /**
+   * Measurements of the payload compression of the connection to some node.
+   * @param node_id id of the connected node
+   * @return statistics or nothing, if there is no connection to the node
+   */
+  std::optional<CompressionStatistics>
+  GetCompressionStatistics(const std::string &node_id) const;
 };
+
+inline size_t BoostWebSocketEndpoint::GetPoolSize() const {
+  return m_data_lanes + (m_control_lane ? 1 : 0);
+}
 } // namespace hive::networking::messaging::websockets
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "networking/messaging/ConnectionInfo.h"
+#include "networking/messaging/streams/MessageStreamReader.h"
+#include <memory>
+
+namespace hive::networking::messaging::streams {
+
+/**
+ * Receives message streams of a certain type, which have been opened by other
+ * nodes (see IMessageEndpoint::OpenStream). Unlike messages, streams are
+ * passed to the consumer as soon as they have been opened, so their fragments
+ * can be processed while the rest of the stream is still being received.
+ */
+class IMessageStreamConsumer
+    : public std::enable_shared_from_this<IMessageStreamConsumer> {
+public:
+  /**
+   * Returns the type of streams this consumer receives
+   * @return string that contains the unique type name
+   */
+  virtual std::string GetStreamType() const = 0;
+
+  /**
+   * Processes a stream that has been opened by another node.
+   * @param reader reader receiving the fragments of the stream. It can be kept
+   * and read later on (e.g. in subsequent jobs).
+   * @param connection_info information about the sender of the stream
+   */
+  virtual void ProcessReceivedStream(SharedMessageStreamReader reader,
+                                     ConnectionInfo connection_info) = 0;
+
+  virtual ~IMessageStreamConsumer() = default;
+};
+
+typedef std::shared_ptr<IMessageStreamConsumer> SharedMessageStreamConsumer;
+
+} // namespace hive::networking::messaging::streams
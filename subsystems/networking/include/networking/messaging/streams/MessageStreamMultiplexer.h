@@ -0,0 +1,123 @@
+#pragma once
+
+#include "common/config/Configuration.h"
+#include "networking/messaging/ConnectionInfo.h"
+#include "networking/messaging/Message.h"
+#include "networking/messaging/streams/MessageStreamReader.h"
+#include "networking/messaging/streams/MessageStreamWriter.h"
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+
+namespace hive::networking::messaging::streams {
+
+/**
+ * Manages the message streams of an endpoint. It opens streams to other nodes,
+ * routes stream messages (fragments, credit, etc.) of all connections to their
+ * readers and writers, and aborts the streams of connections that have been
+ * closed. Streams are transmitted as regular messages (see
+ * MessageStreamProtocol.h), so the multiplexer does not depend on the
+ * underlying endpoint implementation.
+ */
+class MessageStreamMultiplexer
+    : public std::enable_shared_from_this<MessageStreamMultiplexer> {
+public:
+  /** Sends a message to the node with the given id */
+  typedef std::function<std::future<void>(const std::string &, SharedMessage)>
+      SendFunction;
+
+  /**
+   * Passes a newly opened stream to its consumer
+   * @return false, if there is no consumer for the type of stream
+   */
+  typedef std::function<bool(SharedMessageStreamReader, const ConnectionInfo &)>
+      StreamOpenedFunction;
+
+private:
+  SendFunction m_send;
+  StreamOpenedFunction m_on_stream_opened;
+
+  /** Bytes a reader may buffer (and a writer may send before reading) */
+  const size_t m_window;
+
+  /** Maximum size of a single fragment in bytes */
+  const size_t m_fragment_size;
+
+  /** Streams to other nodes by stream id (owned by the sending party) */
+  std::map<std::string, std::weak_ptr<MessageStreamWriter>> m_writers;
+
+  /** Streams from other nodes by node id and stream id */
+  std::map<std::pair<std::string, std::string>, SharedMessageStreamReader>
+      m_readers;
+
+  mutable jobsystem::mutex m_streams_mutex;
+
+  void ProcessOpenMessage(const SharedMessage &message,
+                          const ConnectionInfo &info);
+  void ProcessFragmentMessage(const SharedMessage &message,
+                              const ConnectionInfo &info);
+  void ProcessCreditMessage(const SharedMessage &message,
+                            const ConnectionInfo &info);
+  void ProcessEndMessage(const SharedMessage &message,
+                         const ConnectionInfo &info);
+  void ProcessAbortMessage(const SharedMessage &message,
+                           const ConnectionInfo &info);
+
+  std::optional<SharedMessageStreamReader>
+  GetReader(const std::string &node_id, const std::string &stream_id);
+
+  std::optional<SharedMessageStreamWriter>
+  GetWriter(const std::string &node_id, const std::string &stream_id);
+
+  void SendCredit(const std::string &node_id, const std::string &stream_id,
+                  size_t credit);
+  void SendAbort(const std::string &node_id, const std::string &stream_id,
+                 const std::string &reason);
+
+public:
+  /**
+   * @param config configuration containing the window and fragment size
+   * @param send sends messages to other nodes
+   * @param on_stream_opened passes newly opened streams to their consumers
+   */
+  MessageStreamMultiplexer(const common::config::SharedConfiguration &config,
+                           SendFunction send,
+                           StreamOpenedFunction on_stream_opened);
+
+  /**
+   * Opens a stream to another node. Data can be written immediately, but it
+   * will only be sent after the receiver has accepted the stream.
+   * @param node_id id of the receiving node
+   * @param stream_type type of the stream (used to select its consumer)
+   * @return writer of the stream
+   */
+  SharedMessageStreamWriter OpenStream(const std::string &node_id,
+                                       const std::string &stream_type);
+
+  /**
+   * Processes a received message, if it belongs to a stream.
+   * @param message received message
+   * @param info connection information of the sender
+   * @return true, if the message belongs to a stream and has been processed
+   */
+  bool ProcessMessage(const SharedMessage &message, const ConnectionInfo &info);
+
+  /**
+   * Aborts all streams from and to a node.
+   * @param node_id id of the node whose connection has been closed
+   */
+  void OnConnectionClosed(const std::string &node_id);
+
+  /**
+   * @return count of streams from other nodes that are still being received
+   */
+  size_t GetReceivingStreamCount() const;
+};
+
+inline size_t MessageStreamMultiplexer::GetReceivingStreamCount() const {
+  std::unique_lock lock(m_streams_mutex);
+  return m_readers.size();
+}
+
+} // namespace hive::networking::messaging::streams
@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+ * Message streams are transmitted as regular messages of the following types,
+ * which are handled by the endpoint itself instead of being passed to message
+ * consumers. Each of them carries the id of its stream.
+ *
+ * 1. The sender opens a stream (containing its type).
+ * 2. The receiver grants credit (initially its whole window) or aborts the
+ *    stream, if there is no consumer for its type.
+ * 3. The sender sends fragments (with consecutive sequence numbers) as long as
+ *    it has got enough credit. Each fragment consumes credit.
+ * 4. The receiver grants more credit as fragments are read.
+ * 5. The sender ends the stream. Both sides are able to abort it at any time.
+ */
+
+#define STREAM_OPEN_MESSAGE_TYPE "hive-stream-open"
+#define STREAM_FRAGMENT_MESSAGE_TYPE "hive-stream-fragment"
+#define STREAM_CREDIT_MESSAGE_TYPE "hive-stream-credit"
+#define STREAM_END_MESSAGE_TYPE "hive-stream-end"
+#define STREAM_ABORT_MESSAGE_TYPE "hive-stream-abort"
+
+#define STREAM_ID_ATTRIBUTE "stream-id"
+#define STREAM_TYPE_ATTRIBUTE "stream-type"
+#define STREAM_SEQUENCE_ATTRIBUTE "sequence"
+#define STREAM_DATA_ATTRIBUTE "data"
+#define STREAM_CREDIT_ATTRIBUTE "credit"
+#define STREAM_REASON_ATTRIBUTE "reason"
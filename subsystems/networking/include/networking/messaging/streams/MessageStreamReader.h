@@ -0,0 +1,142 @@
+#pragma once
+
+#include "common/exceptions/ExceptionsBase.h"
+#include "jobsystem/manager/JobManager.h"
+#include "networking/messaging/MessageAttribute.h"
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace hive::networking::messaging::streams {
+
+DECLARE_EXCEPTION(MessageStreamAbortedException);
+
+/**
+ * Receiving end of a message stream. Fragments of the streamed payload are
+ * delivered in the order they have been written by the sender, as soon as they
+ * arrive. The reader only buffers a limited amount of bytes (its window): the
+ * sender may only send as many bytes as the reader has granted it (credit).
+ * Reading fragments grants new credit, so a slow consumer slows down the
+ * sender instead of filling up the memory of this node.
+ */
+class MessageStreamReader {
+  const std::string m_stream_id;
+  const std::string m_stream_type;
+
+  /** Maximum count of received, but unread bytes */
+  const size_t m_window;
+
+  /** Grants the sender more credit (in bytes) */
+  std::function<void(size_t)> m_grant_credit;
+
+  /** Tells the sender to stop sending (reason) */
+  std::function<void(const std::string &)> m_cancel;
+
+  std::deque<MessageAttribute> m_fragments;
+  std::deque<std::promise<std::optional<MessageAttribute>>> m_pending_reads;
+
+  /** Bytes received, but not read yet */
+  size_t m_buffered_bytes{0};
+
+  /** Bytes read, but not granted to the sender again yet */
+  size_t m_unacknowledged_bytes{0};
+
+  /** Expected sequence number of the next fragment */
+  size_t m_next_sequence{0};
+
+  bool m_finished{false};
+  std::optional<std::string> m_error;
+  mutable jobsystem::mutex m_mutex;
+
+  /**
+   * Counts a fragment as read and decides if the sender should get more credit.
+   * @return credit (in bytes) that should be granted to the sender
+   */
+  size_t ConsumeFragment(const MessageAttribute &fragment);
+
+public:
+  /**
+   * @param stream_id unique id of the stream
+   * @param stream_type type of the stream (used to select its consumer)
+   * @param window maximum count of bytes the reader buffers
+   * @param grant_credit grants the sender more credit
+   * @param cancel tells the sender to stop sending
+   */
+  MessageStreamReader(std::string stream_id, std::string stream_type,
+                      size_t window, std::function<void(size_t)> grant_credit,
+                      std::function<void(const std::string &)> cancel);
+
+  /**
+   * Reads the next fragment of the stream.
+   * @return future resolving to the next fragment, or to nothing if the sender
+   * has finished the stream and all fragments have been read.
+   * @throws MessageStreamAbortedException (inside future) if the stream has
+   * been aborted by either side or its connection has been closed.
+   * @note The fragment slices the received payload, so it is not copied.
+   */
+  std::future<std::optional<MessageAttribute>> Read();
+
+  /**
+   * Stops receiving this stream and tells the sender to abort it.
+   * @param reason reason why the stream has been cancelled
+   */
+  void Cancel(const std::string &reason);
+
+  /**
+   * Called when a fragment has been received.
+   * @param fragment data of the fragment
+   * @param sequence sequence number of the fragment
+   * @return false, if the fragment exceeds the window or is out of order (which
+   * aborts the stream)
+   */
+  bool OnFragmentReceived(MessageAttribute fragment, size_t sequence);
+
+  /**
+   * Called when the sender has finished the stream.
+   */
+  void OnFinished();
+
+  /**
+   * Called when the stream has been aborted.
+   * @param reason reason why the stream has been aborted
+   */
+  void OnAborted(const std::string &reason);
+
+  std::string GetStreamId() const;
+  std::string GetStreamType() const;
+
+  /**
+   * @return count of received bytes that have not been read yet
+   */
+  size_t GetBufferedBytes() const;
+
+  /**
+   * @return true, if the stream has been finished or aborted
+   */
+  bool IsClosed() const;
+};
+
+inline std::string MessageStreamReader::GetStreamId() const {
+  return m_stream_id;
+}
+
+inline std::string MessageStreamReader::GetStreamType() const {
+  return m_stream_type;
+}
+
+inline size_t MessageStreamReader::GetBufferedBytes() const {
+  std::unique_lock lock(m_mutex);
+  return m_buffered_bytes;
+}
+
+inline bool MessageStreamReader::IsClosed() const {
+  std::unique_lock lock(m_mutex);
+  return m_finished || m_error.has_value();
+}
+
+typedef std::shared_ptr<MessageStreamReader> SharedMessageStreamReader;
+
+} // namespace hive::networking::messaging::streams
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "jobsystem/manager/JobManager.h"
+#include "networking/messaging/Message.h"
+#include "networking/messaging/streams/MessageStreamReader.h"
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace hive::networking::messaging::streams {
+
+/**
+ * Sending end of a message stream. Written data is split into fragments, which
+ * are sent as separate messages, so other messages can be sent over the same
+ * connection in between. Fragments are only sent as long as the receiver has
+ * granted enough credit (in bytes); the remaining data waits here until the
+ * receiver has read what it has already received.
+ */
+class MessageStreamWriter {
+  /** Data waiting to be sent (or the end of the stream) */
+  struct PendingWrite {
+    SharedPayload data;
+    size_t offset{0};
+    bool is_end{false};
+    std::promise<void> promise;
+  };
+
+  const std::string m_stream_id;
+  const std::string m_node_id;
+
+  /** Maximum size of a single fragment in bytes */
+  const size_t m_fragment_size;
+
+  /** Sends a message of this stream to the receiving node */
+  std::function<std::future<void>(SharedMessage)> m_send;
+
+  /** Bytes the receiver is currently able to buffer */
+  size_t m_credit{0};
+
+  std::deque<PendingWrite> m_pending_writes;
+
+  /** Fragments that are still being sent (to detect failures) */
+  std::list<std::future<void>> m_sending;
+
+  size_t m_next_sequence{0};
+
+  bool m_ended{false};
+  std::optional<std::string> m_error;
+  mutable jobsystem::mutex m_mutex;
+
+  /**
+   * Sends as many fragments as the current credit allows.
+   * @attention requires the mutex to be locked
+   */
+  void SendPendingFragments();
+
+  /**
+   * Fails all pending writes.
+   * @attention requires the mutex to be locked
+   */
+  void FailPendingWrites();
+
+public:
+  /**
+   * @param stream_id unique id of the stream
+   * @param node_id id of the receiving node
+   * @param fragment_size maximum size of a single fragment in bytes
+   * @param send sends a message of this stream to the receiving node
+   */
+  MessageStreamWriter(std::string stream_id, std::string node_id,
+                      size_t fragment_size,
+                      std::function<std::future<void>(SharedMessage)> send);
+
+  /**
+   * Aborts the stream, if it has not been ended yet.
+   */
+  ~MessageStreamWriter();
+
+  /**
+   * Appends data to the stream.
+   * @param data data that will be sent in one or more fragments
+   * @return future resolving when all of the data has been passed to the
+   * connection. It waits for the receiver to grant enough credit.
+   * @throws MessageStreamAbortedException (inside future) if the stream has
+   * been aborted.
+   */
+  std::future<void> Write(std::string data);
+
+  /**
+   * Ends the stream after all data written so far has been sent.
+   * @return future resolving when the end of the stream has been sent
+   */
+  std::future<void> End();
+
+  /**
+   * Aborts the stream and discards all data that has not been sent yet.
+   * @param reason reason why the stream has been aborted
+   */
+  void Abort(const std::string &reason);
+
+  /**
+   * Called when the receiver has granted more credit.
+   * @param credit additional bytes the receiver is able to buffer
+   */
+  void OnCreditGranted(size_t credit);
+
+  /**
+   * Called when the stream has been aborted by the receiver or the connection.
+   * @param reason reason why the stream has been aborted
+   */
+  void OnAborted(const std::string &reason);
+
+  std::string GetStreamId() const;
+  std::string GetNodeId() const;
+
+  /**
+   * @return count of bytes that may currently be sent to the receiver
+   */
+  size_t GetCredit() const;
+
+  /**
+   * @return true, if the stream has been ended or aborted
+   */
+  bool IsClosed() const;
+};
+
+inline std::string MessageStreamWriter::GetStreamId() const {
+  return m_stream_id;
+}
+
+inline std::string MessageStreamWriter::GetNodeId() const { return m_node_id; }
+
+inline size_t MessageStreamWriter::GetCredit() const {
+  std::unique_lock lock(m_mutex);
+  return m_credit;
+}
+
+inline bool MessageStreamWriter::IsClosed() const {
+  std::unique_lock lock(m_mutex);
+  return (m_ended && m_pending_writes.empty()) || m_error.has_value();
+}
+
+typedef std::shared_ptr<MessageStreamWriter> SharedMessageStreamWriter;
+
+} // namespace hive::networking::messaging::streams
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace hive::networking::util {
+
+/**
+ * Threads executing asynchronous network operations (e.g. of an endpoint).
+ * Either all threads run a single shared io_context or each thread runs its
+ * own one. In the latter case, I/O objects are pinned to one of the contexts,
+ * so their handlers never contend with those of other contexts on a single
+ * reactor.
+ */
+class ExecutionContextPool {
+public:
+  typedef std::shared_ptr<boost::asio::io_context> SharedContext;
+
+private:
+  std::vector<SharedContext> m_contexts;
+
+  /** Keep contexts running while there is no asynchronous operation */
+  std::vector<boost::asio::executor_work_guard<
+      boost::asio::io_context::executor_type>>
+      m_work_guards;
+
+  std::vector<std::thread> m_threads;
+
+  /** Count of threads running the contexts */
+  const size_t m_thread_count;
+
+  /** Index of the context returned by the next call of GetNextContext */
+  std::atomic<size_t> m_next_context{0};
+
+public:
+  /**
+   * @param thread_count count of threads running the contexts
+   * @param context_per_thread if true, each thread runs its own context.
+   * Otherwise, all threads share a single one.
+   */
+  ExecutionContextPool(size_t thread_count, bool context_per_thread);
+
+  /**
+   * Stops all contexts (aborting outstanding operations) and waits for their
+   * threads, if this has not been done already.
+   */
+  ~ExecutionContextPool();
+
+  /**
+   * Starts the threads running the contexts.
+   */
+  void Start();
+
+  /**
+   * Lets the threads return as soon as there are no more outstanding
+   * asynchronous operations in their contexts and waits for them.
+   * @param abort if true, outstanding operations are not awaited
+   * @attention Must not be called by one of the pool's threads.
+   */
+  void Stop(bool abort = false);
+
+  /**
+   * @param hash hash of the I/O object (e.g. of its remote endpoint)
+   * @return context the I/O object is pinned to
+   */
+  const SharedContext &GetContextByHash(size_t hash) const;
+
+  /**
+   * @return contexts in turns (round-robin)
+   */
+  const SharedContext &GetNextContext();
+
+  /**
+   * @param index index of the context (less than GetContextCount())
+   * @return context
+   */
+  const SharedContext &GetContext(size_t index) const;
+
+  /**
+   * @return count of separate contexts (1, if all threads share one)
+   */
+  size_t GetContextCount() const;
+};
+
+inline const ExecutionContextPool::SharedContext &
+ExecutionContextPool::GetContextByHash(size_t hash) const {
+  return m_contexts[hash % m_contexts.size()];
+}
+
+inline const ExecutionContextPool::SharedContext &
+ExecutionContextPool::GetNextContext() {
+  return m_contexts[m_next_context++ % m_contexts.size()];
+}
+
+inline const ExecutionContextPool::SharedContext &
+ExecutionContextPool::GetContext(size_t index) const {
+  return m_contexts.at(index);
+}
+
+inline size_t ExecutionContextPool::GetContextCount() const {
+  return m_contexts.size();
+}
+
+} // namespace hive::networking::util
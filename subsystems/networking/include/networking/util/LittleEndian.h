@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace hive::networking::util {
+
+/**
+ * Writes an integer in little-endian byte order, so the written data is the
+ * same on every platform.
+ * @tparam T unsigned integer type
+ * @param out destination of at least sizeof(T) bytes
+ * @param value value to write
+ */
+template <typename T> void WriteLittleEndian(char *out, T value) {
+  static_assert(std::is_unsigned_v<T>, "only unsigned integers are supported");
+  for (size_t i = 0; i < sizeof(T); i++) {
+    out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+/**
+ * Reads an integer written by WriteLittleEndian.
+ * @tparam T unsigned integer type
+ * @param in source of at least sizeof(T) bytes
+ * @return read value
+ */
+template <typename T> T ReadLittleEndian(const char *in) {
+  static_assert(std::is_unsigned_v<T>, "only unsigned integers are supported");
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T); i++) {
+    value |= static_cast<T>(static_cast<uint8_t>(in[i])) << (8 * i);
+  }
+  return value;
+}
+
+} // namespace hive::networking::util
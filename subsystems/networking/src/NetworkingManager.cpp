@@ -4,6 +4,7 @@
 #include "logging/LogManager.h"
 #include "networking/messaging/MessageConsumerJob.h"
 #include <chrono>
+#include <sstream>
 
 using namespace hive::networking;
 using namespace hive::networking::messaging;
@@ -13,12 +14,22 @@ NetworkingManager::NetworkingManager(
     const common::memory::Reference<common::subsystems::SubsystemManager>
         &subsystems,
     const common::config::SharedConfiguration &config)
-    : m_subsystems(subsystems), m_config(config) {
+    : m_subsystems(subsystems), m_config(config),
+      m_consumer_table{std::make_shared<const ConsumerTable>()} {
 
   // configuration section
   ConfigureNode(config);
   bool auto_init_websocket_server = config->GetAsInt("net.autoInit", true);
 
+  std::stringstream preferred_protocols(
+      config->Get("net.endpoints.preferred", "shm,tcp"));
+  std::string protocol;
+  while (std::getline(preferred_protocols, protocol, ',')) {
+    if (!protocol.empty()) {
+      m_preferred_protocols.push_back(protocol);
+    }
+  }
+
   if (auto_init_websocket_server) {
     StartDefaultEndpointImplementation();
   }
@@ -47,24 +58,52 @@ void NetworkingManager::ConfigureNode(
                                                     << " in the hive")
 }
 
-void NetworkingManager::SetupConsumerCleanUpJob() {
-  auto this_reference = BorrowFromThis().ToReference();
-
-  /* job detaches itself when this has been destroyed; no clean-up needed */
-  auto clean_up_job = std::make_shared<jobsystem::TimerJob>(
-      [this_reference](jobsystem::JobContext *context) mutable {
-        if (auto maybe_network_manager = this_reference.TryBorrow()) {
-          auto network_manager = maybe_network_manager.value();
-          network_manager->CleanUpAllConsumers();
-          return jobsystem::JobContinuation::REQUEUE;
-        }
-        return jobsystem::JobContinuation::DISPOSE;
-      },
-      "network-manager-msg-consumer-clean-up", 1s);
+NetworkingManager::SharedConsumerList
+NetworkingManager::GetConsumerList(std::string_view type_name) const {
+  auto table = m_consumer_table.load();
+  auto iterator = table->type_ids.find(type_name);
+  if (iterator == table->type_ids.end()) {
+    return nullptr;
+  }
+  return table->consumers[iterator->second];
+}
 
-  auto job_manager =
-      m_subsystems.Borrow()->RequireSubsystem<jobsystem::JobManager>();
-  job_manager->KickJob(clean_up_job);
+void NetworkingManager::ModifyConsumerList(
+    const std::string &type_name,
+    const std::function<void(ConsumerList &)> &modify) {
+  auto new_table = std::make_shared<ConsumerTable>(*m_consumer_table.load());
+
+  // intern the message type, if it has never been registered before
+  MessageTypeId type_id;
+  auto iterator = new_table->type_ids.find(type_name);
+  if (iterator == new_table->type_ids.end()) {
+    type_id = static_cast<MessageTypeId>(new_table->consumers.size());
+    const auto &interned_type_name =
+        m_message_type_storage.emplace_back(type_name);
+    new_table->type_ids.emplace(interned_type_name, type_id);
+    new_table->consumers.push_back(nullptr);
+  } else {
+    type_id = iterator->second;
+  }
+
+  // expired consumers are only dropped here, never while dispatching
+  auto consumers = std::make_shared<ConsumerList>();
+  if (auto current_consumers = new_table->consumers[type_id]) {
+    consumers->reserve(current_consumers->size() + 1);
+    for (const auto &consumer : *current_consumers) {
+      if (!consumer.expired()) {
+        consumers->push_back(consumer);
+      }
+    }
+  }
+
+  modify(*consumers);
+  if (consumers->empty()) {
+    new_table->consumers[type_id] = nullptr;
+  } else {
+    new_table->consumers[type_id] = std::move(consumers);
+  }
+  m_consumer_table.store(std::move(new_table));
 }
 
 void NetworkingManager::AddMessageConsumer(
@@ -73,7 +112,10 @@ void NetworkingManager::AddMessageConsumer(
     SharedMessageConsumer shared_consumer = consumer.lock();
     const auto &consumer_message_type = shared_consumer->GetMessageType();
     std::unique_lock consumers_lock(m_consumers_mutex);
-    m_consumers[consumer_message_type].push_back(consumer);
+    ModifyConsumerList(consumer_message_type,
+                       [&consumer](ConsumerList &consumers) {
+                         consumers.push_back(consumer);
+                       });
     LOG_DEBUG("added web-socket message consumer for message type '"
               << consumer_message_type << "'")
   } else {
@@ -82,23 +124,24 @@ void NetworkingManager::AddMessageConsumer(
   }
 }
 
+void NetworkingManager::RemoveMessageConsumer(
+    const SharedMessageConsumer &consumer) {
+  std::unique_lock consumers_lock(m_consumers_mutex);
+  ModifyConsumerList(consumer->GetMessageType(),
+                     [&consumer](ConsumerList &consumers) {
+                       std::erase_if(consumers, [&consumer](const auto &other) {
+                         return other.lock() == consumer;
+                       });
+                     });
+}
+
 std::list<SharedMessageConsumer>
 NetworkingManager::GetConsumersOfMessageType(const std::string &type_name) {
   std::list<SharedMessageConsumer> ret_consumer_list;
-
-  std::unique_lock consumers_lock(m_consumers_mutex);
-  if (m_consumers.contains(type_name)) {
-    auto &consumer_list = m_consumers[type_name];
-
-    consumers_lock.unlock();
-    // remove expired references to consumers
-    CleanUpConsumersOfMessageType(type_name);
-    consumers_lock.lock();
-
-    // collect all remaining consumers in the list
-    for (const auto &consumer : consumer_list) {
-      if (!consumer.expired()) {
-        ret_consumer_list.push_back(consumer.lock());
+  if (auto consumers = GetConsumerList(type_name)) {
+    for (const auto &consumer : *consumers) {
+      if (auto shared_consumer = consumer.lock()) {
+        ret_consumer_list.push_back(std::move(shared_consumer));
       }
     }
   }
@@ -115,18 +158,70 @@ void NetworkingManager::ProcessMessage(const SharedMessage &message,
   auto job_manager = subsystems->RequireSubsystem<jobsystem::JobManager>();
 
   std::string message_type = message->GetType();
-  auto consumer_list = GetConsumersOfMessageType(message_type);
+  auto consumers = GetConsumerList(message_type);
+
+  LOG_DEBUG("received message of type '"
+            << message_type << "' (" << (consumers ? consumers->size() : 0)
+            << " consumers registered)")
+
+  if (!consumers) {
+    return;
+  }
 
-  LOG_DEBUG("received message of type '" << message_type << "' ("
-                                         << consumer_list.size()
-                                         << " consumers registered)")
+  for (const auto &consumer : *consumers) {
+    if (auto shared_consumer = consumer.lock()) {
+      auto job = std::make_shared<MessageConsumerJob>(
+          std::move(shared_consumer), message, info);
+      job_manager->KickJob(job);
+    }
+  }
+}
 
-  for (const auto &consumer : consumer_list) {
-    auto job = std::make_shared<MessageConsumerJob>(consumer, message, info);
-    job_manager->KickJob(job);
+void NetworkingManager::AddMessageStreamConsumer(
+    std::weak_ptr<streams::IMessageStreamConsumer> consumer) {
+  if (auto shared_consumer = consumer.lock()) {
+    const auto &stream_type = shared_consumer->GetStreamType();
+    std::unique_lock consumers_lock(m_stream_consumers_mutex);
+    m_stream_consumers[stream_type] = consumer;
+    LOG_DEBUG("added stream consumer for stream type '" << stream_type << "'")
+  } else {
+    LOG_WARN("given stream consumer has expired and cannot be added")
   }
 }
 
+bool NetworkingManager::ProcessMessageStream(
+    streams::SharedMessageStreamReader reader, const ConnectionInfo &info) {
+
+  DEBUG_ASSERT(m_subsystems.CanBorrow(), "subsystems shut down early")
+
+  std::unique_lock consumers_lock(m_stream_consumers_mutex);
+  auto stream_type = reader->GetStreamType();
+  if (!m_stream_consumers.contains(stream_type)) {
+    return false;
+  }
+
+  auto consumer = m_stream_consumers.at(stream_type).lock();
+  if (!consumer) {
+    m_stream_consumers.erase(stream_type);
+    return false;
+  }
+  consumers_lock.unlock();
+
+  auto job = std::make_shared<jobsystem::Job>(
+      [consumer, reader, info](jobsystem::JobContext *context) {
+        consumer->ProcessReceivedStream(reader, info);
+        return jobsystem::JobContinuation::DISPOSE;
+      },
+      "consume-stream-" + reader->GetStreamId(),
+      jobsystem::JobExecutionPhase::MAIN);
+  job->SetCategory("networking");
+
+  auto job_manager =
+      m_subsystems.Borrow()->RequireSubsystem<jobsystem::JobManager>();
+  job_manager->KickJob(job);
+  return true;
+}
+
 void NetworkingManager::InstallMessageEndpoint(
     common::memory::Owner<IMessageEndpoint> &&endpoint, bool is_default) {
 
@@ -262,7 +357,15 @@ NetworkingManager::GetSomeMessageEndpointConnectedTo(
     return {};
   }
 
-  // check default endpoint first
+  // check preferred endpoints first, then the default one
+  for (const auto &protocol : m_preferred_protocols) {
+    auto iterator = m_endpoints.find(protocol);
+    if (iterator != m_endpoints.end() &&
+        (*iterator->second)->HasConnectionTo(endpoint_id)) {
+      return iterator->second->Borrow();
+    }
+  }
+
   auto default_endpoint = m_endpoints.at(m_default_endpoint_protocol);
   if ((*default_endpoint)->HasConnectionTo(endpoint_id)) {
     return default_endpoint->Borrow();
@@ -281,19 +384,3 @@ NetworkingManager::GetSomeMessageEndpointConnectedTo(
 
   return {};
 }
-
-void NetworkingManager::CleanUpConsumersOfMessageType(const std::string &type) {
-  if (m_consumers.contains(type)) {
-    std::unique_lock consumers_lock(m_consumers_mutex);
-    auto &consumer_list = m_consumers[type];
-    consumer_list.remove_if([](const std::weak_ptr<IMessageConsumer> &con) {
-      return con.expired();
-    });
-  }
-}
-
-void NetworkingManager::CleanUpAllConsumers() {
-  for (const auto &[message_type, consumer_list] : m_consumers) {
-    CleanUpConsumersOfMessageType(message_type);
-  }
-}
\ No newline at end of file
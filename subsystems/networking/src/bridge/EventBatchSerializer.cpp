@@ -0,0 +1,210 @@
+#include "networking/bridge/EventBatchSerializer.h"
+#include "logging/LogManager.h"
+#include "networking/util/LittleEndian.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+using namespace hive::networking::bridge;
+using namespace hive::networking::util;
+using namespace hive::events;
+
+/** identifies the type of serialized payload values */
+enum PayloadType : uint8_t {
+  STRING_PAYLOAD = 0,
+  BOOL_PAYLOAD = 1,
+  INT_PAYLOAD = 2,
+  LONG_PAYLOAD = 3,
+  UNSIGNED_LONG_PAYLOAD = 4,
+  FLOAT_PAYLOAD = 5,
+  DOUBLE_PAYLOAD = 6
+};
+
+/** Appends an integer in little-endian byte order, like binary messages */
+template <typename T> static void WriteValue(std::string &out, T value) {
+  char bytes[sizeof(T)];
+  WriteLittleEndian<T>(bytes, value);
+  out.append(bytes, sizeof(T));
+}
+
+static void WriteString(std::string &out, const std::string &value) {
+  WriteValue<uint32_t>(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+/**
+ * Reads values from serialized data and checks that the data is not exceeded.
+ */
+class BatchReader {
+  const std::string &m_data;
+  size_t m_position{0};
+
+  void Require(size_t size) const {
+    if (m_data.size() - m_position < size) {
+      THROW_EXCEPTION(EventBatchInvalidException,
+                      "event batch is truncated at byte " << m_position)
+    }
+  }
+
+public:
+  explicit BatchReader(const std::string &data) : m_data(data) {}
+
+  template <typename T> T ReadValue() {
+    Require(sizeof(T));
+    auto value = ReadLittleEndian<T>(m_data.data() + m_position);
+    m_position += sizeof(T);
+    return value;
+  }
+
+  std::string ReadString() {
+    auto size = ReadValue<uint32_t>();
+    Require(size);
+    std::string value = m_data.substr(m_position, size);
+    m_position += size;
+    return value;
+  }
+
+  bool IsAtEnd() const { return m_position == m_data.size(); }
+};
+
+/**
+ * Appends a payload value to the serialized data.
+ * @return false, if the type of the value is not supported
+ */
+static bool WritePayload(std::string &out, const std::any &value) {
+  const auto &type = value.type();
+  if (type == typeid(std::string)) {
+    WriteValue<uint8_t>(out, PayloadType::STRING_PAYLOAD);
+    WriteString(out, std::any_cast<const std::string &>(value));
+  } else if (type == typeid(bool)) {
+    WriteValue<uint8_t>(out, PayloadType::BOOL_PAYLOAD);
+    WriteValue<uint8_t>(out, std::any_cast<bool>(value) ? 1 : 0);
+  } else if (type == typeid(int)) {
+    WriteValue<uint8_t>(out, PayloadType::INT_PAYLOAD);
+    WriteValue<uint64_t>(out, static_cast<int64_t>(std::any_cast<int>(value)));
+  } else if (type == typeid(long)) {
+    WriteValue<uint8_t>(out, PayloadType::LONG_PAYLOAD);
+    WriteValue<uint64_t>(out,
+                         static_cast<int64_t>(std::any_cast<long>(value)));
+  } else if (type == typeid(size_t)) {
+    WriteValue<uint8_t>(out, PayloadType::UNSIGNED_LONG_PAYLOAD);
+    WriteValue<uint64_t>(out, std::any_cast<size_t>(value));
+  } else if (type == typeid(float)) {
+    WriteValue<uint8_t>(out, PayloadType::FLOAT_PAYLOAD);
+    WriteValue(out, std::bit_cast<uint32_t>(std::any_cast<float>(value)));
+  } else if (type == typeid(double)) {
+    WriteValue<uint8_t>(out, PayloadType::DOUBLE_PAYLOAD);
+    WriteValue(out, std::bit_cast<uint64_t>(std::any_cast<double>(value)));
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static void ReadPayload(BatchReader &reader, Event &event,
+                        const std::string &key) {
+  auto type = reader.ReadValue<uint8_t>();
+  switch (type) {
+  case PayloadType::STRING_PAYLOAD:
+    event.SetPayload<std::string>(key, reader.ReadString());
+    break;
+  case PayloadType::BOOL_PAYLOAD:
+    event.SetPayload<bool>(key, reader.ReadValue<uint8_t>() != 0);
+    break;
+  case PayloadType::INT_PAYLOAD:
+    event.SetPayload<int>(key, static_cast<int>(static_cast<int64_t>(
+                                   reader.ReadValue<uint64_t>())));
+    break;
+  case PayloadType::LONG_PAYLOAD:
+    event.SetPayload<long>(key, static_cast<long>(static_cast<int64_t>(
+                                    reader.ReadValue<uint64_t>())));
+    break;
+  case PayloadType::UNSIGNED_LONG_PAYLOAD:
+    event.SetPayload<size_t>(key,
+                             static_cast<size_t>(reader.ReadValue<uint64_t>()));
+    break;
+  case PayloadType::FLOAT_PAYLOAD:
+    event.SetPayload<float>(key,
+                            std::bit_cast<float>(reader.ReadValue<uint32_t>()));
+    break;
+  case PayloadType::DOUBLE_PAYLOAD:
+    event.SetPayload<double>(
+        key, std::bit_cast<double>(reader.ReadValue<uint64_t>()));
+    break;
+  default:
+    THROW_EXCEPTION(EventBatchInvalidException,
+                    "payload '" << key << "' has unknown type "
+                                << static_cast<int>(type))
+  }
+}
+
+bool EventBatchSerializer::IsSerializable(const std::any &value) {
+  const auto &type = value.type();
+  return type == typeid(std::string) || type == typeid(bool) ||
+         type == typeid(int) || type == typeid(long) ||
+         type == typeid(size_t) || type == typeid(float) ||
+         type == typeid(double);
+}
+
+std::string
+EventBatchSerializer::Serialize(const std::vector<SharedEvent> &events) {
+  std::string out;
+  WriteValue<uint32_t>(out, static_cast<uint32_t>(events.size()));
+
+  for (const auto &event : events) {
+    WriteString(out, event->GetTopic());
+    WriteString(out, event->GetId());
+
+    const auto &payloads = event->GetAllPayloads();
+    uint32_t payload_count = 0;
+    for (const auto &[key, value] : payloads) {
+      if (IsSerializable(value)) {
+        payload_count++;
+      } else {
+        LOG_WARN("payload '" << key << "' of event '" << event->GetTopic()
+                             << "' has a type that cannot be sent to other "
+                                "nodes and will be skipped")
+      }
+    }
+
+    WriteValue<uint32_t>(out, payload_count);
+    for (const auto &[key, value] : payloads) {
+      if (IsSerializable(value)) {
+        WriteString(out, key);
+        WritePayload(out, value);
+      }
+    }
+  }
+
+  return out;
+}
+
+std::vector<SharedEvent>
+EventBatchSerializer::Deserialize(const std::string &data) {
+  BatchReader reader(data);
+  auto event_count = reader.ReadValue<uint32_t>();
+
+  std::vector<SharedEvent> events;
+  events.reserve(std::min<size_t>(event_count, data.size()));
+
+  for (uint32_t i = 0; i < event_count; i++) {
+    auto topic = reader.ReadString();
+    auto id = reader.ReadString();
+    auto event = std::make_shared<Event>(std::move(topic), std::move(id));
+
+    auto payload_count = reader.ReadValue<uint32_t>();
+    for (uint32_t j = 0; j < payload_count; j++) {
+      auto key = reader.ReadString();
+      ReadPayload(reader, *event, key);
+    }
+
+    events.push_back(std::move(event));
+  }
+
+  if (!reader.IsAtEnd()) {
+    THROW_EXCEPTION(EventBatchInvalidException,
+                    "event batch contains unexpected trailing data")
+  }
+
+  return events;
+}
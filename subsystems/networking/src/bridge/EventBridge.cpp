@@ -0,0 +1,240 @@
+#include "networking/bridge/EventBridge.h"
+#include "data/DataLayer.h"
+#include "events/broker/IEventBroker.h"
+#include "events/listener/impl/FunctionalEventListener.h"
+#include "jobsystem/jobs/TimerJob.h"
+#include "logging/LogManager.h"
+#include "networking/NetworkingManager.h"
+#include "networking/bridge/EventBatchConsumer.h"
+#include "networking/bridge/EventBatchSerializer.h"
+#include <sstream>
+
+using namespace hive::networking;
+using namespace hive::networking::bridge;
+using namespace hive::networking::messaging;
+using namespace hive::events;
+using namespace hive::events::brokers;
+using namespace hive::jobsystem;
+
+EventBridge::EventBridge(
+    const common::memory::Reference<common::subsystems::SubsystemManager>
+        &subsystems,
+    const common::config::SharedConfiguration &config)
+    : m_subsystems(subsystems), m_this_alive_checker{std::make_shared<bool>()} {
+
+  EventCoalescingPolicy batching_policy;
+  batching_policy.max_batch_size =
+      config->GetAsInt("net.bridge.batch-size", 256);
+  batching_policy.window = std::chrono::milliseconds(
+      config->GetAsInt("net.bridge.window-ms", 0));
+  m_pending_events = std::make_shared<EventCoalescer>(batching_policy);
+
+  auto subsystems_borrower = m_subsystems.Borrow();
+  auto property_provider =
+      subsystems_borrower->RequireSubsystem<data::DataLayer>();
+  m_node_id = property_provider->Get("net.node.id").get().value_or("");
+
+  m_forwarding_listener = std::make_shared<FunctionalEventListener>(
+      [this](const SharedEvent &event) { Enqueue(event); });
+
+  // consumer jobs could still be running when this has been destroyed
+  std::weak_ptr<bool> alive_checker = m_this_alive_checker;
+  m_batch_consumer = std::make_shared<EventBatchConsumer>(
+      [this, alive_checker](const EventBatchMessage &message,
+                            const ConnectionInfo &info) {
+        if (!alive_checker.expired()) {
+          ReceiveBatch(message, info);
+        }
+      });
+
+  auto networking_manager =
+      subsystems_borrower->RequireSubsystem<NetworkingManager>();
+  networking_manager->AddMessageConsumer(m_batch_consumer);
+
+  std::stringstream forwarded_topics(config->Get("net.bridge.topics", ""));
+  std::string topic;
+  while (std::getline(forwarded_topics, topic, ',')) {
+    if (!topic.empty()) {
+      Forward(topic);
+    }
+  }
+}
+
+EventBridge::~EventBridge() {
+  if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
+    auto subsystems = maybe_subsystems.value();
+    if (auto maybe_broker = subsystems->GetSubsystem<IEventBroker>()) {
+      maybe_broker.value()->UnregisterListener(m_forwarding_listener);
+    }
+  }
+}
+
+void EventBridge::Forward(const std::string &topic) {
+  DEBUG_ASSERT(!topic.empty(), "forwarded topic should not be empty")
+
+  std::unique_lock lock(m_forwarded_topics_mutex);
+  if (!m_forwarded_topics.insert(topic).second) {
+    return /* because events of this topic are already forwarded */;
+  }
+  lock.unlock();
+
+  auto broker = m_subsystems.Borrow()->RequireSubsystem<IEventBroker>();
+
+  // collecting events is cheap and must not lag behind the firing thread
+  broker->RegisterListener(m_forwarding_listener, topic, DispatchMode::INLINE);
+  LOG_DEBUG("events of topic '" << topic << "' are forwarded to other nodes")
+}
+
+void EventBridge::StopForwarding(const std::string &topic) {
+  std::unique_lock lock(m_forwarded_topics_mutex);
+  if (m_forwarded_topics.erase(topic) == 0) {
+    return /* because events of this topic have not been forwarded */;
+  }
+  lock.unlock();
+
+  auto broker = m_subsystems.Borrow()->RequireSubsystem<IEventBroker>();
+  broker->RemoveListenerFromTopic(m_forwarding_listener, topic);
+}
+
+bool EventBridge::IsForwarding(const std::string &topic) const {
+  std::unique_lock lock(m_forwarded_topics_mutex);
+  return m_forwarded_topics.contains(topic);
+}
+
+bool EventBridge::IsBridged(const SharedEvent &event) {
+  return event->GetAllPayloads().contains(c_origin_payload_key);
+}
+
+void EventBridge::Enqueue(SharedEvent event) {
+  if (IsBridged(event)) {
+    return /* because re-fired events would circulate between bridges */;
+  }
+
+  auto maybe_subsystems = m_subsystems.TryBorrow();
+  if (!maybe_subsystems.has_value()) {
+    return /* because this node is shutting down */;
+  }
+  auto job_manager =
+      maybe_subsystems.value()->RequireSubsystem<jobsystem::JobManager>();
+
+  // serializing and sending is done in jobs, not on the firing thread
+  std::weak_ptr<bool> alive_checker = m_this_alive_checker;
+  auto pending_events = m_pending_events;
+
+  switch (pending_events->Add(std::move(event))) {
+  case EventCoalescer::PENDING:
+    break;
+  case EventCoalescer::FLUSH: {
+    auto batch = std::make_shared<std::vector<SharedEvent>>(
+        pending_events->TakeBatch());
+
+    SharedJob send_job = std::make_shared<Job>(
+        [this, alive_checker, batch](JobContext *) {
+          if (!alive_checker.expired()) {
+            SendBatch(*batch);
+          }
+          return JobContinuation::DISPOSE;
+        },
+        "send-bridged-events");
+    send_job->SetCategory("networking");
+    job_manager->KickJob(send_job);
+    break;
+  }
+  case EventCoalescer::SCHEDULE_FLUSH: {
+    auto flush = [this, alive_checker, pending_events](JobContext *) {
+      if (!alive_checker.expired()) {
+        SendBatch(pending_events->TakeScheduledBatch());
+      }
+      return JobContinuation::DISPOSE;
+    };
+
+    const auto &window = pending_events->GetPolicy().window;
+    if (window.count() > 0) {
+      SharedJob flush_job =
+          std::make_shared<TimerJob>(flush, "flush-bridged-events", window);
+      flush_job->SetCategory("networking");
+      job_manager->KickJob(flush_job);
+    } else {
+      SharedJob flush_job =
+          std::make_shared<Job>(flush, "flush-bridged-events");
+      flush_job->SetCategory("networking");
+      job_manager->KickJobForNextCycle(flush_job);
+    }
+    break;
+  }
+  }
+}
+
+void EventBridge::SendBatch(const std::vector<SharedEvent> &batch) {
+  if (batch.empty()) {
+    return /* because there is nothing to send */;
+  }
+
+  auto maybe_subsystems = m_subsystems.TryBorrow();
+  if (!maybe_subsystems.has_value()) {
+    LOG_WARN("cannot forward " << batch.size()
+                               << " events to other nodes because required "
+                                  "subsystems are not available")
+    return;
+  }
+
+  auto networking_manager =
+      maybe_subsystems.value()->RequireSubsystem<NetworkingManager>();
+  auto maybe_endpoint = networking_manager->GetDefaultMessageEndpoint();
+  if (!maybe_endpoint.has_value()) {
+    LOG_WARN("cannot forward " << batch.size()
+                               << " events to other nodes because no "
+                                  "messaging endpoint has been installed")
+    return;
+  }
+
+  auto endpoint = maybe_endpoint.value();
+  if (endpoint->GetActiveConnectionCount() == 0) {
+    return /* because there are no peers to forward events to */;
+  }
+
+  // the batch is serialized once, no matter how many peers receive it
+  EventBatchMessage message;
+  message.SetOrigin(m_node_id);
+  message.SetSerializedEvents(EventBatchSerializer::Serialize(batch));
+  endpoint->IssueBroadcastAsJob(message.GetMessage());
+
+  LOG_DEBUG("forwarded batch of " << batch.size() << " events to "
+                                  << endpoint->GetActiveConnectionCount()
+                                  << " other nodes")
+}
+
+void EventBridge::ReceiveBatch(const EventBatchMessage &message,
+                               const ConnectionInfo &info) {
+  auto origin = message.GetOrigin();
+  if (origin.empty()) {
+    origin = info.endpoint_id;
+  }
+
+  if (origin == m_node_id) {
+    return /* because these events have been fired on this node */;
+  }
+
+  std::vector<SharedEvent> events;
+  try {
+    events = EventBatchSerializer::Deserialize(message.GetSerializedEvents());
+  } catch (const EventBatchInvalidException &exception) {
+    LOG_WARN("batch of events received from node "
+             << info.endpoint_id << " is invalid: " << exception.what())
+    return;
+  }
+
+  auto maybe_subsystems = m_subsystems.TryBorrow();
+  if (!maybe_subsystems.has_value()) {
+    return /* because this node is shutting down */;
+  }
+
+  auto broker = maybe_subsystems.value()->RequireSubsystem<IEventBroker>();
+  for (auto &event : events) {
+    event->SetPayload<std::string>(c_origin_payload_key, origin);
+    broker->FireEvent(std::move(event));
+  }
+
+  LOG_DEBUG("re-fired batch of " << events.size() << " events from node "
+                                 << origin)
+}
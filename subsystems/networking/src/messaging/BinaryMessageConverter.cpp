@@ -0,0 +1,235 @@
+#include "networking/messaging/BinaryMessageConverter.h"
+#include "networking/util/LittleEndian.h"
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::util;
+
+static constexpr char c_magic[4] = {'H', 'I', 'V', 'B'};
+static constexpr char c_batch_magic[4] = {'H', 'I', 'V', 'M'};
+
+/**
+ * @return true, if the value can be stored in a field of type T
+ */
+template <typename T> static bool FitsInto(size_t value) {
+  return value <= std::numeric_limits<T>::max();
+}
+
+std::string BinaryMessageConverter::ToBinary(const SharedMessage &message) {
+  const auto &id = message->GetId();
+  const auto &type = message->GetType();
+  const auto &attributes = message->GetAttributes();
+
+  // narrowed fields would silently produce a corrupt frame
+  if (!FitsInto<uint16_t>(attributes.size())) {
+    THROW_EXCEPTION(BinaryFrameOverflowException,
+                    "message has " << attributes.size()
+                                   << " attributes, but binary frames support "
+                                   << std::numeric_limits<uint16_t>::max())
+  }
+
+  if (!FitsInto<uint32_t>(id.size()) || !FitsInto<uint32_t>(type.size())) {
+    THROW_EXCEPTION(BinaryFrameOverflowException,
+                    "id or type of message is too long for a binary frame")
+  }
+
+  size_t table_size = attributes.size() * c_attribute_entry_size;
+  size_t frame_size = c_header_size + table_size + id.size() + type.size();
+  for (const auto &[name, value] : attributes) {
+    // the current size is the offset of the name, which has only 32 bits
+    if (!FitsInto<uint32_t>(frame_size) || !FitsInto<uint32_t>(name.size())) {
+      THROW_EXCEPTION(BinaryFrameOverflowException,
+                      "attribute '" << name.substr(0, 64)
+                                    << "' cannot be addressed in a binary "
+                                       "frame, because preceding values "
+                                       "exceed 4 GiB")
+    }
+    frame_size += name.size() + value.GetSize();
+  }
+
+  // the frame is allocated once and filled in place
+  std::string frame(frame_size, '\0');
+  char *data = frame.data();
+
+  std::memcpy(data, c_magic, sizeof(c_magic));
+  WriteLittleEndian<uint8_t>(data + 4, c_version);
+  WriteLittleEndian<uint8_t>(data + 5, 0);
+  WriteLittleEndian<uint16_t>(data + 6,
+                              static_cast<uint16_t>(attributes.size()));
+  WriteLittleEndian<uint32_t>(data + 8, static_cast<uint32_t>(id.size()));
+  WriteLittleEndian<uint32_t>(data + 12, static_cast<uint32_t>(type.size()));
+
+  size_t data_offset = c_header_size + table_size;
+  std::memcpy(data + data_offset, id.data(), id.size());
+  data_offset += id.size();
+  std::memcpy(data + data_offset, type.data(), type.size());
+  data_offset += type.size();
+
+  size_t entry_offset = c_header_size;
+  for (const auto &[name, attribute] : attributes) {
+    auto value = attribute.GetView();
+    char *entry = data + entry_offset;
+    WriteLittleEndian<uint32_t>(entry, static_cast<uint32_t>(data_offset));
+    WriteLittleEndian<uint32_t>(entry + 4, static_cast<uint32_t>(name.size()));
+    std::memcpy(data + data_offset, name.data(), name.size());
+    data_offset += name.size();
+
+    WriteLittleEndian<uint64_t>(entry + 8, data_offset);
+    WriteLittleEndian<uint64_t>(entry + 16, value.size());
+    std::memcpy(data + data_offset, value.data(), value.size());
+    data_offset += value.size();
+
+    entry_offset += c_attribute_entry_size;
+  }
+
+  return frame;
+}
+
+bool BinaryMessageConverter::IsBinary(const std::string &payload) {
+  return payload.size() >= c_header_size &&
+         std::memcmp(payload.data(), c_magic, sizeof(c_magic)) == 0;
+}
+
+/**
+ * Checks that a range lies within the frame.
+ */
+static void RequireInFrame(std::string_view frame, uint64_t offset,
+                           uint64_t length) {
+  if (offset > frame.size() || length > frame.size() - offset) {
+    THROW_EXCEPTION(BinaryFrameInvalidException,
+                    "binary frame of " << frame.size()
+                                       << " bytes is truncated or corrupt")
+  }
+}
+
+SharedMessage BinaryMessageConverter::FromBinary(const std::string &frame) {
+  return FromBinary(std::make_shared<const std::string>(frame));
+}
+
+SharedMessage BinaryMessageConverter::FromBinary(const SharedPayload &payload) {
+  return FromBinary(payload, 0, payload->size());
+}
+
+SharedMessage BinaryMessageConverter::FromBinary(const SharedPayload &payload,
+                                                 size_t frame_offset,
+                                                 size_t frame_length) {
+  auto frame = std::string_view(*payload).substr(frame_offset, frame_length);
+  if (frame.size() < c_header_size ||
+      std::memcmp(frame.data(), c_magic, sizeof(c_magic)) != 0) {
+    THROW_EXCEPTION(BinaryFrameInvalidException,
+                    "payload is not a binary frame")
+  }
+
+  const char *data = frame.data();
+  auto version = ReadLittleEndian<uint8_t>(data + 4);
+  if (version != c_version) {
+    THROW_EXCEPTION(BinaryFrameInvalidException,
+                    "binary frame version " << static_cast<int>(version)
+                                            << " is not supported")
+  }
+
+  auto attribute_count = ReadLittleEndian<uint16_t>(data + 6);
+  auto id_length = ReadLittleEndian<uint32_t>(data + 8);
+  auto type_length = ReadLittleEndian<uint32_t>(data + 12);
+
+  uint64_t table_size = attribute_count * c_attribute_entry_size;
+  RequireInFrame(frame, c_header_size, table_size);
+
+  uint64_t id_offset = c_header_size + table_size;
+  RequireInFrame(frame, id_offset, id_length);
+  RequireInFrame(frame, id_offset + id_length, type_length);
+
+  auto message = std::make_shared<Message>(
+      std::string(frame.substr(id_offset + id_length, type_length)),
+      std::string(frame.substr(id_offset, id_length)));
+
+  for (size_t i = 0; i < attribute_count; i++) {
+    const char *entry = data + c_header_size + i * c_attribute_entry_size;
+    auto name_offset = ReadLittleEndian<uint32_t>(entry);
+    auto name_length = ReadLittleEndian<uint32_t>(entry + 4);
+    auto value_offset = ReadLittleEndian<uint64_t>(entry + 8);
+    auto value_length = ReadLittleEndian<uint64_t>(entry + 16);
+
+    RequireInFrame(frame, name_offset, name_length);
+    RequireInFrame(frame, value_offset, value_length);
+
+    // values are not copied, but reference the received payload
+    message->SetAttribute(
+        std::string(frame.substr(name_offset, name_length)),
+        MessageAttribute(payload, frame_offset + value_offset, value_length));
+  }
+
+  return message;
+}
+
+std::string BinaryMessageConverter::ToBinaryBatch(
+    const std::vector<SharedPayload> &frames) {
+  if (!FitsInto<uint32_t>(frames.size())) {
+    THROW_EXCEPTION(BinaryFrameOverflowException,
+                    "batch of " << frames.size() << " frames is too large")
+  }
+
+  size_t batch_size = c_batch_header_size;
+  for (const auto &frame : frames) {
+    batch_size += sizeof(uint64_t) + frame->size();
+  }
+
+  std::string batch(batch_size, '\0');
+  char *data = batch.data();
+
+  std::memcpy(data, c_batch_magic, sizeof(c_batch_magic));
+  WriteLittleEndian<uint8_t>(data + 4, c_version);
+  WriteLittleEndian<uint8_t>(data + 5, 0);
+  WriteLittleEndian<uint16_t>(data + 6, 0);
+  WriteLittleEndian<uint32_t>(data + 8, static_cast<uint32_t>(frames.size()));
+
+  size_t offset = c_batch_header_size;
+  for (const auto &frame : frames) {
+    WriteLittleEndian<uint64_t>(data + offset, frame->size());
+    offset += sizeof(uint64_t);
+    std::memcpy(data + offset, frame->data(), frame->size());
+    offset += frame->size();
+  }
+
+  return batch;
+}
+
+bool BinaryMessageConverter::IsBinaryBatch(const std::string &payload) {
+  return payload.size() >= c_batch_header_size &&
+         std::memcmp(payload.data(), c_batch_magic, sizeof(c_batch_magic)) ==
+             0;
+}
+
+std::vector<SharedMessage>
+BinaryMessageConverter::FromBinaryBatch(const SharedPayload &payload) {
+  std::string_view batch(*payload);
+  if (!IsBinaryBatch(*payload)) {
+    THROW_EXCEPTION(BinaryFrameInvalidException,
+                    "payload is not a batch of binary frames")
+  }
+
+  auto version = ReadLittleEndian<uint8_t>(batch.data() + 4);
+  if (version != c_version) {
+    THROW_EXCEPTION(BinaryFrameInvalidException,
+                    "binary batch version " << static_cast<int>(version)
+                                            << " is not supported")
+  }
+
+  auto count = ReadLittleEndian<uint32_t>(batch.data() + 8);
+
+  std::vector<SharedMessage> messages;
+  size_t offset = c_batch_header_size;
+  for (size_t i = 0; i < count; i++) {
+    RequireInFrame(batch, offset, sizeof(uint64_t));
+    auto frame_length = ReadLittleEndian<uint64_t>(batch.data() + offset);
+    offset += sizeof(uint64_t);
+
+    RequireInFrame(batch, offset, frame_length);
+    messages.push_back(FromBinary(payload, offset, frame_length));
+    offset += frame_length;
+  }
+
+  return messages;
+}
@@ -0,0 +1,59 @@
+#include "networking/messaging/BroadcastResult.h"
+#include "logging/LogManager.h"
+
+using namespace hive::networking::messaging;
+
+std::future<BroadcastResult> BroadcastProgress::GetFuture() {
+  return m_promise.get_future();
+}
+
+void BroadcastProgress::AddPendingSend() {
+  std::unique_lock lock(m_mutex);
+  DEBUG_ASSERT(!m_sealed, "sends cannot be added to a sealed broadcast")
+  m_pending_count++;
+}
+
+void BroadcastProgress::ReportSend(const std::string &node_id,
+                                   const std::exception_ptr &error) {
+  std::unique_lock lock(m_mutex);
+  DEBUG_ASSERT(m_pending_count > 0, "send has not been announced")
+  m_pending_count--;
+
+  if (!error) {
+    m_result.delivered.push_back(node_id);
+  } else {
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception &exception) {
+      LOG_ERR("failed to broadcast message to node " << node_id << ": "
+                                                     << exception.what())
+      m_result.failed[node_id] = exception.what();
+    } catch (...) {
+      m_result.failed[node_id] = "unknown error";
+    }
+  }
+
+  TryComplete(lock);
+}
+
+void BroadcastProgress::ReportFailure(const std::string &node_id,
+                                      const std::string &reason) {
+  std::unique_lock lock(m_mutex);
+  m_result.failed[node_id] = reason;
+}
+
+void BroadcastProgress::Seal() {
+  std::unique_lock lock(m_mutex);
+  m_sealed = true;
+  TryComplete(lock);
+}
+
+void BroadcastProgress::TryComplete(std::unique_lock<jobsystem::mutex> &lock) {
+  if (!m_sealed || m_pending_count > 0) {
+    return;
+  }
+
+  auto result = std::move(m_result);
+  lock.unlock();
+  m_promise.set_value(std::move(result));
+}
@@ -14,21 +14,44 @@ Message::~Message() = default;
 
 void Message::SetAttribute(const std::string &attribute_key,
                            std::string attribute_value) {
+  m_attributes[attribute_key] = MessageAttribute(std::move(attribute_value));
+}
+
+void Message::SetAttribute(const std::string &attribute_key,
+                           MessageAttribute attribute_value) {
   m_attributes[attribute_key] = std::move(attribute_value);
 }
 
 std::optional<std::string>
 Message::GetAttribute(const std::string &attribute_key) {
   if (m_attributes.contains(attribute_key)) {
-    return m_attributes.at(attribute_key);
+    return m_attributes.at(attribute_key).ToString();
   } else {
     return {};
   }
 }
 
+std::optional<std::string_view>
+Message::GetAttributeView(const std::string &attribute_key) const {
+  auto it = m_attributes.find(attribute_key);
+  if (it == m_attributes.end()) {
+    return {};
+  }
+  return it->second.GetView();
+}
+
+std::optional<MessageAttribute>
+Message::GetSharedAttribute(const std::string &attribute_key) const {
+  auto it = m_attributes.find(attribute_key);
+  if (it == m_attributes.end()) {
+    return {};
+  }
+  return it->second;
+}
+
 std::set<std::string> Message::GetAttributeNames() const  {
   std::set<std::string> attribute_names;
-  std::map<std::string, std::string>::const_iterator it;
+  std::map<std::string, MessageAttribute>::const_iterator it;
 
   for (it = m_attributes.begin(); it != m_attributes.end(); it++) {
     attribute_names.insert(it->first);
@@ -37,6 +60,14 @@ std::set<std::string> Message::GetAttributeNames() const  {
   return attribute_names;
 }
 
+size_t Message::GetPayloadSize() const {
+  size_t size = 0;
+  for (const auto &[name, value] : m_attributes) {
+    size += value.GetSize();
+  }
+  return size;
+}
+
 bool Message::EqualsTo(const std::shared_ptr<Message> &other) const  {
   if (m_uuid != other->m_uuid) {
     return false;
@@ -46,15 +77,15 @@ bool Message::EqualsTo(const std::shared_ptr<Message> &other) const  {
     return false;
   }
 
-  std::map<std::string, std::string>::const_iterator it;
+  std::map<std::string, MessageAttribute>::const_iterator it;
   for (it = m_attributes.begin(); it != m_attributes.end(); it++) {
     const std::string &name = it->first;
-    const std::string &value = it->second;
+    const MessageAttribute &value = it->second;
     if (!other->m_attributes.contains(name)) {
       return false;
     }
 
-    if (value != other->m_attributes.at(name)) {
+    if (value.GetView() != other->m_attributes.at(name).GetView()) {
       return false;
     }
   }
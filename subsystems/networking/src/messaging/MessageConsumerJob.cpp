@@ -12,7 +12,10 @@ MessageConsumerJob::MessageConsumerJob(SharedMessageConsumer consumer,
           "consume-web-socket-message-type-" + message->GetType(),
           JobExecutionPhase::MAIN),
       m_consumer{std::move(consumer)}, m_message{message},
-      m_connection_info(std::move(connection_info)) {}
+      m_connection_info(std::move(connection_info)) {
+  // allows containing floods of incoming messages (see JobCategoryLimits)
+  SetCategory("networking");
+}
 
 JobContinuation MessageConsumerJob::ConsumeMessage(
     [[maybe_unused]] jobsystem::JobContext *context) {
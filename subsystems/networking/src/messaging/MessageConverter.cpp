@@ -1,5 +1,6 @@
 #include "networking/messaging/MessageConverter.h"
 #include "logging/LogManager.h"
+#include "networking/messaging/BinaryMessageConverter.h"
 #include "networking/util/MultipartFormdata.h"
 #include <boost/json.hpp>
 
@@ -136,3 +137,45 @@ MessageConverter::FromMultipartFormData(const std::string &multipart_string) {
 
   return parsed_message;
 }
+
+std::string MessageConverter::ToWireFormat(const SharedMessage &message,
+                                           WireFormat format) {
+  switch (format) {
+  case WireFormat::BINARY:
+    return BinaryMessageConverter::ToBinary(message);
+  default:
+    return ToMultipartFormData(message);
+  }
+}
+
+SharedMessage MessageConverter::FromWireFormat(const std::string &payload) {
+  return FromWireFormat(std::make_shared<const std::string>(payload));
+}
+
+SharedMessage MessageConverter::FromWireFormat(const SharedPayload &payload) {
+  if (!BinaryMessageConverter::IsBinary(*payload)) {
+    return FromMultipartFormData(*payload);
+  }
+
+  try {
+    return BinaryMessageConverter::FromBinary(payload);
+  } catch (const BinaryFrameInvalidException &exception) {
+    THROW_EXCEPTION(MessagePayloadInvalidException,
+                    "cannot parse binary message: " << exception.what())
+  }
+}
+
+std::vector<SharedMessage>
+MessageConverter::FromWireFormatBatch(const SharedPayload &payload) {
+  if (!BinaryMessageConverter::IsBinaryBatch(*payload)) {
+    return {FromWireFormat(payload)};
+  }
+
+  try {
+    return BinaryMessageConverter::FromBinaryBatch(payload);
+  } catch (const BinaryFrameInvalidException &exception) {
+    THROW_EXCEPTION(MessagePayloadInvalidException,
+                    "cannot parse batch of binary messages: "
+                        << exception.what())
+  }
+}
@@ -0,0 +1,145 @@
+#include "networking/messaging/PayloadCompressor.h"
+#include <cstring>
+
+using namespace hive::networking::messaging;
+namespace zlib = boost::beast::zlib;
+
+static constexpr char c_magic[4] = {'H', 'I', 'V', 'Z'};
+
+/** deflate streams of beast are raw, so the maximum window size is used */
+#define WINDOW_BITS 15
+#define MEMORY_LEVEL 8
+
+PayloadCompressor::PayloadCompressor(size_t threshold, int level)
+    : m_threshold{threshold} {
+  m_deflate_stream.reset(level, WINDOW_BITS, MEMORY_LEVEL,
+                         zlib::Strategy::normal);
+  m_inflate_stream.reset(WINDOW_BITS);
+}
+
+std::optional<std::string>
+PayloadCompressor::Compress(const std::string &payload) {
+  if (payload.size() < m_threshold) {
+    return {};
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::string compressed(
+      c_header_size + m_deflate_stream.upper_bound(payload.size()), '\0');
+  char *data = compressed.data();
+
+  std::memcpy(data, c_magic, sizeof(c_magic));
+  data[4] = static_cast<char>(c_version);
+  data[5] = static_cast<char>(PayloadCompression::DEFLATE);
+  uint64_t uncompressed_size = payload.size();
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    data[8 + i] = static_cast<char>((uncompressed_size >> (8 * i)) & 0xFF);
+  }
+
+  zlib::z_params params;
+  params.next_in = payload.data();
+  params.avail_in = payload.size();
+  params.next_out = data + c_header_size;
+  params.avail_out = compressed.size() - c_header_size;
+
+  // output space suffices, so the payload is compressed in a single step
+  boost::system::error_code error_code;
+  m_deflate_stream.reset();
+  m_deflate_stream.write(params, zlib::Flush::finish, error_code);
+
+  auto duration = std::chrono::steady_clock::now() - start;
+
+  bool compressed_successfully = error_code == zlib::error::end_of_stream;
+  compressed.resize(c_header_size + params.total_out);
+
+  // incompressible payloads (e.g. already encoded images) are sent as they are
+  if (!compressed_successfully || compressed.size() >= payload.size()) {
+    return {};
+  }
+
+  std::unique_lock lock(m_statistics_mutex);
+  m_statistics.compressed_payloads++;
+  m_statistics.uncompressed_bytes += payload.size();
+  m_statistics.compressed_bytes += compressed.size();
+  m_statistics.compression_time +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+
+  return compressed;
+}
+
+bool PayloadCompressor::IsCompressed(const std::string &payload) {
+  return payload.size() >= c_header_size &&
+         std::memcmp(payload.data(), c_magic, sizeof(c_magic)) == 0;
+}
+
+std::string PayloadCompressor::Decompress(const std::string &payload) {
+  if (!IsCompressed(payload)) {
+    THROW_EXCEPTION(PayloadCompressionException, "payload is not compressed")
+  }
+
+  auto version = static_cast<uint8_t>(payload[4]);
+  auto compression = static_cast<uint8_t>(payload[5]);
+  if (version != c_version || compression != PayloadCompression::DEFLATE) {
+    THROW_EXCEPTION(PayloadCompressionException,
+                    "compression " << static_cast<int>(compression)
+                                   << " of version "
+                                   << static_cast<int>(version)
+                                   << " is not supported")
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  uint64_t uncompressed_size = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    uncompressed_size |=
+        static_cast<uint64_t>(static_cast<uint8_t>(payload[8 + i])) << (8 * i);
+  }
+
+  // deflate cannot expand data by more than this, so larger sizes are corrupt
+  if (uncompressed_size / 1032 > payload.size()) {
+    THROW_EXCEPTION(PayloadCompressionException,
+                    "compressed payload of " << payload.size()
+                                             << " bytes claims to contain "
+                                             << uncompressed_size << " bytes")
+  }
+
+  // one spare byte lets the inflate stream reach the end of the deflate stream
+  // even if the output is already complete
+  std::string uncompressed(uncompressed_size + 1, '\0');
+
+  zlib::z_params params;
+  params.next_in = payload.data() + c_header_size;
+  params.avail_in = payload.size() - c_header_size;
+  params.next_out = uncompressed.data();
+  params.avail_out = uncompressed.size();
+
+  boost::system::error_code error_code;
+  m_inflate_stream.reset();
+
+  // inflate until the end of the stream or until it does not progress anymore
+  do {
+    m_inflate_stream.write(params, zlib::Flush::sync, error_code);
+  } while (!error_code);
+
+  // beast does not always report the end of the stream, if the input ends
+  // right after its last code, so consuming all input suffices as well
+  bool is_complete = error_code == zlib::error::end_of_stream ||
+                     (error_code == zlib::error::need_buffers &&
+                      params.avail_in == 0);
+  if (!is_complete || params.total_out != uncompressed_size) {
+    THROW_EXCEPTION(PayloadCompressionException,
+                    "cannot decompress payload: " << error_code.message())
+  }
+
+  uncompressed.resize(uncompressed_size);
+
+  auto duration = std::chrono::steady_clock::now() - start;
+
+  std::unique_lock lock(m_statistics_mutex);
+  m_statistics.decompressed_payloads++;
+  m_statistics.decompression_time +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+
+  return uncompressed;
+}
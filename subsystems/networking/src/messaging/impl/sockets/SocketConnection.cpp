@@ -0,0 +1,369 @@
+#include "networking/messaging/impl/sockets/SocketConnection.h"
+#include "logging/LogManager.h"
+#include "networking/messaging/MessageConverter.h"
+#include "networking/util/LittleEndian.h"
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <cstring>
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::sockets;
+using namespace hive::networking::util;
+namespace asio = boost::asio;
+using error_code = boost::system::error_code;
+
+using namespace std::chrono_literals;
+
+#define HANDSHAKE_TIMEOUT 5s
+
+/** Count of messages written by a single gathering write at most */
+static constexpr size_t c_max_gathered_messages = 64;
+
+static constexpr char c_handshake_magic[4] = {'H', 'I', 'V', 'S'};
+static constexpr uint8_t c_handshake_version = 1;
+
+SocketConnection::SocketConnection(
+    ConnectionInfo connection_info, socket_type &&socket,
+    const common::config::SharedConfiguration &config,
+    std::function<void(SharedPayload, SharedSocketConnection)>
+        on_message_received,
+    std::function<void(SharedSocketConnection)> on_connection_closed)
+    : m_socket(std::move(socket)), m_handshake_timer(m_socket.get_executor()),
+      m_message_received_callback{std::move(on_message_received)},
+      m_connection_closed_callback{std::move(on_connection_closed)},
+      m_connection_info(std::move(connection_info)) {
+
+  m_max_queued_messages = config->GetAsInt("net.send-queue.max-messages", 1024);
+  m_max_queued_bytes =
+      config->GetAsInt("net.send-queue.max-bytes", 256 * 1024 * 1024);
+  m_max_frame_size =
+      config->GetAsInt("net.socket.max-frame-bytes", 1024 * 1024 * 1024);
+
+  // sockets always use the binary wire format without compression
+  m_connection_info.wire_format = WireFormat::BINARY;
+  m_connection_info.compression = PayloadCompression::NO_COMPRESSION;
+}
+
+SocketConnection::~SocketConnection() {
+  // there are no outstanding operations anymore, so the socket can be closed
+  // right away without notifying anyone
+  if (m_open.exchange(false)) {
+    error_code ignored;
+    m_socket.shutdown(socket_type::shutdown_both, ignored);
+    m_socket.close(ignored);
+  }
+}
+
+void SocketConnection::AsyncReadFrame(FrameCallback on_frame) {
+  asio::async_read(
+      m_socket, asio::buffer(m_receive_header),
+      [_this = shared_from_this(), on_frame = std::move(on_frame)](
+          const error_code &error_code,
+          [[maybe_unused]] std::size_t bytes_transferred) mutable {
+        if (error_code) {
+          on_frame(error_code, nullptr);
+          return;
+        }
+
+        auto frame_size =
+            ReadLittleEndian<uint64_t>(_this->m_receive_header.data());
+        if (frame_size > _this->m_max_frame_size) {
+          on_frame(asio::error::message_size, nullptr);
+          return;
+        }
+
+        _this->m_receive_buffer.resize(frame_size);
+        asio::async_read(
+            _this->m_socket, asio::buffer(_this->m_receive_buffer),
+            [_this, on_frame = std::move(on_frame)](
+                const boost::system::error_code &error_code,
+                [[maybe_unused]] std::size_t bytes_transferred) {
+              if (error_code) {
+                on_frame(error_code, nullptr);
+                return;
+              }
+
+              // take over the received bytes without copying them
+              on_frame(error_code, std::make_shared<const std::string>(
+                                       std::move(_this->m_receive_buffer)));
+            });
+      });
+}
+
+void SocketConnection::Handshake(const std::string &local_node_id,
+                                 HandshakeCallback on_complete) {
+  m_handshake_frame.resize(c_frame_header_size + sizeof(c_handshake_magic) +
+                           1 + local_node_id.size());
+  char *data = m_handshake_frame.data();
+  WriteLittleEndian<uint64_t>(data,
+                              m_handshake_frame.size() - c_frame_header_size);
+  data += c_frame_header_size;
+  std::memcpy(data, c_handshake_magic, sizeof(c_handshake_magic));
+  WriteLittleEndian<uint8_t>(data + sizeof(c_handshake_magic),
+                             c_handshake_version);
+  std::memcpy(data + sizeof(c_handshake_magic) + 1, local_node_id.data(),
+              local_node_id.size());
+
+  asio::dispatch(m_socket.get_executor(), [_this = shared_from_this(),
+                                           on_complete =
+                                               std::move(on_complete)]() {
+    // the remote endpoint might never answer
+    _this->m_handshake_timer.expires_after(HANDSHAKE_TIMEOUT);
+    _this->m_handshake_timer.async_wait([_this](const error_code &error_code) {
+      if (!error_code) {
+        LOG_WARN("handshake with remote endpoint "
+                 << _this->m_connection_info.hostname << " timed out")
+        boost::system::error_code ignored;
+        _this->m_socket.cancel(ignored);
+      }
+    });
+
+    // Both sides write their handshake right away. It is completed as soon as
+    // the own handshake has been written (so it does not overlap with later
+    // writes) and the one of the remote endpoint has been received.
+    struct HandshakeState {
+      size_t pending_operations{2};
+      error_code error;
+    };
+    auto state = std::make_shared<HandshakeState>();
+    auto complete_operation = [_this, state,
+                               on_complete](const error_code &error_code) {
+      if (error_code && !state->error) {
+        state->error = error_code;
+        _this->m_handshake_timer.cancel();
+        boost::system::error_code ignored;
+        _this->m_socket.cancel(ignored);
+      }
+
+      if (--state->pending_operations > 0) {
+        return;
+      }
+
+      _this->m_handshake_timer.cancel();
+      on_complete(state->error == asio::error::operation_aborted
+                      ? asio::error::timed_out
+                      : state->error);
+    };
+
+    asio::async_write(_this->m_socket, asio::buffer(_this->m_handshake_frame),
+                      [complete_operation](const error_code &error_code,
+                                           std::size_t) {
+                        complete_operation(error_code);
+                      });
+
+    _this->AsyncReadFrame([_this, complete_operation](
+                              const error_code &error_code,
+                              SharedPayload data) {
+      if (error_code) {
+        complete_operation(error_code);
+        return;
+      }
+
+      bool is_valid =
+          data->size() > sizeof(c_handshake_magic) &&
+          std::memcmp(data->data(), c_handshake_magic,
+                      sizeof(c_handshake_magic)) == 0 &&
+          ReadLittleEndian<uint8_t>(data->data() + sizeof(c_handshake_magic)) ==
+              c_handshake_version;
+      if (!is_valid) {
+        complete_operation(asio::error::invalid_argument);
+        return;
+      }
+
+      _this->m_connection_info.endpoint_id =
+          data->substr(sizeof(c_handshake_magic) + 1);
+      complete_operation(error_code);
+    });
+  });
+}
+
+void SocketConnection::StartReceivingMessages() {
+  asio::dispatch(m_socket.get_executor(), [_this = shared_from_this()]() {
+    _this->AsyncReceiveMessage();
+  });
+}
+
+void SocketConnection::AsyncReceiveMessage() {
+  AsyncReadFrame([_this = shared_from_this()](const error_code &error_code,
+                                              SharedPayload data) {
+    _this->OnMessageReceived(error_code, std::move(data));
+  });
+}
+
+void SocketConnection::OnMessageReceived(const error_code &error_code,
+                                         SharedPayload data) {
+  if (error_code == asio::error::operation_aborted) {
+    LOG_DEBUG("local host has cancelled listening to messages from "
+              << m_connection_info.hostname)
+    return;
+  }
+
+  if (error_code) {
+    if (error_code != asio::error::eof &&
+        error_code != asio::error::connection_reset) {
+      LOG_ERR("failed to receive message from host "
+              << m_connection_info.hostname << ": " << error_code.message())
+    }
+
+    Close();
+    return;
+  }
+
+  m_message_received_callback(std::move(data), shared_from_this());
+
+  // messages of this connection are processed one after another in order
+  if (IsUsable()) {
+    AsyncReceiveMessage();
+  }
+}
+
+void SocketConnection::Close() {
+  if (!m_open.exchange(false)) {
+    return;
+  }
+
+  // the socket must only be used on its strand
+  asio::post(m_socket.get_executor(), [_this = shared_from_this()]() {
+    error_code ignored;
+    _this->m_handshake_timer.cancel();
+    _this->m_socket.shutdown(socket_type::shutdown_both, ignored);
+    _this->m_socket.close(ignored);
+  });
+
+  LOG_INFO("closed socket connection to " << m_connection_info.hostname)
+
+  m_connection_closed_callback(shared_from_this());
+}
+
+std::future<void> SocketConnection::Send(const SharedMessage &message) {
+  auto data = std::make_shared<const std::string>(
+      MessageConverter::ToWireFormat(message, WireFormat::BINARY));
+
+  auto sending_promise = std::make_shared<std::promise<void>>();
+  std::future<void> sending_future = sending_promise->get_future();
+  Send(message, std::move(data),
+       [sending_promise](const std::exception_ptr &error) {
+         if (error) {
+           sending_promise->set_exception(error);
+         } else {
+           sending_promise->set_value();
+         }
+       });
+
+  return sending_future;
+}
+
+void SocketConnection::Send(const SharedMessage &message, SharedPayload data,
+                            SendCallback on_sent) {
+  if (!IsUsable()) {
+    LOG_WARN("cannot sent message via socket to remote host "
+             << m_connection_info.hostname << " because socket is closed")
+
+    THROW_EXCEPTION(ConnectionClosedException, "connection is not open")
+  }
+
+  std::unique_lock lock(m_send_queue_mutex);
+
+  // reject instead of blocking the sender, if the remote host cannot keep up
+  bool queue_is_full =
+      !m_send_queue.empty() &&
+      (m_send_queue.size() >= m_max_queued_messages ||
+       m_send_queue_bytes + data->size() > m_max_queued_bytes);
+  if (queue_is_full) {
+    lock.unlock();
+    LOG_WARN("cannot send message of type "
+             << message->GetType() << " via socket to remote host "
+             << m_connection_info.hostname << " because its send queue is full")
+    auto exception = BUILD_EXCEPTION(SendQueueFullException,
+                                     "send queue of connection to remote host "
+                                         << m_connection_info.hostname
+                                         << " is full");
+    on_sent(std::make_exception_ptr(exception));
+    return;
+  }
+
+  m_send_queue_bytes += data->size();
+  m_send_queue.push_back({std::move(on_sent), message, std::move(data)});
+
+  // only one write can be in flight, so the writer drains the queue
+  if (!m_writing) {
+    m_writing = true;
+    asio::post(m_socket.get_executor(), [_this = shared_from_this()]() {
+      _this->WriteNextMessages();
+    });
+  }
+}
+
+void SocketConnection::WriteNextMessages() {
+  // each message is written as length prefix followed by the message itself
+  std::vector<asio::const_buffer> buffers;
+  {
+    std::unique_lock lock(m_send_queue_mutex);
+    DEBUG_ASSERT(!m_send_queue.empty(), "send queue should not be empty")
+    m_in_flight_count = std::min(m_send_queue.size(), c_max_gathered_messages);
+
+    m_write_headers.resize(m_in_flight_count);
+    buffers.reserve(2 * m_in_flight_count);
+    for (size_t i = 0; i < m_in_flight_count; i++) {
+      const auto &data = m_send_queue[i].data;
+      WriteLittleEndian<uint64_t>(m_write_headers[i].data(), data->size());
+      buffers.emplace_back(asio::buffer(m_write_headers[i]));
+      buffers.emplace_back(asio::buffer(*data));
+    }
+  }
+
+  // the queued payloads are kept alive by the queue until they are written
+  asio::async_write(m_socket, buffers,
+                    [_this = shared_from_this()](const error_code &error_code,
+                                                 std::size_t bytes_transferred) {
+                      _this->OnMessagesSent(error_code, bytes_transferred);
+                    });
+}
+
+void SocketConnection::OnMessagesSent(const error_code &error_code,
+                                      std::size_t bytes_transferred) {
+  std::vector<PendingMessage> sent_messages;
+  std::unique_lock lock(m_send_queue_mutex);
+  for (size_t i = 0; i < m_in_flight_count; i++) {
+    m_send_queue_bytes -= m_send_queue.front().data->size();
+    sent_messages.push_back(std::move(m_send_queue.front()));
+    m_send_queue.pop_front();
+  }
+
+  bool more_messages_queued = !m_send_queue.empty();
+  m_writing = more_messages_queued;
+  lock.unlock();
+
+  if (more_messages_queued) {
+    WriteNextMessages();
+  }
+
+  if (error_code) {
+    LOG_WARN("sending " << sent_messages.size()
+                        << " message(s) via socket to remote host "
+                        << m_connection_info.hostname
+                        << " failed: " << error_code.message())
+    auto exception = BUILD_EXCEPTION(MessageSendingException,
+                                     "sending message via socket to remote "
+                                     "host "
+                                         << m_connection_info.hostname
+                                         << " failed: "
+                                         << error_code.message());
+    for (auto &sent : sent_messages) {
+      sent.on_sent(std::make_exception_ptr(exception));
+    }
+
+    Close();
+    return;
+  }
+
+  for (auto &sent : sent_messages) {
+    sent.on_sent(nullptr);
+  }
+
+  LOG_DEBUG("sent " << sent_messages.size() << " message(s) ("
+                    << bytes_transferred << " bytes) via socket to host "
+                    << m_connection_info.hostname)
+}
@@ -0,0 +1,481 @@
+#include "networking/messaging/impl/sockets/SocketEndpoint.h"
+
+#include "data/DataLayer.h"
+#include "events/broker/IEventBroker.h"
+#include "logging/LogManager.h"
+#include "networking/NetworkingManager.h"
+#include "networking/messaging/MessageConverter.h"
+#include "networking/messaging/events/ConnectionClosedEvent.h"
+#include "networking/messaging/events/ConnectionEstablishedEvent.h"
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+#include <utility>
+
+using namespace hive::jobsystem;
+using namespace hive::networking;
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::sockets;
+namespace asio = boost::asio;
+using error_code = boost::system::error_code;
+
+SocketEndpoint::SocketEndpoint(
+    const common::memory::Reference<common::subsystems::SubsystemManager>
+        &subsystems,
+    common::config::SharedConfiguration config)
+    : m_subsystems(subsystems), m_config(std::move(config)) {}
+
+SocketEndpoint::~SocketEndpoint() {
+  if (m_running) {
+    SocketEndpoint::Shutdown();
+  } else if (m_execution_contexts) {
+    // connections must not be used by execution threads while being destroyed
+    m_execution_contexts->Stop(true);
+  }
+}
+
+void SocketEndpoint::Startup() {
+  // read configuration
+  const std::string config_prefix = "net." + GetProtocol();
+  bool init_server_at_startup =
+      m_config->GetBool(config_prefix + ".auto-init", true);
+  int thread_count = m_config->GetAsInt(config_prefix + ".threads", 1);
+  bool context_per_thread =
+      m_config->GetBool("net.threads.context-per-thread", false);
+
+  // get id of this node (required for handshake)
+  auto property_provider =
+      m_subsystems.Borrow()->RequireSubsystem<data::DataLayer>();
+  m_node_id = property_provider->Get("net.node.id").get().value_or("");
+
+  m_execution_contexts = std::make_shared<util::ExecutionContextPool>(
+      thread_count, context_per_thread);
+
+  m_streams = std::make_shared<streams::MessageStreamMultiplexer>(
+      m_config,
+      std::bind(&SocketEndpoint::Send, this, std::placeholders::_1,
+                std::placeholders::_2),
+      [this](streams::SharedMessageStreamReader reader,
+             const ConnectionInfo &info) {
+        auto maybe_subsystems = m_subsystems.TryBorrow();
+        if (!maybe_subsystems.has_value()) {
+          return false;
+        }
+
+        auto maybe_networking_manager =
+            maybe_subsystems.value()->GetSubsystem<NetworkingManager>();
+        return maybe_networking_manager.has_value() &&
+               maybe_networking_manager.value()->ProcessMessageStream(
+                   std::move(reader), info);
+      });
+
+  if (init_server_at_startup) {
+    auto local_endpoint = GetLocalEndpoint();
+    m_acceptor = std::make_unique<acceptor_type>(
+        asio::make_strand(*m_execution_contexts->GetContext(0)));
+
+    error_code error_code;
+    m_acceptor->open(local_endpoint.protocol(), error_code);
+    if (!error_code) {
+      // allows restarting a node while old connections are still closing
+      m_acceptor->set_option(asio::socket_base::reuse_address(true),
+                             error_code);
+    }
+    if (!error_code) {
+      m_acceptor->bind(local_endpoint, error_code);
+    }
+    if (!error_code) {
+      m_acceptor->listen(asio::socket_base::max_listen_connections,
+                         error_code);
+    }
+
+    if (error_code) {
+      LOG_ERR("cannot listen for " << GetProtocol()
+                                   << " socket connections: "
+                                   << error_code.message())
+      THROW_EXCEPTION(EndpointSetupException,
+                      "cannot listen for " << GetProtocol()
+                                           << " socket connections: "
+                                           << error_code.message())
+    }
+
+    AcceptConnection();
+  }
+
+  m_running = true;
+  m_execution_contexts->Start();
+}
+
+void SocketEndpoint::Shutdown() {
+  m_running = false;
+
+  if (m_acceptor) {
+    asio::post(m_acceptor->get_executor(), [this]() {
+      error_code ignored;
+      m_acceptor->close(ignored);
+    });
+  }
+
+  // connections remove themselves from the map when being closed
+  std::unique_lock lock(m_connections_mutex);
+  auto connections = m_connections;
+  lock.unlock();
+
+  for (const auto &[node_id, connection] : connections) {
+    connection->Close();
+  }
+
+  // wait until all worker threads have returned
+  m_execution_contexts->Stop();
+
+  LOG_DEBUG("local " << GetProtocol() << " socket endpoint has been shut down")
+}
+
+void SocketEndpoint::AcceptConnection() {
+  // accepted sockets are distributed among the execution contexts
+  m_acceptor->async_accept(
+      asio::make_strand(*m_execution_contexts->GetNextContext()),
+      [this](const error_code &error_code, socket_type socket) {
+        if (error_code == asio::error::operation_aborted || !m_running) {
+          return;
+        }
+
+        if (error_code) {
+          LOG_ERR("cannot accept " << GetProtocol() << " socket connection: "
+                                   << error_code.message())
+        } else {
+          ConfigureSocket(socket);
+          StartHandshake(std::move(socket), "incoming " + GetProtocol(),
+                         [this](const SharedSocketConnection &connection) {
+                           if (connection) {
+                             AddConnection(connection);
+                           }
+                         });
+        }
+
+        AcceptConnection();
+      });
+}
+
+void SocketEndpoint::StartHandshake(
+    socket_type &&socket, const std::string &hostname,
+    std::function<void(const SharedSocketConnection &)> on_complete) {
+
+  ConnectionInfo connection_info;
+  connection_info.hostname = hostname;
+
+  auto connection = std::make_shared<SocketConnection>(
+      std::move(connection_info), std::move(socket), m_config,
+      std::bind(&SocketEndpoint::ProcessReceivedMessage, this,
+                std::placeholders::_1, std::placeholders::_2),
+      std::bind(&SocketEndpoint::OnConnectionClose, this,
+                std::placeholders::_1));
+
+  connection->Handshake(
+      m_node_id, [connection, hostname, on_complete = std::move(on_complete)](
+                     const error_code &error_code) {
+        if (error_code) {
+          LOG_WARN("handshake with " << hostname << " failed: "
+                                     << error_code.message())
+          on_complete(nullptr);
+          return;
+        }
+
+        on_complete(connection);
+      });
+}
+
+void SocketEndpoint::AddConnection(const SharedSocketConnection &connection) {
+  const auto &connection_info = connection->GetInfo();
+
+  std::unique_lock lock(m_connections_mutex);
+
+  // the endpoint might have been shut down in the meantime, which closes all
+  // registered connections
+  if (!m_running) {
+    lock.unlock();
+    connection->Close();
+    return;
+  }
+
+  // if connection to this node already exists, close old connection
+  SharedSocketConnection old_connection;
+  if (m_connections.contains(connection_info.endpoint_id)) {
+    LOG_WARN("established connection with node " << connection_info.endpoint_id
+                                                 << " already exists.")
+    old_connection = m_connections.at(connection_info.endpoint_id);
+  }
+
+  // register new connection
+  m_connections[connection_info.endpoint_id] = connection;
+  lock.unlock();
+
+  if (old_connection) {
+    old_connection->Close();
+  }
+
+  connection->StartReceivingMessages();
+
+  LOG_INFO("established " << GetProtocol() << " socket connection with node "
+                          << connection_info.endpoint_id)
+
+  // fire an event that signals the establishment of a new connection
+  if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
+    auto subsystems = maybe_subsystems.value();
+
+    // fire event if event subsystem is found
+    if (subsystems->ProvidesSubsystem<events::IEventBroker>()) {
+      ConnectionEstablishedEvent event;
+      event.SetEndpointId(connection_info.endpoint_id);
+
+      auto event_subsystem =
+          subsystems->RequireSubsystem<events::IEventBroker>();
+      event_subsystem->FireEvent(event.GetEvent());
+    }
+  }
+}
+
+std::optional<SharedSocketConnection>
+SocketEndpoint::GetConnection(const std::string &node_id) const {
+  std::unique_lock lock(m_connections_mutex);
+  auto iterator = m_connections.find(node_id);
+  if (iterator != m_connections.end() && iterator->second->IsUsable()) {
+    return iterator->second;
+  }
+
+  return {};
+}
+
+void SocketEndpoint::ProcessReceivedMessage(
+    SharedPayload data, const SharedSocketConnection &over_connection) {
+
+  if (!m_running) {
+    return;
+  }
+
+  SharedMessage message;
+  try {
+    message = MessageConverter::FromWireFormat(data);
+  } catch (const MessagePayloadInvalidException &ex) {
+    LOG_WARN("message received from host "
+             << over_connection->GetInfo().hostname
+             << " contained invalid payload: " << ex.what())
+    return;
+  }
+
+  // stream fragments and credit are handled right away on this thread
+  if (m_streams->ProcessMessage(message, over_connection->GetInfo())) {
+    return;
+  }
+
+  auto maybe_subsystems = m_subsystems.TryBorrow();
+  auto maybe_networking_manager =
+      maybe_subsystems.has_value()
+          ? maybe_subsystems.value()->GetSubsystem<NetworkingManager>()
+          : std::nullopt;
+
+  if (maybe_networking_manager.has_value()) {
+    maybe_networking_manager.value()->ProcessMessage(
+        message, over_connection->GetInfo());
+  } else {
+    LOG_ERR("message received from host "
+            << over_connection->GetInfo().hostname
+            << " could not be processed because networking subsystem has "
+               "already shut down")
+  }
+}
+
+std::future<void> SocketEndpoint::Send(const std::string &node_id,
+                                       SharedMessage message) {
+  auto maybe_connection = GetConnection(node_id);
+  if (!maybe_connection.has_value()) {
+    THROW_EXCEPTION(NoSuchEndpointException,
+                    "node " << node_id << " does not exist")
+  }
+
+  return maybe_connection.value()->Send(message);
+}
+
+streams::SharedMessageStreamWriter
+SocketEndpoint::OpenStream(const std::string &node_id,
+                           const std::string &stream_type) {
+  if (!HasConnectionTo(node_id)) {
+    THROW_EXCEPTION(NoSuchEndpointException,
+                    "node " << node_id << " does not exist")
+  }
+
+  return m_streams->OpenStream(node_id, stream_type);
+}
+
+std::future<ConnectionInfo>
+SocketEndpoint::EstablishConnectionTo(const std::string &uri) {
+  auto promise = std::make_shared<std::promise<ConnectionInfo>>();
+  auto future = promise->get_future();
+
+  // resolving host names (e.g. of TCP endpoints) might involve DNS queries,
+  // which must not block the caller
+  auto socket = std::make_shared<socket_type>(
+      asio::make_strand(*m_execution_contexts->GetNextContext()));
+  ResolveEndpoint(uri, socket->get_executor(),
+                  [this, socket, uri, promise](std::exception_ptr error,
+                                               endpoint_type remote_endpoint) {
+                    if (error) {
+                      promise->set_exception(error);
+                      return;
+                    }
+
+                    ConnectTo(socket, remote_endpoint, uri, promise);
+                  });
+
+  return future;
+}
+
+void SocketEndpoint::ConnectTo(
+    const std::shared_ptr<socket_type> &socket,
+    const endpoint_type &remote_endpoint, const std::string &uri,
+    const std::shared_ptr<std::promise<ConnectionInfo>> &promise) {
+  socket->async_connect(
+      remote_endpoint,
+      [this, socket, uri, promise](const error_code &error_code) {
+        if (error_code) {
+          LOG_WARN("cannot connect to " << uri << " via " << GetProtocol()
+                                        << " socket: " << error_code.message())
+          auto exception = BUILD_EXCEPTION(ConnectionFailedException,
+                                           "cannot connect to "
+                                               << uri << ": "
+                                               << error_code.message());
+          promise->set_exception(std::make_exception_ptr(exception));
+          return;
+        }
+
+        ConfigureSocket(*socket);
+        StartHandshake(
+            std::move(*socket), uri,
+            [this, uri, promise](const SharedSocketConnection &connection) {
+              if (!connection) {
+                auto exception = BUILD_EXCEPTION(ConnectionFailedException,
+                                                 "handshake with "
+                                                     << uri << " failed");
+                promise->set_exception(std::make_exception_ptr(exception));
+                return;
+              }
+
+              AddConnection(connection);
+              promise->set_value(connection->GetInfo());
+            });
+      });
+}
+
+void SocketEndpoint::CloseConnectionTo(const std::string &node_id) {
+  if (auto maybe_connection = GetConnection(node_id)) {
+    maybe_connection.value()->Close();
+  }
+}
+
+bool SocketEndpoint::HasConnectionTo(const std::string &node_id) const {
+  return GetConnection(node_id).has_value();
+}
+
+size_t SocketEndpoint::GetActiveConnectionCount() const {
+  std::unique_lock lock(m_connections_mutex);
+  size_t count = 0;
+  for (const auto &[node_id, connection] : m_connections) {
+    if (connection->IsUsable()) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+std::future<size_t>
+SocketEndpoint::IssueBroadcastAsJob(const SharedMessage &message) {
+
+  DEBUG_ASSERT(!message->GetId().empty(), "message id should not be empty")
+  DEBUG_ASSERT(!message->GetType().empty(), "message type should not be empty")
+
+  std::shared_ptr<std::promise<size_t>> promise =
+      std::make_shared<std::promise<size_t>>();
+  std::future<size_t> future = promise->get_future();
+
+  // sending does not block, so only awaiting the result is done by the job
+  auto result = std::make_shared<std::future<BroadcastResult>>(
+      Broadcast(message));
+
+  SharedJob job = std::make_shared<Job>(
+      [result, promise](jobsystem::JobContext *context) {
+        context->GetJobManager()->WaitForCompletion(*result);
+        promise->set_value(result->get().delivered.size());
+        return JobContinuation::DISPOSE;
+      },
+      "broadcast-" + GetProtocol() + "-socket-message-" + message->GetId());
+
+  auto subsystems = m_subsystems.Borrow();
+  auto job_manager = subsystems->RequireSubsystem<jobsystem::JobManager>();
+  job_manager->KickJob(job);
+  return future;
+}
+
+std::future<BroadcastResult>
+SocketEndpoint::Broadcast(const SharedMessage &message) {
+  auto progress = std::make_shared<BroadcastProgress>();
+  auto future = progress->GetFuture();
+
+  // all connections use the binary wire format, so it is converted once
+  auto data = std::make_shared<const std::string>(
+      MessageConverter::ToWireFormat(message, WireFormat::BINARY));
+
+  std::unique_lock lock(m_connections_mutex);
+  auto connections = m_connections;
+  lock.unlock();
+
+  for (const auto &[node_id, connection] : connections) {
+    if (!connection->IsUsable()) {
+      progress->ReportFailure(node_id, "connection is not usable");
+      continue;
+    }
+
+    progress->AddPendingSend();
+    try {
+      connection->Send(message, data,
+                       [progress, node_id](const std::exception_ptr &error) {
+                         progress->ReportSend(node_id, error);
+                       });
+    } catch (...) {
+      progress->ReportSend(node_id, std::current_exception());
+    }
+  }
+
+  progress->Seal();
+  return future;
+}
+
+void SocketEndpoint::OnConnectionClose(
+    const SharedSocketConnection &connection) {
+  const auto &id = connection->GetInfo().endpoint_id;
+
+  // connections whose handshake failed have never been registered
+  std::unique_lock lock(m_connections_mutex);
+  auto iterator = m_connections.find(id);
+  if (iterator == m_connections.end() || iterator->second != connection) {
+    return;
+  }
+  m_connections.erase(iterator);
+  lock.unlock();
+
+  if (m_streams) {
+    m_streams->OnConnectionClosed(id);
+  }
+
+  if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
+    auto subsystems = maybe_subsystems.value();
+
+    // trigger event notifying other parties that a connection has closed
+    if (subsystems->ProvidesSubsystem<events::IEventBroker>()) {
+      auto event_broker = subsystems->RequireSubsystem<events::IEventBroker>();
+
+      ConnectionClosedEvent event;
+      event.SetEndpointId(id);
+      event_broker->FireEvent(event.GetEvent());
+    }
+  }
+}
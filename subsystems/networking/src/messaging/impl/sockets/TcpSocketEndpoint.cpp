@@ -0,0 +1,85 @@
+#include "networking/messaging/impl/sockets/TcpSocketEndpoint.h"
+#include "logging/LogManager.h"
+#include "networking/util/UrlParser.h"
+#include <boost/asio/ip/tcp.hpp>
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::sockets;
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+TcpSocketEndpoint::TcpSocketEndpoint(
+    const common::memory::Reference<common::subsystems::SubsystemManager>
+        &subsystems,
+    common::config::SharedConfiguration config)
+    : SocketEndpoint(subsystems, std::move(config)) {}
+
+TcpSocketEndpoint::~TcpSocketEndpoint() {
+  if (IsRunning()) {
+    TcpSocketEndpoint::Shutdown();
+  }
+}
+
+std::string TcpSocketEndpoint::GetProtocol() const { return "tcp"; }
+
+SocketEndpoint::endpoint_type TcpSocketEndpoint::GetLocalEndpoint() const {
+  // the web-socket endpoint listens on net.port already
+  int port = m_config->GetAsInt("net.tcp.port",
+                                m_config->GetAsInt("net.port", 9000) + 1000);
+  std::string address = m_config->Get("net.address", "127.0.0.1");
+
+  boost::system::error_code error_code;
+  auto ip_address = asio::ip::make_address(address, error_code);
+  if (error_code) {
+    THROW_EXCEPTION(EndpointSetupException,
+                    "invalid address " << address << ": "
+                                       << error_code.message())
+  }
+
+  return tcp::endpoint(ip_address, port);
+}
+
+void TcpSocketEndpoint::ResolveEndpoint(
+    const std::string &uri, const socket_type::executor_type &executor,
+    resolve_handler_type on_resolved) const {
+  auto maybe_url = util::UrlParser::parse(uri);
+  if (!maybe_url.has_value() || maybe_url->port.empty()) {
+    auto exception = BUILD_EXCEPTION(UrlMalformedException,
+                                     "URI " << uri
+                                            << " must have the form "
+                                               "tcp://<host>:<port>");
+    on_resolved(std::make_exception_ptr(exception), {});
+    return;
+  }
+
+  // the resolver must outlive the asynchronous operation
+  auto resolver = std::make_shared<tcp::resolver>(executor);
+  resolver->async_resolve(
+      maybe_url->host, maybe_url->port,
+      [resolver, uri, on_resolved = std::move(on_resolved)](
+          const boost::system::error_code &error_code,
+          tcp::resolver::results_type results) {
+        if (error_code || results.empty()) {
+          LOG_WARN("cannot resolve host of URI " << uri << ": "
+                                                 << error_code.message())
+          auto exception = BUILD_EXCEPTION(UrlMalformedException,
+                                           "cannot resolve host of URI "
+                                               << uri << ": "
+                                               << error_code.message());
+          on_resolved(std::make_exception_ptr(exception), {});
+          return;
+        }
+
+        on_resolved(nullptr, results.begin()->endpoint());
+      });
+}
+
+void TcpSocketEndpoint::ConfigureSocket(socket_type &socket) const {
+  // small messages (e.g. control messages) must not be delayed
+  boost::system::error_code error_code;
+  socket.set_option(tcp::no_delay(true), error_code);
+  if (error_code) {
+    LOG_WARN("cannot disable Nagle's algorithm on TCP socket: "
+             << error_code.message())
+  }
+}
@@ -0,0 +1,123 @@
+#include "networking/messaging/impl/sockets/UnixSocketEndpoint.h"
+#include "logging/LogManager.h"
+#include <boost/asio/local/stream_protocol.hpp>
+#include <filesystem>
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::sockets;
+namespace asio = boost::asio;
+
+static const std::string c_uri_prefix = "shm://";
+
+UnixSocketEndpoint::UnixSocketEndpoint(
+    const common::memory::Reference<common::subsystems::SubsystemManager>
+        &subsystems,
+    common::config::SharedConfiguration config)
+    : SocketEndpoint(subsystems, std::move(config)) {
+
+  // nodes on the same host listen on different ports, so these are unique
+  auto default_path =
+      std::filesystem::temp_directory_path() /
+      ("hive-" + std::to_string(m_config->GetAsInt("net.port", 9000)) +
+       ".sock");
+  m_socket_path = m_config->Get("net.shm.path", default_path.string());
+}
+
+UnixSocketEndpoint::~UnixSocketEndpoint() {
+  if (IsRunning()) {
+    UnixSocketEndpoint::Shutdown();
+  }
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+/**
+ * Checks if nobody accepts connections on a socket file anymore.
+ * @param path path of the socket file
+ * @return true, if connecting to the socket file has been refused
+ */
+static bool IsStaleSocketFile(const std::string &path) {
+  asio::io_context context;
+  asio::local::stream_protocol::socket probe(context);
+  boost::system::error_code error_code;
+  probe.connect(asio::local::stream_protocol::endpoint(path), error_code);
+  return error_code == asio::error::connection_refused;
+}
+#endif
+
+void UnixSocketEndpoint::Startup() {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  // The socket file of a crashed node would prevent binding the socket, but it
+  // might as well belong to a running node, which must keep it.
+  std::error_code error_code;
+  if (std::filesystem::is_socket(m_socket_path, error_code)) {
+    if (!IsStaleSocketFile(m_socket_path)) {
+      LOG_ERR("socket file " << m_socket_path
+                             << " is in use by another process")
+      THROW_EXCEPTION(EndpointSetupException,
+                      "socket file " << m_socket_path
+                                     << " is in use by another process")
+    }
+
+    LOG_WARN("removing stale socket file " << m_socket_path)
+    std::filesystem::remove(m_socket_path, error_code);
+  }
+
+  SocketEndpoint::Startup();
+  m_owns_socket_file = std::filesystem::is_socket(m_socket_path, error_code);
+#else
+  THROW_EXCEPTION(EndpointSetupException,
+                  "unix domain sockets are not supported on this platform")
+#endif
+}
+
+void UnixSocketEndpoint::Shutdown() {
+  SocketEndpoint::Shutdown();
+  RemoveSocketFile();
+}
+
+std::string UnixSocketEndpoint::GetProtocol() const { return "shm"; }
+
+void UnixSocketEndpoint::RemoveSocketFile() {
+  if (m_owns_socket_file) {
+    std::error_code ignored;
+    std::filesystem::remove(m_socket_path, ignored);
+    m_owns_socket_file = false;
+  }
+}
+
+SocketEndpoint::endpoint_type UnixSocketEndpoint::GetLocalEndpoint() const {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  return asio::local::stream_protocol::endpoint(m_socket_path);
+#else
+  THROW_EXCEPTION(EndpointSetupException,
+                  "unix domain sockets are not supported on this platform")
+#endif
+}
+
+void UnixSocketEndpoint::ResolveEndpoint(
+    const std::string &uri,
+    [[maybe_unused]] const socket_type::executor_type &executor,
+    resolve_handler_type on_resolved) const {
+  std::string path = uri;
+  if (path.starts_with(c_uri_prefix)) {
+    path = path.substr(c_uri_prefix.size());
+  }
+
+  // socket paths are used as they are, so there is nothing to wait for
+  if (path.empty()) {
+    auto exception =
+        BUILD_EXCEPTION(UrlMalformedException,
+                        "URI " << uri << " does not contain a socket path");
+    on_resolved(std::make_exception_ptr(exception), {});
+    return;
+  }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+  on_resolved(nullptr, asio::local::stream_protocol::endpoint(path));
+#else
+  auto exception =
+      BUILD_EXCEPTION(UrlMalformedException,
+                      "unix domain sockets are not supported on this platform");
+  on_resolved(std::make_exception_ptr(exception), {});
+#endif
+}
@@ -1,5 +1,6 @@
 #include "networking/messaging/impl/websockets/boost/BoostWebSocketConnection.h"
 #include "logging/LogManager.h"
+#include "networking/messaging/BinaryMessageConverter.h"
 #include "networking/messaging/MessageConverter.h"
 #include <boost/asio.hpp>
 #include <utility>
@@ -19,14 +20,25 @@ using namespace std::chrono_literals;
 
 BoostWebSocketConnection::BoostWebSocketConnection(
     ConnectionInfo connection_info, stream_type &&web_socket_stream,
-    std::function<void(const std::string &, SharedBoostWebSocketConnection)>
+    const common::config::SharedConfiguration &config,
+    std::function<void(SharedPayload, SharedBoostWebSocketConnection)>
         on_message_received,
     std::function<void(const std::string &)> on_connection_closed)
     : m_web_socket_stream(std::move(web_socket_stream)),
+      m_batch_timer(m_web_socket_stream.get_executor()),
+      m_compressor(config->GetAsInt("net.compression.threshold", 4096),
+                   config->GetAsInt("net.compression.level", 1)),
       m_message_received_callback{std::move(on_message_received)},
       m_connection_closed_callback{std::move(on_connection_closed)},
       m_connection_info(std::move(connection_info)) {
 
+  m_max_queued_messages = config->GetAsInt("net.send-queue.max-messages", 1024);
+  m_max_queued_bytes =
+      config->GetAsInt("net.send-queue.max-bytes", 256 * 1024 * 1024);
+  m_batch_max_bytes = config->GetAsInt("net.send-batch.max-bytes", 0);
+  m_batch_window = std::chrono::milliseconds(
+      config->GetAsInt("net.send-batch.window-ms", 0));
+
   m_remote_endpoint_info =
       m_web_socket_stream.next_layer().socket().remote_endpoint();
 
@@ -77,65 +89,133 @@ void BoostWebSocketConnection::OnMessageReceived(
   if (error_code) {
     LOG_ERR("failed to receive web-socket message from host "
             << m_remote_endpoint_info.address() << ": " << error_code.message())
+
+    // nothing is read from this connection anymore, so it cannot be used
+    Close();
     return;
   }
 
-  // extract sent bytes and pass them to the callback function
-  std::string received_data = beast::buffers_to_string(m_receive_buffer.data());
-  m_receive_buffer.consume(m_receive_buffer.size());
+  // take over the received bytes (without copying them) and pass them to the
+  // callback function
+  auto received_data =
+      std::make_shared<const std::string>(std::move(m_receive_buffer));
+
+  bool is_compressed = m_connection_info.compression !=
+                           PayloadCompression::NO_COMPRESSION &&
+                       PayloadCompressor::IsCompressed(*received_data);
+  if (is_compressed) {
+    try {
+      received_data = std::make_shared<const std::string>(
+          m_compressor.Decompress(*received_data));
+    } catch (const PayloadCompressionException &exception) {
+      LOG_WARN("received corrupt compressed payload from host "
+               << GetRemoteHostAddress() << ": " << exception.what())
+      if (IsUsable()) {
+        AsyncReceiveMessage();
+      }
+      return;
+    }
+  }
+
+  m_message_received_callback(received_data, shared_from_this());
 
-  // read next message asynchronously
-  if (IsUsable()) {
+  // Read next message asynchronously, unless the callback has paused receiving
+  // (e.g. because it processes the message on another thread). Messages of
+  // this connection are therefore processed one after another in order.
+  if (!m_receive_paused && IsUsable()) {
     AsyncReceiveMessage();
   }
+}
 
-  m_message_received_callback(received_data, shared_from_this());
+void BoostWebSocketConnection::PauseReceiving() { m_receive_paused = true; }
+
+void BoostWebSocketConnection::ResumeReceiving() {
+  asio::post(m_web_socket_stream.get_executor(),
+             [_this = shared_from_this()]() {
+               if (!_this->m_receive_paused) {
+                 return;
+               }
+
+               _this->m_receive_paused = false;
+               if (_this->IsUsable()) {
+                 _this->AsyncReceiveMessage();
+               }
+             });
 }
 
 void BoostWebSocketConnection::AsyncReceiveMessage() {
+  m_receive_buffer = std::string();
+  m_receive_dynamic_buffer.emplace(m_receive_buffer);
   m_web_socket_stream.async_read(
-      m_receive_buffer,
+      *m_receive_dynamic_buffer,
       beast::bind_front_handler(&BoostWebSocketConnection::OnMessageReceived,
                                 shared_from_this()));
 }
 
 void BoostWebSocketConnection::Close() {
-  std::unique_lock lock(m_web_socket_stream_mutex);
-  if (m_web_socket_stream.is_open()) {
-    beast::error_code error_code;
-    m_web_socket_stream.close(beast::websocket::close_code::normal, error_code);
-    // shut down the TCP connection as well
-    if (m_web_socket_stream.next_layer().socket().is_open()) {
-      m_web_socket_stream.next_layer().socket().shutdown(
-          tcp::socket::shutdown_send, error_code);
-    }
+  if (!m_open.exchange(false)) {
+    return;
+  }
 
-    LOG_INFO("closed web-socket connection to "
-             << m_remote_endpoint_info.address().to_string() << ":"
-             << m_remote_endpoint_info.port())
+  // the stream must only be used on its strand, where reads and writes might
+  // still be in progress (not possible anymore, if this is being destroyed)
+  if (auto _this = weak_from_this().lock()) {
+    asio::post(m_web_socket_stream.get_executor(), [_this]() {
+      // a pending batch window would keep the execution context busy
+      _this->m_batch_timer.cancel();
+      _this->m_web_socket_stream.async_close(
+          websocket::close_code::normal, [_this](beast::error_code) {
+            // shut down the TCP connection as well
+            beast::error_code ignored;
+            auto &socket = _this->m_web_socket_stream.next_layer().socket();
+            socket.shutdown(tcp::socket::shutdown_both, ignored);
+            socket.close(ignored);
+          });
+    });
   }
 
-  m_connection_closed_callback(m_connection_info.endpoint_id);
+  LOG_INFO("closed web-socket connection to "
+           << m_remote_endpoint_info.address().to_string() << ":"
+           << m_remote_endpoint_info.port())
+
+  auto statistics = m_compressor.GetStatistics();
+  if (statistics.compressed_payloads + statistics.decompressed_payloads > 0) {
+    LOG_INFO("compression of connection to "
+             << GetRemoteHostAddress() << ": ratio "
+             << statistics.GetCompressionRatio() << " over "
+             << statistics.compressed_payloads << " payload(s) in "
+             << statistics.compression_time.count() << "ns, "
+             << statistics.decompressed_payloads << " payload(s) "
+             << "decompressed in " << statistics.decompression_time.count()
+             << "ns")
+  }
 
-  DEBUG_ASSERT(!m_web_socket_stream.is_open(), "socket should be closed now")
+  m_connection_closed_callback(m_connection_info.endpoint_id);
 }
 
 BoostWebSocketConnection::~BoostWebSocketConnection() { Close(); }
 
 std::future<void> BoostWebSocketConnection::Send(const SharedMessage &message) {
-  std::promise<void> sending_promise;
-  std::future<void> sending_future = sending_promise.get_future();
-
-  auto str_payload = std::make_shared<std::string>(
-      MessageConverter::ToMultipartFormData(message));
+  auto data = std::make_shared<const std::string>(
+      MessageConverter::ToWireFormat(message, m_connection_info.wire_format));
+
+  auto sending_promise = std::make_shared<std::promise<void>>();
+  std::future<void> sending_future = sending_promise->get_future();
+  Send(message, std::move(data),
+       [sending_promise](const std::exception_ptr &error) {
+         if (error) {
+           sending_promise->set_exception(error);
+         } else {
+           sending_promise->set_value();
+         }
+       });
 
-  /*
-   * The write call must finish before another one can be called. This lock
-   * will be released in the callback method.
-   */
-  std::unique_lock lock(m_web_socket_stream_mutex);
+  return sending_future;
+}
 
-  if (!m_web_socket_stream.is_open()) {
+void BoostWebSocketConnection::Send(const SharedMessage &message,
+                                    SharedPayload data, SendCallback on_sent) {
+  if (!IsUsable()) {
     LOG_WARN("cannot sent message via web-socket to remote host "
              << m_remote_endpoint_info.address().to_string() << ":"
              << m_remote_endpoint_info.port() << " because socket is closed")
@@ -143,45 +223,160 @@ std::future<void> BoostWebSocketConnection::Send(const SharedMessage &message) {
     THROW_EXCEPTION(ConnectionClosedException, "connection is not open")
   }
 
-  m_web_socket_stream.binary(true);
+  std::unique_lock lock(m_send_queue_mutex);
+
+  // reject instead of blocking the sender, if the remote host cannot keep up
+  bool queue_is_full =
+      !m_send_queue.empty() &&
+      (m_send_queue.size() >= m_max_queued_messages ||
+       m_send_queue_bytes + data->size() > m_max_queued_bytes);
+  if (queue_is_full) {
+    lock.unlock();
+    LOG_WARN("cannot send message of type "
+             << message->GetType() << " via web-socket to remote host "
+             << GetRemoteHostAddress() << " because its send queue is full")
+    auto exception = BUILD_EXCEPTION(SendQueueFullException,
+                                     "send queue of connection to remote host "
+                                         << GetRemoteHostAddress()
+                                         << " is full");
+    on_sent(std::make_exception_ptr(exception));
+    return;
+  }
 
-  /* THIS IS INTENTIONALLY SYNCHRONOUS
-   * Warning: The async_write call must be synchronized with some sort of lock
-   * or condition variable. The async call must finish before another can be
-   * started. The easiest way is to make it synchronous in the first place.
-   */
-  beast::error_code error_code;
-  std::size_t bytes_transferred =
-      m_web_socket_stream.write(asio::buffer(*str_payload), error_code);
+  m_send_queue_bytes += data->size();
+  m_send_queue.push_back({std::move(on_sent), message, std::move(data)});
+
+  // messages are held back for batching, unless they are latency-critical
+  // or there is already enough to fill a batch
+  bool flush_now = !IsBatching() || m_batch_window.count() == 0 ||
+                   message->IsImmediateFlush() ||
+                   m_send_queue_bytes >= m_batch_max_bytes;
+
+  // only one async_write can be in flight, so the writer drains the queue
+  if (!m_writing) {
+    m_writing = true;
+    if (flush_now) {
+      asio::post(m_web_socket_stream.get_executor(),
+                 beast::bind_front_handler(
+                     &BoostWebSocketConnection::WriteNextMessage,
+                     shared_from_this()));
+    } else {
+      m_batch_timer_pending = true;
+      asio::post(m_web_socket_stream.get_executor(),
+                 beast::bind_front_handler(
+                     &BoostWebSocketConnection::StartBatchWindow,
+                     shared_from_this()));
+    }
+  } else if (m_batch_timer_pending && flush_now) {
+    // cut the batch window short (timers must be used on the strand)
+    asio::post(m_web_socket_stream.get_executor(),
+               [_this = shared_from_this()]() {
+                 _this->m_batch_timer.cancel();
+               });
+  }
+}
 
-  OnMessageSent(std::move(sending_promise), message, str_payload,
-                std::move(lock), error_code, bytes_transferred);
+void BoostWebSocketConnection::StartBatchWindow() {
+  m_batch_timer.expires_after(m_batch_window);
+  m_batch_timer.async_wait(
+      beast::bind_front_handler(&BoostWebSocketConnection::OnBatchWindowElapsed,
+                                shared_from_this()));
+}
 
-  return sending_future;
+void BoostWebSocketConnection::OnBatchWindowElapsed(
+    [[maybe_unused]] beast::error_code error_code) {
+  {
+    std::unique_lock lock(m_send_queue_mutex);
+    m_batch_timer_pending = false;
+  }
+
+  // the window has either elapsed or was cut short: write in both cases
+  WriteNextMessage();
+}
+
+void BoostWebSocketConnection::WriteNextMessage() {
+  SharedPayload data;
+  std::vector<SharedPayload> batched_data;
+  {
+    std::unique_lock lock(m_send_queue_mutex);
+    DEBUG_ASSERT(!m_send_queue.empty(), "send queue should not be empty")
+    data = m_send_queue.front().data;
+    m_in_flight_count = 1;
+
+    // pack following messages into the same web-socket message
+    if (IsBatching()) {
+      size_t batch_size = data->size();
+      while (m_in_flight_count < m_send_queue.size()) {
+        const auto &next_data = m_send_queue[m_in_flight_count].data;
+        if (batch_size + next_data->size() > m_batch_max_bytes) {
+          break;
+        }
+        batch_size += next_data->size();
+        m_in_flight_count++;
+      }
+
+      if (m_in_flight_count > 1) {
+        for (size_t i = 0; i < m_in_flight_count; i++) {
+          batched_data.push_back(m_send_queue[i].data);
+        }
+      }
+    }
+  }
+
+  if (!batched_data.empty()) {
+    data = std::make_shared<const std::string>(
+        BinaryMessageConverter::ToBinaryBatch(batched_data));
+  }
+
+  if (m_connection_info.compression != PayloadCompression::NO_COMPRESSION) {
+    if (auto compressed = m_compressor.Compress(*data)) {
+      data =
+          std::make_shared<const std::string>(std::move(compressed.value()));
+    }
+  }
+
+  m_web_socket_stream.binary(true);
+  m_web_socket_stream.async_write(
+      asio::buffer(*data),
+      beast::bind_front_handler(&BoostWebSocketConnection::OnMessageSent,
+                                shared_from_this(), data));
 }
 
 void BoostWebSocketConnection::OnMessageSent(
-    std::promise<void> &&promise, SharedMessage message,
-    std::shared_ptr<std::string> sent_data,
-    std::unique_lock<jobsystem::recursive_mutex> lock,
-    boost::beast::error_code error_code,
+    SharedPayload sent_data, beast::error_code error_code,
     [[maybe_unused]] std::size_t bytes_transferred) {
 
-  // allow others to send messages now
+  std::vector<PendingMessage> sent_messages;
+  std::unique_lock lock(m_send_queue_mutex);
+  for (size_t i = 0; i < m_in_flight_count; i++) {
+    m_send_queue_bytes -= m_send_queue.front().data->size();
+    sent_messages.push_back(std::move(m_send_queue.front()));
+    m_send_queue.pop_front();
+  }
+
+  bool more_messages_queued = !m_send_queue.empty();
+  m_writing = more_messages_queued;
   lock.unlock();
 
+  if (more_messages_queued) {
+    WriteNextMessage();
+  }
+
   if (error_code) {
-    LOG_WARN("sending message via web-socket to remote host "
-             << m_remote_endpoint_info.address().to_string() << ":"
-             << m_remote_endpoint_info.port()
-             << " failed: " << error_code.message())
+    LOG_WARN("sending " << sent_messages.size()
+                        << " message(s) via web-socket to remote host "
+                        << m_remote_endpoint_info.address().to_string() << ":"
+                        << m_remote_endpoint_info.port()
+                        << " failed: " << error_code.message())
     auto exception =
         BUILD_EXCEPTION(MessageSendingException,
                         "sending message via web-socket to remote host "
                             << m_remote_endpoint_info.address().to_string()
                             << ":" << m_remote_endpoint_info.port()
                             << " failed: " << error_code.message());
-    promise.set_exception(std::make_exception_ptr(exception));
+    for (auto &sent : sent_messages) {
+      sent.on_sent(std::make_exception_ptr(exception));
+    }
 
     // if the connection timed out, it must be cleaned up.
     if (error_code == beast::error::timeout) {
@@ -191,10 +386,13 @@ void BoostWebSocketConnection::OnMessageSent(
     return;
   }
 
-  promise.set_value();
-  LOG_DEBUG("sent message of type "
-            << message->GetType() << " (" << sent_data->size()
-            << " bytes) via web-socket to host "
-            << m_remote_endpoint_info.address().to_string() << ":"
-            << m_remote_endpoint_info.port())
+  for (auto &sent : sent_messages) {
+    sent.on_sent(nullptr);
+  }
+
+  LOG_DEBUG("sent " << sent_messages.size() << " message(s) of type "
+                    << sent_messages.front().message->GetType() << " ("
+                    << sent_data->size() << " bytes) via web-socket to host "
+                    << m_remote_endpoint_info.address().to_string() << ":"
+                    << m_remote_endpoint_info.port())
 }
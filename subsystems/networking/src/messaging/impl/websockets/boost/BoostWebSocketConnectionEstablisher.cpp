@@ -19,12 +19,19 @@ using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 
 BoostWebSocketConnectionEstablisher::BoostWebSocketConnectionEstablisher(
     std::string this_node_uuid,
-    std::shared_ptr<asio::io_context> execution_context,
+    std::shared_ptr<util::ExecutionContextPool> execution_contexts,
+    const common::config::SharedConfiguration &config,
     std::function<void(ConnectionInfo, stream_type &&)> connection_consumer)
-    : m_resolver{asio::make_strand(*execution_context)},
-      m_execution_context{execution_context},
+    : m_resolver{asio::make_strand(*execution_contexts->GetContext(0))},
+      m_execution_contexts{execution_contexts},
       m_connection_consumer{std::move(connection_consumer)},
-      m_this_node_uuid(std::move(this_node_uuid)) {}
+      m_this_node_uuid(std::move(this_node_uuid)) {
+  m_preferred_wire_format = GetWireFormatByName(
+      config->Get("net.wire-format", GetWireFormatName(WireFormat::BINARY)));
+  m_preferred_compression = GetPayloadCompressionByName(config->Get(
+      "net.compression",
+      GetPayloadCompressionName(PayloadCompression::NO_COMPRESSION)));
+}
 
 std::future<ConnectionInfo>
 BoostWebSocketConnectionEstablisher::EstablishConnectionTo(
@@ -69,8 +76,11 @@ void BoostWebSocketConnectionEstablisher::ProcessResolvedHostnameOfServer(
     return;
   }
 
+  // Lanes to the same node share its URI, so hashing it would put all of them
+  // on the same context. Contexts are assigned in turns instead.
+  auto &execution_context = m_execution_contexts->GetNextContext();
   auto plain_tcp_stream =
-      std::make_shared<stream_type>(asio::make_strand(*m_execution_context));
+      std::make_shared<stream_type>(asio::make_strand(*execution_context));
 
   // Set the timeout for the operation
   get_lowest_layer(*plain_tcp_stream).expires_after(std::chrono::seconds(30));
@@ -114,29 +124,37 @@ void BoostWebSocketConnectionEstablisher::ProcessEstablishedTcpConnection(
   plain_tcp_stream->set_option(
       websocket::stream_base::timeout::suggested(beast::role_type::client));
 
-  // Set a decorator to change the User-Agent of the handshake
-  plain_tcp_stream->set_option(
-      websocket::stream_base::decorator([](websocket::request_type &req) {
+  // Set a decorator to change the User-Agent of the handshake and to offer the
+  // preferred wire format and compression
+  auto offered_wire_format = GetWireFormatName(m_preferred_wire_format);
+  auto offered_compression = GetPayloadCompressionName(m_preferred_compression);
+  plain_tcp_stream->set_option(websocket::stream_base::decorator(
+      [offered_wire_format,
+       offered_compression](websocket::request_type &req) {
         req.set(http::field::user_agent,
                 std::string(BOOST_BEAST_VERSION_STRING) +
                     " websocket-client-async");
+        req.set(WIRE_FORMAT_HEADER, offered_wire_format);
+        req.set(PAYLOAD_COMPRESSION_HEADER, offered_compression);
       }));
 
   auto host = endpoint_type.address().to_string() + ":" +
               std::to_string(endpoint_type.port());
 
   // Perform the websocket handshake
+  auto upgrade_response = std::make_shared<websocket::response_type>();
   plain_tcp_stream->async_handshake(
-      host, "/",
+      *upgrade_response, host, "/",
       beast::bind_front_handler(
           &BoostWebSocketConnectionEstablisher::ProcessWebSocketHandshake,
           shared_from_this(), std::move(connection_promise), uri,
-          plain_tcp_stream));
+          plain_tcp_stream, upgrade_response));
 }
 
 void BoostWebSocketConnectionEstablisher::ProcessWebSocketHandshake(
     std::promise<ConnectionInfo> &&connection_promise, std::string uri,
     std::shared_ptr<stream_type> web_socket_stream,
+    std::shared_ptr<websocket::response_type> upgrade_response,
     beast::error_code error_code) {
 
   auto remote_endpoint_info =
@@ -172,6 +190,14 @@ void BoostWebSocketConnectionEstablisher::ProcessWebSocketHandshake(
   ConnectionInfo connection_info;
   connection_info.hostname = uri;
 
+  // nodes that do not negotiate wire formats send no header (multipart)
+  connection_info.wire_format = NegotiateWireFormat(
+      std::string((*upgrade_response)[WIRE_FORMAT_HEADER]),
+      m_preferred_wire_format);
+  connection_info.compression = NegotiatePayloadCompression(
+      std::string((*upgrade_response)[PAYLOAD_COMPRESSION_HEADER]),
+      m_preferred_compression);
+
   PerformNodeHandshake(std::move(connection_promise),
                        std::move(connection_info), web_socket_stream);
 }
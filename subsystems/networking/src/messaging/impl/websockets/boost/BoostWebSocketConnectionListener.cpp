@@ -15,14 +15,20 @@ using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 
 BoostWebSocketConnectionListener::BoostWebSocketConnectionListener(
     std::string this_node_uuid,
-    std::shared_ptr<boost::asio::io_context> execution_context,
+    std::shared_ptr<util::ExecutionContextPool> execution_contexts,
     common::config::SharedConfiguration config,
     std::shared_ptr<boost::asio::ip::tcp::endpoint> local_endpoint,
     std::function<void(ConnectionInfo, stream_type &&)> connection_consumer)
     : m_connection_consumer{std::move(connection_consumer)},
-      m_execution_context{std::move(execution_context)},
+      m_execution_contexts{std::move(execution_contexts)},
       m_config{std::move(config)}, m_local_endpoint{std::move(local_endpoint)},
-      m_this_node_uuid(std::move(this_node_uuid)) {}
+      m_this_node_uuid(std::move(this_node_uuid)) {
+  m_preferred_wire_format = GetWireFormatByName(
+      m_config->Get("net.wire-format", GetWireFormatName(WireFormat::BINARY)));
+  m_preferred_compression = GetPayloadCompressionByName(m_config->Get(
+      "net.compression",
+      GetPayloadCompressionName(PayloadCompression::NO_COMPRESSION)));
+}
 
 BoostWebSocketConnectionListener::~BoostWebSocketConnectionListener() {
   ShutDown();
@@ -31,6 +37,7 @@ BoostWebSocketConnectionListener::~BoostWebSocketConnectionListener() {
 void BoostWebSocketConnectionListener::Init() {
   // load configurations
   bool should_use_tls = m_config->GetBool("net.tls.enabled", true);
+  bool reuse_port = m_config->GetBool("net.server.reuse-port", false);
 
   if (should_use_tls) {
     // TODO: implement TLS for web-sockets
@@ -38,15 +45,34 @@ void BoostWebSocketConnectionListener::Init() {
         "TLS in web-sockets is not implemented yet and is therefore not used")
   }
 
-  // setup acceptor which listens for incoming connections asynchronously
-  m_incoming_tcp_connection_acceptor =
-      std::make_unique<tcp::acceptor>(*m_execution_context);
+#ifndef SO_REUSEPORT
+  if (reuse_port) {
+    LOG_WARN("SO_REUSEPORT is not supported on this platform, so incoming "
+             "web-socket connections are accepted by a single acceptor")
+    reuse_port = false;
+  }
+#endif
+
+  // setup acceptors which listen for incoming connections asynchronously
+  m_sharded_acceptors =
+      reuse_port && m_execution_contexts->GetContextCount() > 1;
+  size_t acceptor_count =
+      m_sharded_acceptors ? m_execution_contexts->GetContextCount() : 1;
+  for (size_t i = 0; i < acceptor_count; i++) {
+    m_incoming_tcp_connection_acceptors.push_back(
+        OpenAcceptor(*m_execution_contexts->GetContext(i), reuse_port));
+  }
+}
+
+std::unique_ptr<tcp::acceptor>
+BoostWebSocketConnectionListener::OpenAcceptor(
+    asio::io_context &execution_context, bool reuse_port) {
+  auto acceptor = std::make_unique<tcp::acceptor>(execution_context);
 
   beast::error_code error_code;
 
   // open the acceptor for incoming connections
-  error_code = m_incoming_tcp_connection_acceptor->open(
-      m_local_endpoint->protocol(), error_code);
+  error_code = acceptor->open(m_local_endpoint->protocol(), error_code);
   if (error_code) {
     LOG_ERR("cannot setup acceptor for incoming web-socket connections: "
             << error_code.message())
@@ -56,8 +82,18 @@ void BoostWebSocketConnectionListener::Init() {
             << error_code.message())
   }
 
-  error_code = m_incoming_tcp_connection_acceptor->set_option(
-      asio::socket_base::reuse_address(true), error_code);
+  error_code =
+      acceptor->set_option(asio::socket_base::reuse_address(true), error_code);
+
+#ifdef SO_REUSEPORT
+  // the kernel distributes incoming connections among all acceptors
+  if (reuse_port && !error_code) {
+    typedef asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>
+        reuse_port_option;
+    error_code = acceptor->set_option(reuse_port_option(true), error_code);
+  }
+#endif
+
   if (error_code) {
     LOG_ERR("cannot set option for accepting incoming web-socket connections: "
             << error_code.message())
@@ -68,7 +104,7 @@ void BoostWebSocketConnectionListener::Init() {
   }
 
   // Bind the acceptor to the host address
-  error_code = m_incoming_tcp_connection_acceptor->bind(
+  error_code = acceptor->bind(
       tcp::endpoint(m_local_endpoint->address(), m_local_endpoint->port()),
       error_code);
   if (error_code) {
@@ -83,8 +119,8 @@ void BoostWebSocketConnectionListener::Init() {
   }
 
   // Listen for incoming connections
-  error_code = m_incoming_tcp_connection_acceptor->listen(
-      asio::socket_base::max_listen_connections, error_code);
+  error_code =
+      acceptor->listen(asio::socket_base::max_listen_connections, error_code);
   if (error_code) {
     LOG_ERR("cannot listen for incoming web-socket connections: "
             << error_code.message())
@@ -92,36 +128,55 @@ void BoostWebSocketConnectionListener::Init() {
                     "cannot listen for incoming web-socket connections: "
                         << error_code.message())
   }
+
+  return acceptor;
 }
 
 void BoostWebSocketConnectionListener::StartAcceptingAnotherConnection() {
-  if (!m_incoming_tcp_connection_acceptor->is_open()) {
+  for (size_t i = 0; i < m_incoming_tcp_connection_acceptors.size(); i++) {
+    AcceptConnection(i);
+  }
+}
+
+void BoostWebSocketConnectionListener::AcceptConnection(size_t acceptor_index) {
+  auto &acceptor = m_incoming_tcp_connection_acceptors[acceptor_index];
+  if (!acceptor->is_open()) {
     return;
   }
   LOG_DEBUG("waiting for web-socket connections on "
             << m_local_endpoint->address().to_string() << " port "
             << m_local_endpoint->port())
-  // Accept incoming connections
-  m_incoming_tcp_connection_acceptor->async_accept(
-      asio::make_strand(*m_execution_context),
+  // Accept incoming connections (on the context of the acceptor, they might
+  // be moved to another one later on)
+  auto &execution_context =
+      m_sharded_acceptors
+          ? m_execution_contexts->GetContext(acceptor_index)
+          : m_execution_contexts->GetContext(0);
+  acceptor->async_accept(
+      asio::make_strand(*execution_context),
       beast::bind_front_handler(
           &BoostWebSocketConnectionListener::ProcessTcpConnection,
-          shared_from_this()));
+          shared_from_this(), acceptor_index));
 }
 
 void BoostWebSocketConnectionListener::ProcessTcpConnection(
-    beast::error_code error_code, asio::ip::tcp::socket socket) {
+    size_t acceptor_index, beast::error_code error_code,
+    asio::ip::tcp::socket socket) {
 
   if (error_code == asio::error::operation_aborted) {
     LOG_DEBUG("local web-socket connection acceptor at "
               << m_local_endpoint->address().to_string() << ":"
               << m_local_endpoint->port() << " has stopped")
     return;
-  } else if (error_code) {
+  }
+
+  // accept further connections while this one performs its handshakes
+  AcceptConnection(acceptor_index);
+
+  if (error_code) {
     LOG_ERR(
         "server was not able to accept TCP connection for web-socket stream: "
         << error_code.message())
-    StartAcceptingAnotherConnection();
     return;
   }
 
@@ -140,6 +195,48 @@ void BoostWebSocketConnectionListener::ProcessTcpConnection(
             << local_address.to_string() << ":" << local_port << "<-"
             << remote_address.to_string() << remote_port)
 
+  // A single acceptor accepts all connections on the same context, so they are
+  // moved to the context they are pinned to by the hash of their endpoint.
+  bool must_be_moved =
+      !m_sharded_acceptors && m_execution_contexts->GetContextCount() > 1;
+  if (must_be_moved) {
+    auto hash = std::hash<std::string>()(remote_address.to_string() + ":" +
+                                         std::to_string(remote_port));
+    auto &execution_context = m_execution_contexts->GetContextByHash(hash);
+    auto protocol = socket.local_endpoint().protocol();
+
+    // Moving is only an optimization, so the connection is served on the
+    // current context if it fails (e.g. release is not supported before
+    // Windows 8.1). Exceptions would escape the context's thread.
+    beast::error_code move_error_code;
+    auto native_handle = socket.release(move_error_code);
+    if (!move_error_code) {
+      tcp::socket moved_socket(asio::make_strand(*execution_context));
+      moved_socket.assign(protocol, native_handle, move_error_code);
+      if (!move_error_code) {
+        socket = std::move(moved_socket);
+      } else {
+        // the released handle is owned by nobody, so it is taken back
+        beast::error_code assign_error_code;
+        socket.assign(protocol, native_handle, assign_error_code);
+        if (assign_error_code) {
+          LOG_ERR("cannot serve incoming TCP connection from "
+                  << remote_address.to_string() << ":" << remote_port << ": "
+                  << assign_error_code.message())
+          return;
+        }
+      }
+    }
+
+    if (move_error_code) {
+      LOG_WARN("cannot move incoming TCP connection from "
+               << remote_address.to_string() << ":" << remote_port
+               << " to its execution context, so it is served on the "
+                  "accepting one: "
+               << move_error_code.message())
+    }
+  }
+
   // create stream and perform handshake
   auto stream = std::make_shared<stream_type>(std::move(socket));
   asio::dispatch(
@@ -152,28 +249,75 @@ void BoostWebSocketConnectionListener::ProcessTcpConnection(
 void BoostWebSocketConnectionListener::PerformWebSocketHandshake(
     std::shared_ptr<stream_type> plain_tcp_stream) {
 
+  auto request_buffer = std::make_shared<beast::flat_buffer>();
+  auto upgrade_request = std::make_shared<upgrade_request_type>();
+
+  // read the upgrade request ourselves to negotiate the wire format
+  http::async_read(
+      plain_tcp_stream->next_layer(), *request_buffer, *upgrade_request,
+      beast::bind_front_handler(
+          &BoostWebSocketConnectionListener::ProcessUpgradeRequest,
+          shared_from_this(), plain_tcp_stream, request_buffer,
+          upgrade_request));
+}
+
+void BoostWebSocketConnectionListener::ProcessUpgradeRequest(
+    std::shared_ptr<stream_type> plain_tcp_stream,
+    std::shared_ptr<beast::flat_buffer> request_buffer,
+    std::shared_ptr<upgrade_request_type> upgrade_request,
+    beast::error_code ec, std::size_t bytes_transferred) {
+
+  if (ec) {
+    LOG_ERR("reading web-socket upgrade request failed: " << ec.message())
+    return;
+  }
+
+  // peers that do not negotiate wire formats only understand multipart
+  ConnectionInfo connection_info;
+  std::string offered_wire_format((*upgrade_request)[WIRE_FORMAT_HEADER]);
+  connection_info.wire_format =
+      NegotiateWireFormat(offered_wire_format, m_preferred_wire_format);
+
+  std::string offered_compression(
+      (*upgrade_request)[PAYLOAD_COMPRESSION_HEADER]);
+  connection_info.compression =
+      NegotiatePayloadCompression(offered_compression, m_preferred_compression);
+
   // Set a decorator to change the Server of the handshake
-  plain_tcp_stream->set_option(
-      websocket::stream_base::decorator([](websocket::response_type &res) {
+  plain_tcp_stream->set_option(websocket::stream_base::decorator(
+      [offered_wire_format, offered_compression,
+       connection_info](websocket::response_type &res) {
         res.set(http::field::server, std::string(BOOST_BEAST_VERSION_STRING) +
                                          " websocket-server-async");
+        if (!offered_wire_format.empty()) {
+          res.set(WIRE_FORMAT_HEADER,
+                  GetWireFormatName(connection_info.wire_format));
+        }
+        if (!offered_compression.empty()) {
+          res.set(PAYLOAD_COMPRESSION_HEADER,
+                  GetPayloadCompressionName(connection_info.compression));
+        }
       }));
 
   // Accept the websocket handshake
-  plain_tcp_stream->async_accept(beast::bind_front_handler(
-      &BoostWebSocketConnectionListener::ProcessWebSocketHandshake,
-      shared_from_this(), plain_tcp_stream));
+  plain_tcp_stream->async_accept(
+      *upgrade_request,
+      [_this = shared_from_this(), plain_tcp_stream, upgrade_request,
+       connection_info](beast::error_code ec) {
+        _this->ProcessWebSocketHandshake(plain_tcp_stream, connection_info,
+                                         ec);
+      });
 }
 
 void BoostWebSocketConnectionListener::ProcessWebSocketHandshake(
-    std::shared_ptr<stream_type> web_socket_stream, beast::error_code ec) {
+    std::shared_ptr<stream_type> web_socket_stream,
+    ConnectionInfo connection_info, beast::error_code ec) {
 
   auto address =
       web_socket_stream->next_layer().socket().remote_endpoint().address();
   if (ec) {
     LOG_ERR("performing web-socket handshake with " << address.to_string()
                                                     << ": " << ec.message())
-    StartAcceptingAnotherConnection();
     return;
   }
 
@@ -190,7 +334,6 @@ void BoostWebSocketConnectionListener::ProcessWebSocketHandshake(
             << local_address.to_string() << ":" << local_port << "<-"
             << remote_address.to_string() << ":" << remote_port)
 
-  ConnectionInfo connection_info;
   connection_info.hostname = host;
 
   // wait for handshake initiation
@@ -236,14 +379,14 @@ void BoostWebSocketConnectionListener::ProcessNodeHandshakeRequest(
                    << " sucessfully connected via web-sockets")
 
   m_connection_consumer(connection_info, std::move(*web_socket_stream));
-
-  StartAcceptingAnotherConnection();
 }
 
 void BoostWebSocketConnectionListener::ShutDown() {
   LOG_DEBUG("web-socket connection listener has been shut down")
-  if (m_incoming_tcp_connection_acceptor->is_open()) {
-    m_incoming_tcp_connection_acceptor->cancel();
-    m_incoming_tcp_connection_acceptor->close();
+  for (auto &acceptor : m_incoming_tcp_connection_acceptors) {
+    if (acceptor->is_open()) {
+      acceptor->cancel();
+      acceptor->close();
+    }
   }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "networking/messaging/MessageConverter.h"
 #include "networking/messaging/events/ConnectionClosedEvent.h"
 #include "networking/messaging/events/ConnectionEstablishedEvent.h"
+#include "networking/messaging/streams/MessageStreamProtocol.h"
 #include "networking/util/UrlParser.h"
 #include <regex>
 #include <utility>
@@ -33,56 +34,79 @@ void BoostWebSocketEndpoint::Startup() {
   // read configuration
   bool init_server_at_startup = m_config->GetBool("net.server.auto-init", true);
   int thread_count = m_config->GetAsInt("net.threads", 1);
+  bool context_per_thread =
+      m_config->GetBool("net.threads.context-per-thread", false);
   int local_endpoint_port = m_config->GetAsInt("net.port", 9000);
   std::string local_endpoint_address =
       m_config->Get("net.address", "127.0.0.1");
+  m_offload_threshold =
+      m_config->GetAsInt("net.receive.offload-bytes", 1024 * 1024);
+  m_data_lanes = std::max(m_config->GetAsInt("net.connections-per-peer", 1), 1);
+  m_control_lane = m_config->GetBool("net.connections.control-lane", false);
+  m_control_lane_max_bytes =
+      m_config->GetAsInt("net.connections.control-bytes", 64 * 1024);
+  m_striping =
+      m_config->Get("net.connections.striping", "round-robin") == "queued-bytes"
+          ? LaneStriping::QUEUED_BYTES
+          : LaneStriping::ROUND_ROBIN;
 
   m_local_endpoint = std::make_shared<boost::asio::ip::tcp::endpoint>(
       asio::ip::make_address(local_endpoint_address), local_endpoint_port);
 
-  m_execution_context = std::make_shared<boost::asio::io_context>();
+  m_execution_contexts = std::make_shared<util::ExecutionContextPool>(
+      thread_count, context_per_thread);
+
+  m_streams = std::make_shared<streams::MessageStreamMultiplexer>(
+      m_config,
+      std::bind(&BoostWebSocketEndpoint::Send, this, std::placeholders::_1,
+                std::placeholders::_2),
+      [this](streams::SharedMessageStreamReader reader,
+             const ConnectionInfo &info) {
+        auto maybe_subsystems = m_subsystems.TryBorrow();
+        if (!maybe_subsystems.has_value()) {
+          return false;
+        }
+
+        auto maybe_networking_manager =
+            maybe_subsystems.value()->GetSubsystem<NetworkingManager>();
+        return maybe_networking_manager.has_value() &&
+               maybe_networking_manager.value()->ProcessMessageStream(
+                   std::move(reader), info);
+      });
 
   if (init_server_at_startup) {
     InitAndStartConnectionListener();
-    std::unique_lock running_lock(m_running_mutex);
     m_running = true;
   }
 
   // hand threads to boost.asio for handling websocket operations.
-  std::weak_ptr<asio::io_context> weak_execution_context = m_execution_context;
-  for (size_t i = 0; i < thread_count; i++) {
-    std::thread execution([weak_execution_context]() {
-      if (auto execution_context = weak_execution_context.lock()) {
-        execution_context->run();
-      }
-    });
-    m_execution_threads.push_back(std::move(execution));
-  }
+  m_execution_contexts->Start();
 
   m_this_pointer = std::make_shared<BoostWebSocketEndpoint *>(this);
   SetupCleanUpJob();
 }
 
 void BoostWebSocketEndpoint::Shutdown() {
-  std::unique_lock running_lock(m_running_mutex);
   m_running = false;
-  running_lock.unlock();
 
   // close all endpoints
   std::unique_lock conn_lock(m_connections_mutex);
   m_connection_listener->ShutDown();
-  for (const auto &connection : m_connections) {
-    connection.second->Close();
+  std::vector<SharedBoostWebSocketConnection> connections;
+  for (const auto &[node_id, pool] : m_connections) {
+    connections.insert(connections.end(), pool.connections.begin(),
+                       pool.connections.end());
   }
   conn_lock.unlock();
 
-  // wait until all worker threads have returned
-  for (auto &execution : m_execution_threads) {
-    DEBUG_ASSERT(execution.get_id() != std::this_thread::get_id(),
-                 "Execution thread should not join itself")
-    execution.join();
+  // closed connections notify this endpoint, so the lock must not be held
+  for (const auto &connection : connections) {
+    connection->Close();
   }
 
+  // wait until all worker threads have returned
+  m_execution_contexts->Stop();
+
   LOG_DEBUG("local web-socket endpoint has been shut down")
 }
 
@@ -97,19 +121,31 @@ void BoostWebSocketEndpoint::SetupCleanUpJob() {
 
           // clean up connections that are not usable anymore
           std::unique_lock lock(endpoint->m_connections_mutex);
-          size_t size_before = endpoint->m_connections.size();
+          std::vector<std::string> disconnected_nodes;
+          size_t difference = 0;
           for (auto it = endpoint->m_connections.begin();
                it != endpoint->m_connections.end();
                /* no increment here */) {
-            if (!it->second->IsUsable()) {
-              endpoint->OnConnectionClose(it->first);
+            auto &connections = it->second.connections;
+            size_t size_before = connections.size();
+            std::erase_if(connections, [](const auto &connection) {
+              return !connection->IsUsable();
+            });
+            difference += size_before - connections.size();
+
+            if (connections.empty()) {
+              disconnected_nodes.push_back(it->first);
               it = endpoint->m_connections.erase(it);
             } else {
               ++it;
             }
           }
+          lock.unlock();
+
+          for (const auto &node_id : disconnected_nodes) {
+            endpoint->OnConnectionClose(node_id);
+          }
 
-          size_t difference = size_before - endpoint->m_connections.size();
           if (difference > 0) {
             LOG_INFO("cleaned up " << difference
                                    << " unusable or dead connections")
@@ -135,25 +171,67 @@ void BoostWebSocketEndpoint::SetupCleanUpJob() {
 }
 
 BoostWebSocketEndpoint::~BoostWebSocketEndpoint() {
-  std::unique_lock running_lock(m_running_mutex);
   if (m_running) {
     BoostWebSocketEndpoint::Shutdown();
+  } else if (m_execution_contexts) {
+    // connections must not be used by execution threads while being destroyed
+    m_execution_contexts->Stop(true);
   }
+
+  // remaining connections are destroyed after the members they would access
+  m_this_pointer.reset();
 }
 
 void BoostWebSocketEndpoint::ProcessReceivedMessage(
-    const std::string &data,
+    SharedPayload data,
     const SharedBoostWebSocketConnection &over_connection) {
 
-  std::unique_lock running_lock(m_running_mutex);
   if (!m_running) {
     return;
   }
 
-  // convert payload into message
-  SharedMessage message;
+  // Large payloads would block the I/O thread (and all other connections
+  // served by it) while being decoded, so they are offloaded to a job. The
+  // connection stops reading in the meantime to keep its messages in order.
+  bool offload = m_offload_threshold > 0 &&
+                 data->size() >= m_offload_threshold && HasOwner();
+  if (offload) {
+    auto maybe_subsystems = m_subsystems.TryBorrow();
+    auto maybe_job_manager =
+        maybe_subsystems.has_value()
+            ? maybe_subsystems.value()->GetSubsystem<jobsystem::JobManager>()
+            : std::nullopt;
+
+    if (maybe_job_manager.has_value()) {
+      over_connection->PauseReceiving();
+      SharedJob job = std::make_shared<Job>(
+          [_this = ReferenceFromThis(), data,
+           over_connection](JobContext *) mutable {
+            auto maybe_endpoint = _this.TryBorrow();
+            if (maybe_endpoint && maybe_endpoint.value()->m_running) {
+              maybe_endpoint.value()->DecodeAndDispatch(data, over_connection);
+            }
+            over_connection->ResumeReceiving();
+            return JobContinuation::DISPOSE;
+          },
+          "decode-received-payload-" + over_connection->GetInfo().endpoint_id,
+          MAIN);
+      maybe_job_manager.value()->KickJob(job);
+      return;
+    }
+  }
+
+  DecodeAndDispatch(data, over_connection);
+}
+
+void BoostWebSocketEndpoint::DecodeAndDispatch(
+    const SharedPayload &data,
+    const SharedBoostWebSocketConnection &over_connection) {
+
+  // convert payload into messages (batches contain multiple ones)
+  std::vector<SharedMessage> messages;
   try {
-    message = MessageConverter::FromMultipartFormData(data);
+    messages = MessageConverter::FromWireFormatBatch(data);
   } catch (const MessagePayloadInvalidException &ex) {
     LOG_WARN("message received from host "
              << over_connection->GetRemoteHostAddress()
@@ -161,10 +239,21 @@ void BoostWebSocketEndpoint::ProcessReceivedMessage(
     return;
   }
 
-  if (auto maybe_networking_manager =
-          m_subsystems.Borrow()->GetSubsystem<NetworkingManager>()) {
+  auto maybe_subsystems = m_subsystems.TryBorrow();
+  auto maybe_networking_manager =
+      maybe_subsystems.has_value()
+          ? maybe_subsystems.value()->GetSubsystem<NetworkingManager>()
+          : std::nullopt;
+
+  if (maybe_networking_manager.has_value()) {
     auto networking_manager = maybe_networking_manager.value();
-    networking_manager->ProcessMessage(message, over_connection->GetInfo());
+    for (const auto &message : messages) {
+      // stream fragments and credit are handled right away on this thread
+      if (m_streams->ProcessMessage(message, over_connection->GetInfo())) {
+        continue;
+      }
+      networking_manager->ProcessMessage(message, over_connection->GetInfo());
+    }
   } else {
     LOG_ERR("message received from host "
             << over_connection->GetRemoteHostAddress()
@@ -175,36 +264,63 @@ void BoostWebSocketEndpoint::ProcessReceivedMessage(
 
 void BoostWebSocketEndpoint::AddConnection(
     const ConnectionInfo &connection_info, stream_type &&stream) {
-  std::unique_lock running_lock(m_running_mutex);
   if (!m_running) {
     return;
   }
 
   SharedBoostWebSocketConnection connection =
       std::make_shared<BoostWebSocketConnection>(
-          connection_info, std::move(stream),
+          connection_info, std::move(stream), m_config,
           std::bind(&BoostWebSocketEndpoint::ProcessReceivedMessage, this,
                     std::placeholders::_1, std::placeholders::_2),
-          std::bind(&BoostWebSocketEndpoint::OnConnectionClose, this,
-                    std::placeholders::_1));
+          // connections that outlive this endpoint must not notify it
+          [weak_endpoint = std::weak_ptr(m_this_pointer)](
+              const std::string &id) {
+            if (auto endpoint = weak_endpoint.lock()) {
+              (*endpoint)->OnConnectionClose(id);
+            }
+          });
   connection->StartReceivingMessages();
 
   std::unique_lock conn_lock(m_connections_mutex);
 
-  // if connection to this node already exists, close old connection
-  bool connection_already_exists =
-      m_connections.contains(connection_info.endpoint_id);
-  if (connection_already_exists) {
+  // the endpoint might have been shut down in the meantime, which collects all
+  // registered connections while holding the lock
+  if (!m_running) {
+    conn_lock.unlock();
+    connection->Close();
+    return;
+  }
+
+  auto &pool = m_connections[connection_info.endpoint_id];
+  std::erase_if(pool.connections, [](const auto &connection) {
+    return !connection->IsUsable();
+  });
+  bool is_new_node = pool.connections.empty();
+
+  // if the pool of this node is already full, replace its oldest connection
+  SharedBoostWebSocketConnection old_connection;
+  if (pool.connections.size() >= GetPoolSize()) {
     LOG_WARN("established connection with node " << connection_info.endpoint_id
                                                  << " already exists.")
-    auto old_connection = m_connections[connection_info.endpoint_id];
-    old_connection->Close();
+    old_connection = pool.connections.front();
+    pool.connections.erase(pool.connections.begin());
   }
 
   // register new connection
-  m_connections[connection_info.endpoint_id] = connection;
+  pool.connections.push_back(connection);
+  conn_lock.unlock();
+
+  // the node is still connected over the new lane when the old one is closed
+  if (old_connection) {
+    old_connection->Close();
+  }
 
   // fire an event that signals the establishment of a new connection
+  if (!is_new_node) {
+    return;
+  }
+
   if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
     auto subsystems = maybe_subsystems.value();
 
@@ -221,18 +337,53 @@ void BoostWebSocketEndpoint::AddConnection(
 }
 
 std::optional<SharedBoostWebSocketConnection>
-BoostWebSocketEndpoint::GetConnection(const std::string &connection_id) {
+BoostWebSocketEndpoint::SelectConnection(const std::string &node_id,
+                                         const SharedMessage &message) {
   std::unique_lock lock(m_connections_mutex);
-  if (m_connections.contains(connection_id)) {
-    auto connection = m_connections.at(connection_id);
+  auto iterator = m_connections.find(node_id);
+  if (iterator == m_connections.end()) {
+    return {};
+  }
+
+  auto &pool = iterator->second;
+  std::vector<SharedBoostWebSocketConnection> usable_connections;
+  for (const auto &connection : pool.connections) {
     if (connection->IsUsable()) {
-      return connection;
-    } else {
+      usable_connections.push_back(connection);
+    }
+  }
+
+  if (usable_connections.size() <= 1) {
+    if (usable_connections.empty()) {
       return {};
     }
-  } else {
-    return {};
+    return usable_connections.front();
+  }
+
+  // the oldest connection acts as control lane
+  size_t first_data_lane = m_control_lane ? 1 : 0;
+  size_t data_lane_count = usable_connections.size() - first_data_lane;
+
+  // all messages of a stream must arrive in the order they have been sent
+  if (auto stream_id = message->GetAttributeView(STREAM_ID_ATTRIBUTE)) {
+    size_t lane = std::hash<std::string_view>()(stream_id.value());
+    return usable_connections[first_data_lane + lane % data_lane_count];
+  }
+
+  if (m_control_lane && message->GetPayloadSize() <= m_control_lane_max_bytes) {
+    return usable_connections.front();
+  }
+
+  if (m_striping == LaneStriping::QUEUED_BYTES) {
+    return *std::min_element(
+        usable_connections.begin() + first_data_lane, usable_connections.end(),
+        [](const auto &first, const auto &second) {
+          return first->GetQueuedBytes() < second->GetQueuedBytes();
+        });
   }
+
+  size_t lane = pool.next_lane++ % data_lane_count;
+  return usable_connections[first_data_lane + lane];
 }
 
 void BoostWebSocketEndpoint::InitAndStartConnectionListener() {
@@ -250,7 +401,7 @@ void BoostWebSocketEndpoint::InitAndStartConnectionListener() {
   void CleanUpConsumersOfMessageType(const std::string &type);
   if (!m_connection_listener) {
     m_connection_listener = std::make_shared<BoostWebSocketConnectionListener>(
-        node_uuid, m_execution_context, m_config, m_local_endpoint,
+        node_uuid, m_execution_contexts, m_config, m_local_endpoint,
         std::bind(&BoostWebSocketEndpoint::AddConnection, this,
                   std::placeholders::_1, std::placeholders::_2));
     m_connection_listener->Init();
@@ -268,7 +419,7 @@ void BoostWebSocketEndpoint::InitConnectionEstablisher() {
   if (!m_connection_establisher) {
     m_connection_establisher =
         std::make_shared<BoostWebSocketConnectionEstablisher>(
-            node_uuid, m_execution_context,
+            node_uuid, m_execution_contexts, m_config,
             std::bind(&BoostWebSocketEndpoint::AddConnection, this,
                       std::placeholders::_1, std::placeholders::_2));
   }
@@ -276,7 +427,7 @@ void BoostWebSocketEndpoint::InitConnectionEstablisher() {
 
 std::future<void> BoostWebSocketEndpoint::Send(const std::string &node_id,
                                                SharedMessage message) {
-  auto maybe_connection = GetConnection(node_id);
+  auto maybe_connection = SelectConnection(node_id, message);
 
   bool no_connection_to_node_exists = !maybe_connection.has_value();
   if (no_connection_to_node_exists) {
@@ -287,6 +438,17 @@ std::future<void> BoostWebSocketEndpoint::Send(const std::string &node_id,
   return maybe_connection.value()->Send(message);
 }
 
+streams::SharedMessageStreamWriter
+BoostWebSocketEndpoint::OpenStream(const std::string &node_id,
+                                   const std::string &stream_type) {
+  if (!HasConnectionTo(node_id)) {
+    THROW_EXCEPTION(NoSuchEndpointException,
+                    "node " << node_id << " does not exist")
+  }
+
+  return m_streams->OpenStream(node_id, stream_type);
+}
+
 std::future<ConnectionInfo>
 BoostWebSocketEndpoint::EstablishConnectionTo(const std::string &uri) {
   // check if connection establishment component has been initialized.
@@ -294,24 +456,69 @@ BoostWebSocketEndpoint::EstablishConnectionTo(const std::string &uri) {
     InitConnectionEstablisher();
   }
 
-  return m_connection_establisher->EstablishConnectionTo(uri);
+  auto future = m_connection_establisher->EstablishConnectionTo(uri);
+
+  // Further lanes are established in parallel. The future only represents the
+  // first one, because the node is connected as soon as there is one lane.
+  // Failures of the others are logged by the establisher.
+  for (size_t i = 1; i < GetPoolSize(); i++) {
+    m_connection_establisher->EstablishConnectionTo(uri);
+  }
+
+  return future;
 }
 
 void BoostWebSocketEndpoint::CloseConnectionTo(const std::string &node_id) {
   std::unique_lock lock(m_connections_mutex);
-  if (m_connections.contains(node_id)) {
-    m_connections.at(node_id)->Close();
-    m_connections.erase(node_id);
+  if (!m_connections.contains(node_id)) {
+    return;
   }
+
+  auto pool = std::move(m_connections.at(node_id));
+  m_connections.erase(node_id);
+  lock.unlock();
+
+  for (const auto &connection : pool.connections) {
+    connection->Close();
+  }
+}
+
+std::optional<CompressionStatistics>
+BoostWebSocketEndpoint::GetCompressionStatistics(
+    const std::string &node_id) const {
+  std::unique_lock lock(m_connections_mutex);
+  if (!m_connections.contains(node_id)) {
+    return {};
+  }
+
+  // sum up the statistics of all lanes
+  CompressionStatistics statistics;
+  for (const auto &connection : m_connections.at(node_id).connections) {
+    auto lane_statistics = connection->GetCompressionStatistics();
+    statistics.compressed_payloads += lane_statistics.compressed_payloads;
+    statistics.uncompressed_bytes += lane_statistics.uncompressed_bytes;
+    statistics.compressed_bytes += lane_statistics.compressed_bytes;
+    statistics.compression_time += lane_statistics.compression_time;
+    statistics.decompressed_payloads += lane_statistics.decompressed_payloads;
+    statistics.decompression_time += lane_statistics.decompression_time;
+  }
+  return statistics;
 }
 
 bool BoostWebSocketEndpoint::HasConnectionTo(const std::string &node_id) const {
+  return GetLaneCount(node_id) > 0;
+}
+
+size_t BoostWebSocketEndpoint::GetLaneCount(const std::string &node_id) const {
   std::unique_lock lock(m_connections_mutex);
-  if (m_connections.contains(node_id)) {
-    return m_connections.at(node_id)->IsUsable();
+  if (!m_connections.contains(node_id)) {
+    return 0;
   }
 
-  return false;
+  const auto &connections = m_connections.at(node_id).connections;
+  return std::count_if(
+      connections.begin(), connections.end(),
+      [](const auto &connection) { return connection->IsUsable(); });
 }
 
 std::future<size_t>
@@ -327,37 +534,10 @@ BoostWebSocketEndpoint::IssueBroadcastAsJob(const SharedMessage &message) {
   SharedJob job = std::make_shared<Job>(
       [_this = BorrowFromThis(), message,
        promise](jobsystem::JobContext *context) {
-        std::list<std::future<void>> futures;
-        size_t count{};
-
-        // first fire message using all available connections
-        std::unique_lock lock(_this->m_connections_mutex);
-        for (auto &connection_tuple : _this->m_connections) {
-          auto connection = connection_tuple.second;
-          if (connection->IsUsable()) {
-            auto sending_progress = connection->Send(message);
-            futures.push_back(std::move(sending_progress));
-          } else {
-            LOG_WARN("web-socket connection to remote endpoint "
-                     << connection->GetRemoteHostAddress()
-                     << " is not usable or broken. Skipped for broadcasting.")
-          }
-        }
-
-        // wait for messages to be sent
-        lock.unlock();
-        for (auto &sending_progress : futures) {
-          context->GetJobManager()->WaitForCompletion(sending_progress);
-          count++;
-          try {
-            sending_progress.get();
-          } catch (const std::exception &ex) {
-            LOG_ERR("failed to broadcast message: " << ex.what())
-            count--;
-          }
-        }
-
-        promise->set_value(count);
+        // sends are not awaited one after another, but as a whole
+        auto result = _this->Broadcast(message);
+        context->GetJobManager()->WaitForCompletion(result);
+        promise->set_value(result.get().delivered.size());
         return JobContinuation::DISPOSE;
       },
       "broadcast-web-socket-message-" + message->GetId());
@@ -368,12 +548,58 @@ BoostWebSocketEndpoint::IssueBroadcastAsJob(const SharedMessage &message) {
   return future;
 }
 
+std::future<BroadcastResult>
+BoostWebSocketEndpoint::Broadcast(const SharedMessage &message) {
+  auto progress = std::make_shared<BroadcastProgress>();
+  auto future = progress->GetFuture();
+
+  // connections using the same wire format share the converted message
+  std::map<WireFormat, SharedPayload> converted_messages;
+
+  std::unique_lock lock(m_connections_mutex);
+  for (auto &[node_id, pool] : m_connections) {
+    auto maybe_connection = SelectConnection(node_id, message);
+    if (!maybe_connection.has_value()) {
+      LOG_WARN("web-socket connections to node "
+               << node_id
+               << " are not usable or broken. Skipped for broadcasting.")
+      progress->ReportFailure(node_id, "connection is not usable");
+      continue;
+    }
+
+    const auto &connection = maybe_connection.value();
+
+    auto wire_format = connection->GetInfo().wire_format;
+    if (!converted_messages.contains(wire_format)) {
+      converted_messages[wire_format] = std::make_shared<const std::string>(
+          MessageConverter::ToWireFormat(message, wire_format));
+    }
+
+    progress->AddPendingSend();
+    try {
+      connection->Send(message, converted_messages.at(wire_format),
+                       [progress, node_id](const std::exception_ptr &error) {
+                         progress->ReportSend(node_id, error);
+                       });
+    } catch (...) {
+      progress->ReportSend(node_id, std::current_exception());
+    }
+  }
+  lock.unlock();
+
+  progress->Seal();
+  return future;
+}
+
 size_t BoostWebSocketEndpoint::GetActiveConnectionCount() const {
   std::unique_lock lock(m_connections_mutex);
   size_t count = 0;
-  for (auto &connection : m_connections) {
-    if (connection.second->IsUsable()) {
-      count++;
+  for (const auto &[node_id, pool] : m_connections) {
+    for (const auto &connection : pool.connections) {
+      if (connection->IsUsable()) {
+        count++;
+        break;
+      }
     }
   }
 
@@ -381,6 +607,17 @@ size_t BoostWebSocketEndpoint::GetActiveConnectionCount() const {
 }
 
 void BoostWebSocketEndpoint::OnConnectionClose(const std::string &id) {
+  // the node is still connected, if other lanes are left (e.g. if the closed
+  // lane has been replaced by a new one)
+  if (HasConnectionTo(id)) {
+    return;
+  }
+
+  // streams cannot continue without any connection to the node
+  if (m_streams) {
+    m_streams->OnConnectionClosed(id);
+  }
+
   if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
     auto subsystems = maybe_subsystems.value();
 
@@ -0,0 +1,315 @@
+#include "networking/messaging/streams/MessageStreamMultiplexer.h"
+#include "logging/LogManager.h"
+#include "networking/messaging/streams/MessageStreamProtocol.h"
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::streams;
+
+MessageStreamMultiplexer::MessageStreamMultiplexer(
+    const common::config::SharedConfiguration &config, SendFunction send,
+    StreamOpenedFunction on_stream_opened)
+    : m_send{std::move(send)}, m_on_stream_opened{std::move(on_stream_opened)},
+      m_window(config->GetAsInt("net.stream.window-bytes", 4 * 1024 * 1024)),
+      m_fragment_size(
+          config->GetAsInt("net.stream.fragment-bytes", 64 * 1024)) {
+  DEBUG_ASSERT(m_fragment_size > 0, "stream fragments must not be empty")
+  DEBUG_ASSERT(m_window >= m_fragment_size,
+               "stream window must fit at least one fragment")
+}
+
+SharedMessageStreamWriter
+MessageStreamMultiplexer::OpenStream(const std::string &node_id,
+                                     const std::string &stream_type) {
+  SharedMessage open_message =
+      std::make_shared<Message>(STREAM_OPEN_MESSAGE_TYPE);
+  auto stream_id = open_message->GetId();
+  open_message->SetAttribute(STREAM_ID_ATTRIBUTE, stream_id);
+  open_message->SetAttribute(STREAM_TYPE_ATTRIBUTE, stream_type);
+  open_message->SetImmediateFlush(true);
+
+  // writers must not keep the multiplexer (and its endpoint) alive
+  std::weak_ptr<MessageStreamMultiplexer> weak_multiplexer = weak_from_this();
+  auto writer = std::make_shared<MessageStreamWriter>(
+      stream_id, node_id, m_fragment_size,
+      [weak_multiplexer, node_id](SharedMessage message) {
+        if (auto multiplexer = weak_multiplexer.lock()) {
+          return multiplexer->m_send(node_id, std::move(message));
+        }
+        THROW_EXCEPTION(MessageStreamAbortedException,
+                        "endpoint of stream has been shut down")
+      });
+
+  std::unique_lock lock(m_streams_mutex);
+  std::erase_if(m_writers, [](const auto &entry) {
+    return entry.second.expired();
+  });
+  m_writers[stream_id] = writer;
+  lock.unlock();
+
+  // fails right away if there is no connection to the node
+  try {
+    m_send(node_id, open_message);
+  } catch (...) {
+    lock.lock();
+    m_writers.erase(stream_id);
+    throw;
+  }
+
+  LOG_DEBUG("opened stream " << stream_id << " of type '" << stream_type
+                             << "' to node " << node_id)
+  return writer;
+}
+
+bool MessageStreamMultiplexer::ProcessMessage(const SharedMessage &message,
+                                              const ConnectionInfo &info) {
+  auto type = message->GetType();
+  if (type == STREAM_FRAGMENT_MESSAGE_TYPE) {
+    ProcessFragmentMessage(message, info);
+  } else if (type == STREAM_CREDIT_MESSAGE_TYPE) {
+    ProcessCreditMessage(message, info);
+  } else if (type == STREAM_OPEN_MESSAGE_TYPE) {
+    ProcessOpenMessage(message, info);
+  } else if (type == STREAM_END_MESSAGE_TYPE) {
+    ProcessEndMessage(message, info);
+  } else if (type == STREAM_ABORT_MESSAGE_TYPE) {
+    ProcessAbortMessage(message, info);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+void MessageStreamMultiplexer::ProcessOpenMessage(const SharedMessage &message,
+                                                  const ConnectionInfo &info) {
+  auto stream_id = message->GetAttribute(STREAM_ID_ATTRIBUTE).value_or("");
+  auto stream_type = message->GetAttribute(STREAM_TYPE_ATTRIBUTE).value_or("");
+
+  std::weak_ptr<MessageStreamMultiplexer> weak_multiplexer = weak_from_this();
+  auto node_id = info.endpoint_id;
+  auto reader = std::make_shared<MessageStreamReader>(
+      stream_id, stream_type, m_window,
+      [weak_multiplexer, node_id, stream_id](size_t credit) {
+        if (auto multiplexer = weak_multiplexer.lock()) {
+          multiplexer->SendCredit(node_id, stream_id, credit);
+        }
+      },
+      [weak_multiplexer, node_id, stream_id](const std::string &reason) {
+        if (auto multiplexer = weak_multiplexer.lock()) {
+          std::unique_lock lock(multiplexer->m_streams_mutex);
+          multiplexer->m_readers.erase({node_id, stream_id});
+          lock.unlock();
+          multiplexer->SendAbort(node_id, stream_id, reason);
+        }
+      });
+
+  std::unique_lock lock(m_streams_mutex);
+  m_readers[{node_id, stream_id}] = reader;
+  lock.unlock();
+
+  if (!m_on_stream_opened(reader, info)) {
+    LOG_WARN("stream of type '" << stream_type << "' received from node "
+                                << node_id
+                                << " has been rejected: no consumer found")
+    reader->Cancel("no consumer for stream type '" + stream_type + "'");
+    return;
+  }
+
+  // the whole window is available initially
+  SendCredit(node_id, stream_id, m_window);
+}
+
+void MessageStreamMultiplexer::ProcessFragmentMessage(
+    const SharedMessage &message, const ConnectionInfo &info) {
+  auto stream_id = message->GetAttribute(STREAM_ID_ATTRIBUTE).value_or("");
+  auto maybe_reader = GetReader(info.endpoint_id, stream_id);
+  if (!maybe_reader.has_value()) {
+    LOG_DEBUG("received fragment of unknown or closed stream " << stream_id)
+    return;
+  }
+
+  auto reader = maybe_reader.value();
+  auto maybe_data = message->GetSharedAttribute(STREAM_DATA_ATTRIBUTE);
+  size_t sequence;
+  try {
+    sequence =
+        std::stoull(message->GetAttribute(STREAM_SEQUENCE_ATTRIBUTE).value());
+  } catch (const std::exception &) {
+    reader->Cancel("received fragment without valid sequence number");
+    return;
+  }
+
+  if (!reader->OnFragmentReceived(maybe_data.value_or(MessageAttribute{}),
+                                  sequence)) {
+    std::unique_lock lock(m_streams_mutex);
+    m_readers.erase({info.endpoint_id, stream_id});
+    lock.unlock();
+    SendAbort(info.endpoint_id, stream_id, "stream has been corrupted");
+  }
+}
+
+void MessageStreamMultiplexer::ProcessCreditMessage(
+    const SharedMessage &message, const ConnectionInfo &info) {
+  auto stream_id = message->GetAttribute(STREAM_ID_ATTRIBUTE).value_or("");
+  auto maybe_writer = GetWriter(info.endpoint_id, stream_id);
+  if (!maybe_writer.has_value()) {
+    return;
+  }
+
+  try {
+    size_t credit =
+        std::stoull(message->GetAttribute(STREAM_CREDIT_ATTRIBUTE).value());
+    maybe_writer.value()->OnCreditGranted(credit);
+  } catch (const std::exception &exception) {
+    LOG_WARN("received invalid credit for stream "
+             << stream_id << " from node " << info.endpoint_id << ": "
+             << exception.what())
+  }
+}
+
+void MessageStreamMultiplexer::ProcessEndMessage(const SharedMessage &message,
+                                                 const ConnectionInfo &info) {
+  auto stream_id = message->GetAttribute(STREAM_ID_ATTRIBUTE).value_or("");
+
+  std::unique_lock lock(m_streams_mutex);
+  auto key = std::make_pair(info.endpoint_id, stream_id);
+  if (!m_readers.contains(key)) {
+    return;
+  }
+
+  auto reader = m_readers.at(key);
+  m_readers.erase(key);
+  lock.unlock();
+
+  reader->OnFinished();
+  LOG_DEBUG("stream " << stream_id << " from node " << info.endpoint_id
+                      << " has been finished")
+}
+
+void MessageStreamMultiplexer::ProcessAbortMessage(
+    const SharedMessage &message, const ConnectionInfo &info) {
+  auto stream_id = message->GetAttribute(STREAM_ID_ATTRIBUTE).value_or("");
+  auto reason =
+      message->GetAttribute(STREAM_REASON_ATTRIBUTE).value_or("unknown");
+
+  // aborts can be sent by both parties of a stream
+  if (auto maybe_writer = GetWriter(info.endpoint_id, stream_id)) {
+    maybe_writer.value()->OnAborted(reason);
+    std::unique_lock lock(m_streams_mutex);
+    m_writers.erase(stream_id);
+    return;
+  }
+
+  std::unique_lock lock(m_streams_mutex);
+  auto key = std::make_pair(info.endpoint_id, stream_id);
+  if (m_readers.contains(key)) {
+    auto reader = m_readers.at(key);
+    m_readers.erase(key);
+    lock.unlock();
+    reader->OnAborted(reason);
+  }
+}
+
+std::optional<SharedMessageStreamReader>
+MessageStreamMultiplexer::GetReader(const std::string &node_id,
+                                    const std::string &stream_id) {
+  std::unique_lock lock(m_streams_mutex);
+  auto key = std::make_pair(node_id, stream_id);
+  if (m_readers.contains(key)) {
+    return m_readers.at(key);
+  }
+  return {};
+}
+
+std::optional<SharedMessageStreamWriter>
+MessageStreamMultiplexer::GetWriter(const std::string &node_id,
+                                    const std::string &stream_id) {
+  std::unique_lock lock(m_streams_mutex);
+  if (!m_writers.contains(stream_id)) {
+    return {};
+  }
+
+  auto writer = m_writers.at(stream_id).lock();
+  if (!writer) {
+    m_writers.erase(stream_id);
+    return {};
+  }
+
+  // stream ids must not be guessed by other nodes
+  if (writer->GetNodeId() != node_id) {
+    LOG_WARN("node " << node_id << " tried to control stream " << stream_id
+                     << " of another node")
+    return {};
+  }
+
+  return writer;
+}
+
+void MessageStreamMultiplexer::SendCredit(const std::string &node_id,
+                                          const std::string &stream_id,
+                                          size_t credit) {
+  SharedMessage message = std::make_shared<Message>(STREAM_CREDIT_MESSAGE_TYPE);
+  message->SetAttribute(STREAM_ID_ATTRIBUTE, stream_id);
+  message->SetAttribute(STREAM_CREDIT_ATTRIBUTE, std::to_string(credit));
+  message->SetImmediateFlush(true);
+
+  try {
+    m_send(node_id, message);
+  } catch (const std::exception &exception) {
+    LOG_WARN("cannot grant credit for stream " << stream_id << " to node "
+                                               << node_id << ": "
+                                               << exception.what())
+  }
+}
+
+void MessageStreamMultiplexer::SendAbort(const std::string &node_id,
+                                         const std::string &stream_id,
+                                         const std::string &reason) {
+  SharedMessage message = std::make_shared<Message>(STREAM_ABORT_MESSAGE_TYPE);
+  message->SetAttribute(STREAM_ID_ATTRIBUTE, stream_id);
+  message->SetAttribute(STREAM_REASON_ATTRIBUTE, reason);
+  message->SetImmediateFlush(true);
+
+  try {
+    m_send(node_id, message);
+  } catch (const std::exception &exception) {
+    LOG_DEBUG("cannot tell node " << node_id << " to abort stream "
+                                  << stream_id << ": " << exception.what())
+  }
+}
+
+void MessageStreamMultiplexer::OnConnectionClosed(const std::string &node_id) {
+  std::list<SharedMessageStreamReader> readers;
+  std::list<SharedMessageStreamWriter> writers;
+
+  std::unique_lock lock(m_streams_mutex);
+  for (auto it = m_readers.begin(); it != m_readers.end();) {
+    if (it->first.first == node_id) {
+      readers.push_back(it->second);
+      it = m_readers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (auto it = m_writers.begin(); it != m_writers.end();) {
+    auto writer = it->second.lock();
+    if (!writer) {
+      it = m_writers.erase(it);
+    } else if (writer->GetNodeId() == node_id) {
+      writers.push_back(writer);
+      it = m_writers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  lock.unlock();
+
+  for (auto &reader : readers) {
+    reader->OnAborted("connection has been closed");
+  }
+
+  for (auto &writer : writers) {
+    writer->OnAborted("connection has been closed");
+  }
+}
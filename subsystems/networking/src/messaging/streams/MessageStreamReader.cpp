@@ -0,0 +1,150 @@
+#include "networking/messaging/streams/MessageStreamReader.h"
+#include "logging/LogManager.h"
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::streams;
+
+MessageStreamReader::MessageStreamReader(
+    std::string stream_id, std::string stream_type, size_t window,
+    std::function<void(size_t)> grant_credit,
+    std::function<void(const std::string &)> cancel)
+    : m_stream_id{std::move(stream_id)}, m_stream_type{std::move(stream_type)},
+      m_window{window}, m_grant_credit{std::move(grant_credit)},
+      m_cancel{std::move(cancel)} {}
+
+size_t MessageStreamReader::ConsumeFragment(const MessageAttribute &fragment) {
+  m_unacknowledged_bytes += fragment.GetSize();
+
+  // grant credit in larger steps, so the sender is not flooded with messages
+  if (m_unacknowledged_bytes >= m_window / 2) {
+    size_t credit = m_unacknowledged_bytes;
+    m_unacknowledged_bytes = 0;
+    return credit;
+  }
+
+  return 0;
+}
+
+std::future<std::optional<MessageAttribute>> MessageStreamReader::Read() {
+  std::promise<std::optional<MessageAttribute>> promise;
+  auto future = promise.get_future();
+
+  std::unique_lock lock(m_mutex);
+  if (!m_fragments.empty()) {
+    auto fragment = std::move(m_fragments.front());
+    m_fragments.pop_front();
+    m_buffered_bytes -= fragment.GetSize();
+
+    size_t credit = ConsumeFragment(fragment);
+    lock.unlock();
+
+    promise.set_value(std::move(fragment));
+    if (credit > 0) {
+      m_grant_credit(credit);
+    }
+  } else if (m_error.has_value()) {
+    auto exception = BUILD_EXCEPTION(MessageStreamAbortedException,
+                                     "stream " << m_stream_id
+                                               << " has been aborted: "
+                                               << m_error.value());
+    promise.set_exception(std::make_exception_ptr(exception));
+  } else if (m_finished) {
+    promise.set_value(std::nullopt);
+  } else {
+    m_pending_reads.push_back(std::move(promise));
+  }
+
+  return future;
+}
+
+void MessageStreamReader::Cancel(const std::string &reason) {
+  std::unique_lock lock(m_mutex);
+  if (m_finished || m_error.has_value()) {
+    return;
+  }
+  lock.unlock();
+
+  OnAborted(reason);
+  m_cancel(reason);
+}
+
+bool MessageStreamReader::OnFragmentReceived(MessageAttribute fragment,
+                                             size_t sequence) {
+  std::unique_lock lock(m_mutex);
+  if (m_finished || m_error.has_value()) {
+    return true;
+  }
+
+  if (sequence != m_next_sequence) {
+    lock.unlock();
+    LOG_WARN("fragment " << sequence << " of stream " << m_stream_id
+                         << " is out of order (expected " << m_next_sequence
+                         << ")")
+    OnAborted("fragments have been lost");
+    return false;
+  }
+
+  if (m_buffered_bytes + fragment.GetSize() > m_window) {
+    lock.unlock();
+    LOG_WARN("sender of stream " << m_stream_id
+                                 << " exceeded its credit of " << m_window
+                                 << " bytes")
+    OnAborted("sender exceeded its credit");
+    return false;
+  }
+
+  m_next_sequence++;
+
+  // deliver fragments directly to waiting reads
+  if (!m_pending_reads.empty()) {
+    auto promise = std::move(m_pending_reads.front());
+    m_pending_reads.pop_front();
+
+    size_t credit = ConsumeFragment(fragment);
+    lock.unlock();
+
+    promise.set_value(std::move(fragment));
+    if (credit > 0) {
+      m_grant_credit(credit);
+    }
+    return true;
+  }
+
+  m_buffered_bytes += fragment.GetSize();
+  m_fragments.push_back(std::move(fragment));
+  return true;
+}
+
+void MessageStreamReader::OnFinished() {
+  std::unique_lock lock(m_mutex);
+  m_finished = true;
+  auto pending_reads = std::move(m_pending_reads);
+  m_pending_reads.clear();
+  lock.unlock();
+
+  // reads can only be pending if all fragments have been read
+  for (auto &promise : pending_reads) {
+    promise.set_value(std::nullopt);
+  }
+}
+
+void MessageStreamReader::OnAborted(const std::string &reason) {
+  std::unique_lock lock(m_mutex);
+  if (m_finished || m_error.has_value()) {
+    return;
+  }
+
+  m_error = reason;
+  m_fragments.clear();
+  m_buffered_bytes = 0;
+  auto pending_reads = std::move(m_pending_reads);
+  m_pending_reads.clear();
+  lock.unlock();
+
+  for (auto &promise : pending_reads) {
+    auto exception = BUILD_EXCEPTION(
+        MessageStreamAbortedException,
+        "stream " << m_stream_id << " has been aborted: " << reason);
+    promise.set_exception(std::make_exception_ptr(exception));
+  }
+}
@@ -0,0 +1,186 @@
+#include "networking/messaging/streams/MessageStreamWriter.h"
+#include "logging/LogManager.h"
+#include "networking/messaging/streams/MessageStreamProtocol.h"
+
+using namespace hive::networking::messaging;
+using namespace hive::networking::messaging::streams;
+
+MessageStreamWriter::MessageStreamWriter(
+    std::string stream_id, std::string node_id, size_t fragment_size,
+    std::function<std::future<void>(SharedMessage)> send)
+    : m_stream_id{std::move(stream_id)}, m_node_id{std::move(node_id)},
+      m_fragment_size{fragment_size}, m_send{std::move(send)} {
+  DEBUG_ASSERT(m_fragment_size > 0, "fragments must not be empty")
+}
+
+MessageStreamWriter::~MessageStreamWriter() {
+  // data that has not been sent yet would never arrive otherwise
+  if (!IsClosed()) {
+    Abort("writer has been destroyed before ending the stream");
+  }
+}
+
+std::future<void> MessageStreamWriter::Write(std::string data) {
+  PendingWrite write;
+  write.data = std::make_shared<const std::string>(std::move(data));
+  auto future = write.promise.get_future();
+
+  std::unique_lock lock(m_mutex);
+  if (m_error.has_value() || m_ended) {
+    auto exception = BUILD_EXCEPTION(
+        MessageStreamAbortedException,
+        "cannot write to stream " << m_stream_id << ", because it has been "
+                                  << (m_ended ? "ended" : "aborted"));
+    write.promise.set_exception(std::make_exception_ptr(exception));
+    return future;
+  }
+
+  m_pending_writes.push_back(std::move(write));
+  SendPendingFragments();
+  return future;
+}
+
+std::future<void> MessageStreamWriter::End() {
+  PendingWrite end;
+  end.is_end = true;
+  auto future = end.promise.get_future();
+
+  std::unique_lock lock(m_mutex);
+  if (m_error.has_value() || m_ended) {
+    auto exception = BUILD_EXCEPTION(MessageStreamAbortedException,
+                                     "stream " << m_stream_id
+                                               << " has already been closed");
+    end.promise.set_exception(std::make_exception_ptr(exception));
+    return future;
+  }
+
+  m_ended = true;
+  m_pending_writes.push_back(std::move(end));
+  SendPendingFragments();
+  return future;
+}
+
+void MessageStreamWriter::Abort(const std::string &reason) {
+  std::unique_lock lock(m_mutex);
+  if (m_error.has_value()) {
+    return;
+  }
+
+  m_error = reason;
+  FailPendingWrites();
+  lock.unlock();
+
+  SharedMessage abort_message =
+      std::make_shared<Message>(STREAM_ABORT_MESSAGE_TYPE);
+  abort_message->SetAttribute(STREAM_ID_ATTRIBUTE, m_stream_id);
+  abort_message->SetAttribute(STREAM_REASON_ATTRIBUTE, reason);
+
+  try {
+    m_send(abort_message);
+  } catch (const std::exception &exception) {
+    LOG_DEBUG("cannot tell node " << m_node_id << " to abort stream "
+                                  << m_stream_id << ": " << exception.what())
+  }
+}
+
+void MessageStreamWriter::OnCreditGranted(size_t credit) {
+  std::unique_lock lock(m_mutex);
+  m_credit += credit;
+  SendPendingFragments();
+}
+
+void MessageStreamWriter::OnAborted(const std::string &reason) {
+  std::unique_lock lock(m_mutex);
+  if (m_error.has_value()) {
+    return;
+  }
+
+  LOG_WARN("stream " << m_stream_id << " to node " << m_node_id
+                     << " has been aborted: " << reason)
+  m_error = reason;
+  FailPendingWrites();
+}
+
+void MessageStreamWriter::FailPendingWrites() {
+  for (auto &write : m_pending_writes) {
+    auto exception = BUILD_EXCEPTION(MessageStreamAbortedException,
+                                     "stream " << m_stream_id
+                                               << " has been aborted: "
+                                               << m_error.value());
+    write.promise.set_exception(std::make_exception_ptr(exception));
+  }
+  m_pending_writes.clear();
+  m_sending.clear();
+}
+
+void MessageStreamWriter::SendPendingFragments() {
+
+  // fragments that could not be sent (e.g. full send queue) break the stream
+  for (auto it = m_sending.begin(); it != m_sending.end();) {
+    if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      ++it;
+      continue;
+    }
+
+    try {
+      it->get();
+      it = m_sending.erase(it);
+    } catch (const std::exception &exception) {
+      m_error = std::string("cannot send fragment: ") + exception.what();
+      FailPendingWrites();
+      return;
+    }
+  }
+
+  while (!m_error.has_value() && !m_pending_writes.empty()) {
+    auto &write = m_pending_writes.front();
+
+    SharedMessage message;
+    size_t length = 0;
+    if (write.is_end) {
+      message = std::make_shared<Message>(STREAM_END_MESSAGE_TYPE);
+      message->SetAttribute(STREAM_ID_ATTRIBUTE, m_stream_id);
+    } else {
+      size_t remaining = write.data->size() - write.offset;
+      length = std::min({remaining, m_fragment_size, m_credit});
+
+      bool is_waiting_for_credit = length == 0 && remaining > 0;
+      if (is_waiting_for_credit) {
+        return;
+      }
+
+      // fragments slice the written data instead of copying it
+      if (length > 0) {
+        message = std::make_shared<Message>(STREAM_FRAGMENT_MESSAGE_TYPE);
+        message->SetAttribute(STREAM_ID_ATTRIBUTE, m_stream_id);
+        message->SetAttribute(STREAM_SEQUENCE_ATTRIBUTE,
+                              std::to_string(m_next_sequence));
+        message->SetAttribute(
+            STREAM_DATA_ATTRIBUTE,
+            MessageAttribute(write.data, write.offset, length));
+      }
+    }
+
+    if (message) {
+      try {
+        m_sending.push_back(m_send(message));
+      } catch (const std::exception &exception) {
+        m_error = std::string("cannot send fragment: ") + exception.what();
+        FailPendingWrites();
+        return;
+      }
+    }
+
+    if (!write.is_end) {
+      m_next_sequence += length > 0 ? 1 : 0;
+      m_credit -= length;
+      write.offset += length;
+      if (write.offset < write.data->size()) {
+        continue;
+      }
+    }
+
+    write.promise.set_value();
+    m_pending_writes.pop_front();
+  }
+}
@@ -0,0 +1,55 @@
+#include "networking/util/ExecutionContextPool.h"
+#include "common/assert/Assert.h"
+
+using namespace hive::networking::util;
+namespace asio = boost::asio;
+
+ExecutionContextPool::ExecutionContextPool(size_t thread_count,
+                                           bool context_per_thread)
+    : m_thread_count{std::max<size_t>(thread_count, 1)} {
+  size_t context_count = context_per_thread ? m_thread_count : 1;
+  for (size_t i = 0; i < context_count; i++) {
+    // a context run by a single thread does not need to synchronize handlers
+    int concurrency_hint =
+        context_per_thread ? 1 : static_cast<int>(m_thread_count);
+    auto context = std::make_shared<asio::io_context>(concurrency_hint);
+    m_work_guards.push_back(asio::make_work_guard(*context));
+    m_contexts.push_back(std::move(context));
+  }
+}
+
+ExecutionContextPool::~ExecutionContextPool() { Stop(true); }
+
+void ExecutionContextPool::Start() {
+  DEBUG_ASSERT(m_threads.empty(), "execution context pool already started")
+  for (size_t i = 0; i < m_thread_count; i++) {
+    std::weak_ptr<asio::io_context> weak_context =
+        m_contexts[i % m_contexts.size()];
+    m_threads.emplace_back([weak_context]() {
+      if (auto context = weak_context.lock()) {
+        context->run();
+      }
+    });
+  }
+}
+
+void ExecutionContextPool::Stop(bool abort) {
+  for (auto &work_guard : m_work_guards) {
+    work_guard.reset();
+  }
+
+  if (abort) {
+    for (auto &context : m_contexts) {
+      context->stop();
+    }
+  }
+
+  for (auto &thread : m_threads) {
+    DEBUG_ASSERT(thread.get_id() != std::this_thread::get_id(),
+                 "execution thread should not join itself")
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  m_threads.clear();
+}
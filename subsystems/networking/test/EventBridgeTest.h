@@ -0,0 +1,111 @@
+#pragma once
+
+#include "MessagingEndpointTest.h"
+#include "events/listener/impl/FunctionalEventListener.h"
+#include "networking/bridge/EventBatchSerializer.h"
+#include "networking/bridge/EventBridge.h"
+#include <gtest/gtest.h>
+
+using namespace hive::networking::bridge;
+
+inline void InstallEventBridge(Node &node, const std::string &topics = "") {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.bridge.topics", topics);
+  auto bridge = common::memory::Owner<EventBridge>(
+      node.subsystems.CreateReference(), config);
+  node.subsystems->AddOrReplaceSubsystem<EventBridge>(std::move(bridge));
+}
+
+TEST(EventBridge, serialize_event_batch) {
+  auto event = std::make_shared<Event>("render.frame.done");
+  event->SetPayload<std::string>("name", "some frame");
+  event->SetPayload<int>("width", -1920);
+  event->SetPayload<size_t>("frame", 42);
+  event->SetPayload<double>("duration", 0.016);
+  event->SetPayload<bool>("complete", true);
+
+  auto other_event = std::make_shared<Event>("render.frame.started");
+
+  auto data = EventBatchSerializer::Serialize({event, other_event});
+  auto events = EventBatchSerializer::Deserialize(data);
+
+  // counts and lengths are little-endian on every platform
+  ASSERT_EQ(data.substr(0, 4), std::string("\x02\x00\x00\x00", 4));
+
+  ASSERT_EQ(events.size(), 2);
+  ASSERT_EQ(events[0]->GetTopic(), event->GetTopic());
+  ASSERT_EQ(events[0]->GetId(), event->GetId());
+  ASSERT_EQ(events[0]->GetPayload<std::string>("name"), "some frame");
+  ASSERT_EQ(events[0]->GetPayload<int>("width"), -1920);
+  ASSERT_EQ(events[0]->GetPayload<size_t>("frame"), 42);
+  ASSERT_EQ(events[0]->GetPayload<double>("duration"), 0.016);
+  ASSERT_EQ(events[0]->GetPayload<bool>("complete"), true);
+  ASSERT_EQ(events[1]->GetTopic(), other_event->GetTopic());
+  ASSERT_TRUE(events[1]->GetAllPayloads().empty());
+
+  auto truncated_data = data.substr(0, data.size() / 2);
+  ASSERT_THROW(EventBatchSerializer::Deserialize(truncated_data),
+               EventBatchInvalidException);
+}
+
+TEST(EventBridge, forward_events_to_peers) {
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004);
+  InstallEventBridge(node1);
+  InstallEventBridge(node2, "bridge.**");
+
+  auto result = node1.networking_manager.Borrow()
+                    ->GetDefaultMessageEndpoint()
+                    .value()
+                    ->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  // both nodes forward the same topics, so loops would be possible
+  node1.subsystems->RequireSubsystem<EventBridge>()->Forward("bridge.test.*");
+  auto node2_bridge = node2.subsystems->RequireSubsystem<EventBridge>();
+  ASSERT_TRUE(node2_bridge->IsForwarding("bridge.**"));
+
+  std::atomic<int> node1_counter{0};
+  std::atomic<int> node2_counter{0};
+  auto node1_listener = std::make_shared<FunctionalEventListener>(
+      [&node1_counter](const SharedEvent &) { node1_counter++; });
+  auto node2_listener = std::make_shared<FunctionalEventListener>(
+      [&node2_counter](const SharedEvent &event) {
+        if (EventBridge::IsBridged(event) &&
+            event->GetPayload<int>("index").has_value()) {
+          node2_counter++;
+        }
+      });
+
+  node1.subsystems->RequireSubsystem<IEventBroker>()->RegisterListener(
+      node1_listener, "bridge.test.*");
+  node2.subsystems->RequireSubsystem<IEventBroker>()->RegisterListener(
+      node2_listener, "bridge.test.*");
+
+  auto node1_broker = node1.subsystems->RequireSubsystem<IEventBroker>();
+  for (int i = 0; i < 10; i++) {
+    auto event = std::make_shared<Event>("bridge.test.event");
+    event->SetPayload<int>("index", i);
+    node1_broker->FireEvent(event);
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &node2_counter] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return node2_counter == 10;
+      },
+      10s);
+
+  // give echoed events some time to arrive (which they should not)
+  for (int i = 0; i < 5; i++) {
+    node1.job_manager.Borrow()->InvokeCycleAndWait();
+    node2.job_manager.Borrow()->InvokeCycleAndWait();
+    std::this_thread::sleep_for(10ms);
+  }
+
+  ASSERT_EQ(node1_counter, 10);
+  ASSERT_EQ(node2_counter, 10);
+}
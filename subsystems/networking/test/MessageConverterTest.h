@@ -1,7 +1,10 @@
 #pragma once
 
+#include "networking/messaging/BinaryMessageConverter.h"
 #include "networking/messaging/MessageConverter.h"
+#include "networking/messaging/PayloadCompressor.h"
 #include <gtest/gtest.h>
+#include <limits>
 #include <memory>
 
 using namespace hive;
@@ -35,3 +38,180 @@ TEST(WebSockets, message_converter_invalid) {
   ASSERT_THROW(converter.FromMultipartFormData(invalid_payload),
                MessagePayloadInvalidException);
 }
+
+TEST(WebSockets, binary_converter_serializing) {
+  SharedMessage message = std::make_shared<Message>("some-type");
+  message->SetAttribute("attr1", "value1");
+  message->SetAttribute("empty", "");
+  message->SetAttribute("blob", std::string("\0\r\n--boundary\0", 14));
+
+  std::string frame = BinaryMessageConverter::ToBinary(message);
+  ASSERT_TRUE(BinaryMessageConverter::IsBinary(frame));
+
+  SharedMessage same_message = BinaryMessageConverter::FromBinary(frame);
+  ASSERT_TRUE(message->EqualsTo(same_message));
+  ASSERT_EQ(same_message->GetAttribute("blob").value(),
+            message->GetAttribute("blob").value());
+}
+
+TEST(WebSockets, binary_converter_invalid) {
+  SharedMessage message = std::make_shared<Message>("some-type");
+  message->SetAttribute("attr1", "value1");
+
+  std::string frame = BinaryMessageConverter::ToBinary(message);
+
+  // now half of the frame gets lost
+  auto truncated_frame = frame.substr(0, frame.size() / 2);
+  ASSERT_THROW(BinaryMessageConverter::FromBinary(truncated_frame),
+               BinaryFrameInvalidException);
+  ASSERT_THROW(MessageConverter::FromWireFormat(truncated_frame),
+               MessagePayloadInvalidException);
+}
+
+TEST(WebSockets, binary_converter_overflow) {
+  // the attribute count of a frame has only 16 bits
+  SharedMessage message = std::make_shared<Message>("some-type");
+  for (size_t i = 0; i <= std::numeric_limits<uint16_t>::max(); i++) {
+    message->SetAttribute("attr" + std::to_string(i), "");
+  }
+
+  ASSERT_THROW(BinaryMessageConverter::ToBinary(message),
+               BinaryFrameOverflowException);
+}
+
+TEST(WebSockets, wire_format_detection) {
+  SharedMessage message = std::make_shared<Message>("some-type");
+  message->SetAttribute("attr1", "value1");
+
+  for (auto format : {WireFormat::MULTIPART_FORMDATA, WireFormat::BINARY}) {
+    std::string payload = MessageConverter::ToWireFormat(message, format);
+    ASSERT_EQ(BinaryMessageConverter::IsBinary(payload),
+              format == WireFormat::BINARY);
+    ASSERT_TRUE(message->EqualsTo(MessageConverter::FromWireFormat(payload)));
+  }
+}
+
+TEST(WebSockets, binary_converter_zero_copy) {
+  SharedMessage message = std::make_shared<Message>("some-type");
+  message->SetAttribute("small", "value");
+  message->SetAttribute("large", std::string(1024 * 1024, 'x'));
+
+  SharedPayload payload = std::make_shared<const std::string>(
+      MessageConverter::ToWireFormat(message, WireFormat::BINARY));
+  SharedMessage received_message = MessageConverter::FromWireFormat(payload);
+  ASSERT_TRUE(message->EqualsTo(received_message));
+
+  // attributes must reference the received payload instead of copying it
+  auto attribute = received_message->GetSharedAttribute("large").value();
+  ASSERT_EQ(attribute.GetPayload(), payload);
+
+  auto view = received_message->GetAttributeView("large").value();
+  ASSERT_EQ(view.size(), 1024 * 1024);
+  ASSERT_GE(view.data(), payload->data());
+  ASSERT_LE(view.data() + view.size(), payload->data() + payload->size());
+
+  // attributes keep the payload alive, even if the message is gone
+  received_message.reset();
+  payload.reset();
+  ASSERT_EQ(attribute.GetView(), std::string(1024 * 1024, 'x'));
+}
+
+TEST(WebSockets, binary_converter_batch) {
+  std::vector<SharedMessage> messages;
+  std::vector<SharedPayload> frames;
+  for (int i = 0; i < 3; i++) {
+    SharedMessage message = std::make_shared<Message>("some-type");
+    message->SetAttribute("index", std::to_string(i));
+    messages.push_back(message);
+    frames.push_back(
+        std::make_shared<std::string>(BinaryMessageConverter::ToBinary(message)));
+  }
+
+  SharedPayload batch = std::make_shared<const std::string>(
+      BinaryMessageConverter::ToBinaryBatch(frames));
+  ASSERT_TRUE(BinaryMessageConverter::IsBinaryBatch(*batch));
+  ASSERT_FALSE(BinaryMessageConverter::IsBinary(*batch));
+
+  auto received_messages = MessageConverter::FromWireFormatBatch(batch);
+  ASSERT_EQ(received_messages.size(), messages.size());
+  for (size_t i = 0; i < messages.size(); i++) {
+    ASSERT_TRUE(messages[i]->EqualsTo(received_messages[i]));
+    ASSERT_EQ(received_messages[i]->GetSharedAttribute("index")->GetPayload(),
+              batch);
+  }
+
+  // single messages are unpacked as well
+  SharedPayload single = std::make_shared<const std::string>(*frames[0]);
+  ASSERT_EQ(MessageConverter::FromWireFormatBatch(single).size(), 1);
+
+  SharedPayload truncated_batch =
+      std::make_shared<const std::string>(batch->substr(0, batch->size() - 5));
+  ASSERT_THROW(MessageConverter::FromWireFormatBatch(truncated_batch),
+               MessagePayloadInvalidException);
+}
+
+TEST(WebSockets, payload_compression) {
+  PayloadCompressor compressor(1024, 1);
+
+  // small payloads are not worth compressing
+  ASSERT_FALSE(compressor.Compress(std::string(100, 'x')).has_value());
+
+  std::string payload;
+  for (int i = 0; i < 1000; i++) {
+    payload += "attribute-" + std::to_string(i % 10) + "=some-value;";
+  }
+
+  auto compressed = compressor.Compress(payload);
+  ASSERT_TRUE(compressed.has_value());
+  ASSERT_TRUE(PayloadCompressor::IsCompressed(compressed.value()));
+  ASSERT_LT(compressed->size(), payload.size());
+  ASSERT_EQ(compressor.Decompress(compressed.value()), payload);
+
+  // streams are reused, so following payloads must be compressed as well
+  auto compressed_again = compressor.Compress(payload);
+  ASSERT_TRUE(compressed_again.has_value());
+  ASSERT_EQ(compressor.Decompress(compressed_again.value()), payload);
+
+  auto statistics = compressor.GetStatistics();
+  ASSERT_EQ(statistics.compressed_payloads, 2);
+  ASSERT_EQ(statistics.decompressed_payloads, 2);
+  ASSERT_GT(statistics.GetCompressionRatio(), 1.0);
+
+  // incompressible payloads are sent as they are
+  std::string random_payload(64 * 1024, '\0');
+  uint32_t state = 42;
+  for (auto &byte : random_payload) {
+    state = state * 1664525 + 1013904223;
+    byte = static_cast<char>(state >> 24);
+  }
+  ASSERT_FALSE(compressor.Compress(random_payload).has_value());
+
+  std::string corrupt_payload = compressed.value();
+  corrupt_payload.resize(corrupt_payload.size() / 2);
+  ASSERT_THROW(compressor.Decompress(corrupt_payload),
+               PayloadCompressionException);
+  ASSERT_THROW(compressor.Decompress(payload), PayloadCompressionException);
+}
+
+TEST(WebSockets, payload_compression_round_trip) {
+  PayloadCompressor compressor(0, 1);
+
+  // the deflate stream ends at different positions relative to the input
+  for (size_t size = 1; size < 64 * 1024; size = size * 3 + 7) {
+    for (int kind = 0; kind < 3; kind++) {
+      std::string payload(size, '\0');
+      uint32_t state = static_cast<uint32_t>(size);
+      for (size_t i = 0; i < size; i++) {
+        state = state * 1664525 + 1013904223;
+        payload[i] = kind == 0   ? 'x'
+                     : kind == 1 ? static_cast<char>('a' + i % 7)
+                                 : static_cast<char>('a' + (state >> 28));
+      }
+
+      if (auto compressed = compressor.Compress(payload)) {
+        ASSERT_EQ(compressor.Decompress(compressed.value()), payload)
+            << "payload of " << size << " bytes (kind " << kind << ")";
+      }
+    }
+  }
+}
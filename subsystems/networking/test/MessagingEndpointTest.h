@@ -5,7 +5,14 @@
 #include "events/broker/impl/JobBasedEventBroker.h"
 #include "networking/NetworkingManager.h"
 #include "networking/messaging/ConnectionInfo.h"
-
+#include "networking/messaging/impl/websockets/boost/BoostWebSocketConnection.h"
+#include "networking/messaging/impl/sockets/TcpSocketEndpoint.h"
+#include "networking/messaging/impl/sockets/UnixSocketEndpoint.h"
+#include "networking/messaging/impl/websockets/boost/BoostWebSocketEndpoint.h"
+#include <boost/asio/local/stream_protocol.hpp>
+#include <filesystem>
+
+using namespace hive;
 using namespace hive::networking;
 using namespace hive::networking::messaging;
 using namespace hive::jobsystem;
@@ -22,9 +29,10 @@ struct Node {
   size_t port;
 };
 
-inline Node SetupWebSocketPeer(size_t port) {
+inline Node SetupWebSocketPeer(
+    size_t port, common::config::SharedConfiguration config =
+                     std::make_shared<common::config::Configuration>()) {
   // configure subsystems
-  auto config = std::make_shared<common::config::Configuration>();
   config->Set("net.port", port);
 
   // setup separate subsystems for this peer (but reuse job-system)
@@ -75,6 +83,18 @@ public:
   }
 };
 
+class TestStreamConsumer : public streams::IMessageStreamConsumer {
+public:
+  mutable jobsystem::mutex readers_mutex;
+  std::vector<streams::SharedMessageStreamReader> readers;
+  std::string GetStreamType() const override { return "test-stream"; }
+  void ProcessReceivedStream(streams::SharedMessageStreamReader reader,
+                             ConnectionInfo connection_info) override {
+    std::unique_lock lock(readers_mutex);
+    readers.push_back(std::move(reader));
+  }
+};
+
 inline void
 sendMessageToNode(const SharedMessage &message,
                   const common::memory::Borrower<IMessageEndpoint> &peer,
@@ -265,6 +285,51 @@ TEST(WebSockets, message_sending_1_to_n) {
       10s);
 }
 
+TEST(WebSockets, context_per_thread) {
+  // each thread runs its own io_context with its own acceptor
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.threads", 4);
+  config->Set("net.threads.context-per-thread", true);
+  config->Set("net.server.reuse-port", true);
+  Node node1 = SetupWebSocketPeer(9003, config);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  node1.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+
+  std::vector<Node> peers;
+  for (size_t i = 9005; i < 9013; i++) {
+    auto peer_config = std::make_shared<common::config::Configuration>();
+    peer_config->Set("net.threads", 2);
+    peer_config->Set("net.threads.context-per-thread", true);
+    Node peer = SetupWebSocketPeer(i, peer_config);
+
+    auto result = peer.networking_manager.Borrow()
+                      ->GetDefaultMessageEndpoint()
+                      .value()
+                      ->EstablishConnectionTo("ws://127.0.0.1:9003");
+    result.wait();
+    ASSERT_NO_THROW(result.get());
+    waitUntilConnectionCompleted(node1, peer);
+    peers.push_back(std::move(peer));
+  }
+
+  for (auto &peer : peers) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    sendMessageToNode(
+        message,
+        peer.networking_manager.Borrow()->GetDefaultMessageEndpoint().value(),
+        node1.uuid);
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &test_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 8;
+      },
+      10s);
+}
+
 TEST(WebSockets, message_broadcast) {
   auto config = std::make_shared<common::config::Configuration>();
 
@@ -322,3 +387,817 @@ TEST(WebSockets, message_broadcast) {
       },
       10s);
 }
+
+TEST(WebSockets, message_broadcast_result) {
+  Node broadcasting_peer = SetupWebSocketPeer(9003);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+
+  // recipients using different wire formats get differently converted copies
+  std::vector<Node> peers;
+  for (size_t i = 9005; i < 9009; i++) {
+    auto config = std::make_shared<common::config::Configuration>();
+    if (i % 2 == 0) {
+      config->Set("net.wire-format", std::string("multipart"));
+    }
+    Node recipient_node = SetupWebSocketPeer(i, config);
+
+    auto result = recipient_node.networking_manager.Borrow()
+                      ->GetDefaultMessageEndpoint()
+                      .value()
+                      ->EstablishConnectionTo("127.0.0.1:9003");
+    result.wait();
+    ASSERT_NO_THROW(result.get());
+
+    waitUntilConnectionCompleted(broadcasting_peer, recipient_node);
+
+    recipient_node.networking_manager.Borrow()->AddMessageConsumer(
+        test_consumer);
+    peers.push_back(std::move(recipient_node));
+  }
+
+  SharedMessage message = std::make_shared<Message>("test-type");
+  message->SetAttribute("data", std::string(64 * 1024, 'x'));
+
+  auto future = broadcasting_peer.networking_manager.Borrow()
+                    ->GetDefaultMessageEndpoint()
+                    .value()
+                    ->Broadcast(message);
+  ASSERT_EQ(future.wait_for(10s), std::future_status::ready);
+
+  auto result = future.get();
+  ASSERT_EQ(result.delivered.size(), 4);
+  ASSERT_TRUE(result.failed.empty());
+  for (auto &peer : peers) {
+    ASSERT_NE(std::find(result.delivered.begin(), result.delivered.end(),
+                        peer.uuid),
+              result.delivered.end());
+  }
+
+  TryAssertUntilTimeout(
+      [&peers, &test_consumer] {
+        for (auto &peer : peers) {
+          peer.job_manager.Borrow()->InvokeCycleAndWait();
+        }
+        return test_consumer->counter == 4;
+      },
+      10s);
+}
+
+TEST(WebSockets, wire_format_negotiation) {
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004);
+
+  auto multipart_config = std::make_shared<common::config::Configuration>();
+  multipart_config->Set("net.wire-format", std::string("multipart"));
+  Node node3 = SetupWebSocketPeer(9005, multipart_config);
+
+  std::shared_ptr<TestConsumer> test_consumer_2 =
+      std::make_shared<TestConsumer>();
+  std::shared_ptr<TestConsumer> test_consumer_3 =
+      std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer_2);
+  node3.networking_manager.Borrow()->AddMessageConsumer(test_consumer_3);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+
+  // both nodes prefer binary frames
+  auto binary_result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  binary_result.wait();
+  ConnectionInfo binary_connection;
+  ASSERT_NO_THROW(binary_connection = binary_result.get());
+  ASSERT_EQ(binary_connection.wire_format, WireFormat::BINARY);
+
+  // the remote node only accepts multipart form-data
+  auto multipart_result =
+      endpoint1->EstablishConnectionTo("ws://127.0.0.1:9005");
+  multipart_result.wait();
+  ConnectionInfo multipart_connection;
+  ASSERT_NO_THROW(multipart_connection = multipart_result.get());
+  ASSERT_EQ(multipart_connection.wire_format, WireFormat::MULTIPART_FORMDATA);
+
+  waitUntilConnectionCompleted(node1, node2);
+  waitUntilConnectionCompleted(node1, node3);
+
+  SharedMessage message = std::make_shared<Message>("test-type");
+  message->SetAttribute("blob", std::string("\0binary\r\n--data", 15));
+
+  sendMessageToNode(message, endpoint1, node2.uuid);
+  sendMessageToNode(message, endpoint1, node3.uuid);
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &node3, &test_consumer_2, &test_consumer_3] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        node3.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer_2->counter == 1 && test_consumer_3->counter == 1;
+      },
+      10s);
+}
+
+TEST(WebSockets, message_sending_queued) {
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  // senders do not wait for each other, messages are queued instead
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 100; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    futures.push_back(endpoint1->Send(node2.uuid, message));
+  }
+
+  for (auto &future : futures) {
+    future.wait();
+    ASSERT_NO_THROW(future.get());
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 100;
+      },
+      10s);
+}
+
+TEST(WebSockets, message_sending_backpressure) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.send-queue.max-bytes", 1);
+  Node node1 = SetupWebSocketPeer(9003, config);
+  Node node2 = SetupWebSocketPeer(9004);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  SharedMessage message = std::make_shared<Message>("test-type");
+  message->SetAttribute("blob", std::string(8 * 1024 * 1024, 'x'));
+
+  // the first message is always accepted, but the others exceed the limit
+  // while it is still being written
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 10; i++) {
+    futures.push_back(endpoint1->Send(node2.uuid, message));
+  }
+
+  size_t rejected = 0;
+  for (auto &future : futures) {
+    future.wait();
+    try {
+      future.get();
+    } catch (const websockets::SendQueueFullException &) {
+      rejected++;
+    }
+  }
+
+  ASSERT_GT(rejected, 0);
+  ASSERT_LT(rejected, futures.size());
+
+  // accepted messages must still arrive
+  size_t accepted = futures.size() - rejected;
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer, accepted] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == accepted;
+      },
+      10s);
+}
+
+TEST(WebSockets, message_sending_batched) {
+  // messages are held back up to a long time for batching
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.send-batch.max-bytes", 64 * 1024);
+  config->Set("net.send-batch.window-ms", 60000);
+  Node node1 = SetupWebSocketPeer(9003, config);
+  Node node2 = SetupWebSocketPeer(9004);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 20; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    futures.push_back(endpoint1->Send(node2.uuid, message));
+  }
+
+  // the batch window has not elapsed yet, so nothing has been sent
+  std::this_thread::sleep_for(100ms);
+  node2.job_manager.Borrow()->InvokeCycleAndWait();
+  ASSERT_EQ(test_consumer->counter, 0);
+
+  // a latency-critical message flushes the whole batch
+  SharedMessage urgent_message = std::make_shared<Message>("test-type");
+  urgent_message->SetImmediateFlush(true);
+  futures.push_back(endpoint1->Send(node2.uuid, urgent_message));
+
+  for (auto &future : futures) {
+    future.wait();
+    ASSERT_NO_THROW(future.get());
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 21;
+      },
+      10s);
+}
+
+TEST(WebSockets, payload_compression_negotiation) {
+  auto compressed_config1 = std::make_shared<common::config::Configuration>();
+  compressed_config1->Set("net.compression", std::string("deflate"));
+  Node node1 = SetupWebSocketPeer(9003, compressed_config1);
+
+  auto compressed_config2 = std::make_shared<common::config::Configuration>();
+  compressed_config2->Set("net.compression", std::string("deflate"));
+  Node node2 = SetupWebSocketPeer(9004, compressed_config2);
+
+  // compression is disabled by default
+  Node node3 = SetupWebSocketPeer(9005);
+
+  std::shared_ptr<TestConsumer> test_consumer_2 =
+      std::make_shared<TestConsumer>();
+  std::shared_ptr<TestConsumer> test_consumer_3 =
+      std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer_2);
+  node3.networking_manager.Borrow()->AddMessageConsumer(test_consumer_3);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+
+  auto compressed_result =
+      endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  compressed_result.wait();
+  ConnectionInfo compressed_connection;
+  ASSERT_NO_THROW(compressed_connection = compressed_result.get());
+  ASSERT_EQ(compressed_connection.compression, PayloadCompression::DEFLATE);
+
+  // the remote node does not want its payloads to be compressed
+  auto uncompressed_result =
+      endpoint1->EstablishConnectionTo("ws://127.0.0.1:9005");
+  uncompressed_result.wait();
+  ConnectionInfo uncompressed_connection;
+  ASSERT_NO_THROW(uncompressed_connection = uncompressed_result.get());
+  ASSERT_EQ(uncompressed_connection.compression,
+            PayloadCompression::NO_COMPRESSION);
+
+  waitUntilConnectionCompleted(node1, node2);
+  waitUntilConnectionCompleted(node1, node3);
+
+  SharedMessage message = std::make_shared<Message>("test-type");
+  message->SetAttribute("blob", std::string(1024 * 1024, 'x'));
+
+  sendMessageToNode(message, endpoint1, node2.uuid);
+  sendMessageToNode(message, endpoint1, node3.uuid);
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &node3, &test_consumer_2, &test_consumer_3] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        node3.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer_2->counter == 1 && test_consumer_3->counter == 1;
+      },
+      10s);
+
+  auto *websocket_endpoint1 =
+      dynamic_cast<websockets::BoostWebSocketEndpoint *>(&*endpoint1);
+  ASSERT_NE(websocket_endpoint1, nullptr);
+
+  auto compressed_statistics =
+      websocket_endpoint1->GetCompressionStatistics(node2.uuid);
+  ASSERT_TRUE(compressed_statistics.has_value());
+  ASSERT_EQ(compressed_statistics->compressed_payloads, 1);
+  ASSERT_GT(compressed_statistics->GetCompressionRatio(), 1.0);
+
+  auto uncompressed_statistics =
+      websocket_endpoint1->GetCompressionStatistics(node3.uuid);
+  ASSERT_TRUE(uncompressed_statistics.has_value());
+  ASSERT_EQ(uncompressed_statistics->compressed_payloads, 0);
+}
+
+TEST(WebSockets, message_streaming) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.stream.window-bytes", 256 * 1024);
+  config->Set("net.stream.fragment-bytes", 64 * 1024);
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004, config);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  std::shared_ptr<TestStreamConsumer> test_stream_consumer =
+      std::make_shared<TestStreamConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+  node2.networking_manager.Borrow()->AddMessageStreamConsumer(
+      test_stream_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  std::string payload;
+  for (int i = 0; i < 4 * 1024 * 1024; i++) {
+    payload += static_cast<char>('a' + i % 26);
+  }
+
+  auto writer = endpoint1->OpenStream(node2.uuid, "test-stream");
+  std::vector<std::future<void>> writes;
+  for (size_t offset = 0; offset < payload.size(); offset += 1024 * 1024) {
+    writes.push_back(writer->Write(payload.substr(offset, 1024 * 1024)));
+  }
+  auto end = writer->End();
+
+  TryAssertUntilTimeout(
+      [&node2, &test_stream_consumer] {
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        std::unique_lock lock(test_stream_consumer->readers_mutex);
+        return test_stream_consumer->readers.size() == 1;
+      },
+      10s);
+  auto reader = test_stream_consumer->readers.front();
+
+  // the receiver does not buffer more than its window while nothing is read
+  std::this_thread::sleep_for(200ms);
+  ASSERT_LE(reader->GetBufferedBytes(), 256 * 1024);
+  ASSERT_EQ(end.wait_for(0s), std::future_status::timeout);
+
+  // other messages are not blocked by the stream
+  SharedMessage message = std::make_shared<Message>("test-type");
+  sendMessageToNode(message, endpoint1, node2.uuid);
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 1;
+      },
+      10s);
+
+  std::string received_payload;
+  while (true) {
+    auto fragment_future = reader->Read();
+    ASSERT_EQ(fragment_future.wait_for(10s), std::future_status::ready);
+    auto fragment = fragment_future.get();
+    if (!fragment.has_value()) {
+      break;
+    }
+    ASSERT_LE(fragment->GetSize(), 64 * 1024);
+    received_payload += fragment->GetView();
+  }
+
+  ASSERT_EQ(received_payload, payload);
+  for (auto &write : writes) {
+    ASSERT_NO_THROW(write.get());
+  }
+  ASSERT_NO_THROW(end.get());
+}
+
+TEST(WebSockets, message_streaming_rejected) {
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  // there is no consumer for this type of stream on the remote node
+  auto writer = endpoint1->OpenStream(node2.uuid, "unknown-stream");
+  auto write = writer->Write(std::string(1024, 'x'));
+  ASSERT_EQ(write.wait_for(10s), std::future_status::ready);
+  ASSERT_THROW(write.get(), streams::MessageStreamAbortedException);
+  ASSERT_TRUE(writer->IsClosed());
+}
+
+TEST(WebSockets, connection_pool_striping) {
+  auto config1 = std::make_shared<common::config::Configuration>();
+  auto config2 = std::make_shared<common::config::Configuration>();
+  for (const auto &config : {config1, config2}) {
+    config->Set("net.connections-per-peer", 2);
+    config->Set("net.connections.control-lane", true);
+    config->Set("net.connections.control-bytes", 1024);
+  }
+  config2->Set("net.stream.fragment-bytes", 64 * 1024);
+  Node node1 = SetupWebSocketPeer(9003, config1);
+  Node node2 = SetupWebSocketPeer(9004, config2);
+
+  auto test_consumer = std::make_shared<TestConsumer>();
+  auto test_stream_consumer = std::make_shared<TestStreamConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+  node2.networking_manager.Borrow()->AddMessageStreamConsumer(
+      test_stream_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto endpoint2 =
+      node2.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  ASSERT_NO_THROW(result.get());
+
+  // two data lanes and a control lane on both sides
+  auto *ws_endpoint1 =
+      dynamic_cast<websockets::BoostWebSocketEndpoint *>(&*endpoint1);
+  auto *ws_endpoint2 =
+      dynamic_cast<websockets::BoostWebSocketEndpoint *>(&*endpoint2);
+  TryAssertUntilTimeout(
+      [&] {
+        return ws_endpoint1->GetLaneCount(node2.uuid) == 3 &&
+               ws_endpoint2->GetLaneCount(node1.uuid) == 3;
+      },
+      5s);
+  ASSERT_EQ(endpoint1->GetActiveConnectionCount(), 1);
+
+  // messages of a stream stay in order, although other ones are striped
+  std::string payload(1024 * 1024, 'x');
+  for (size_t i = 0; i < payload.size(); i++) {
+    payload[i] = static_cast<char>('a' + i % 26);
+  }
+  auto writer = endpoint1->OpenStream(node2.uuid, "test-stream");
+  auto write = writer->Write(payload);
+  auto end = writer->End();
+
+  for (int i = 0; i < 10; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    if (i % 2 == 0) {
+      message->SetAttribute("payload", std::string(256 * 1024, 'x'));
+    }
+    sendMessageToNode(message, endpoint1, node2.uuid);
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer, &test_stream_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        std::unique_lock lock(test_stream_consumer->readers_mutex);
+        return test_consumer->counter == 10 &&
+               test_stream_consumer->readers.size() == 1;
+      },
+      10s);
+
+  auto reader = test_stream_consumer->readers.front();
+  std::string received_payload;
+  while (true) {
+    auto fragment_future = reader->Read();
+    ASSERT_EQ(fragment_future.wait_for(10s), std::future_status::ready);
+    auto fragment = fragment_future.get();
+    if (!fragment.has_value()) {
+      break;
+    }
+    received_payload += fragment->GetView();
+  }
+
+  ASSERT_EQ(received_payload, payload);
+  ASSERT_NO_THROW(write.get());
+  ASSERT_NO_THROW(end.get());
+}
+
+TEST(WebSockets, connection_pool_replacement) {
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.connections-per-peer", 2);
+  Node node1 = SetupWebSocketPeer(9003, config);
+  Node node2 = SetupWebSocketPeer(9004, config);
+
+  auto test_stream_consumer = std::make_shared<TestStreamConsumer>();
+  node2.networking_manager.Borrow()->AddMessageStreamConsumer(
+      test_stream_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto *ws_endpoint1 =
+      dynamic_cast<websockets::BoostWebSocketEndpoint *>(&*endpoint1);
+  ASSERT_NO_THROW(
+      endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004").get());
+  TryAssertUntilTimeout(
+      [&] { return ws_endpoint1->GetLaneCount(node2.uuid) == 2; }, 5s);
+
+  auto writer = endpoint1->OpenStream(node2.uuid, "test-stream");
+
+  // new lanes replace the old ones, while the node stays connected
+  ASSERT_NO_THROW(
+      endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004").get());
+  std::this_thread::sleep_for(500ms);
+  ASSERT_EQ(ws_endpoint1->GetLaneCount(node2.uuid), 2);
+  ASSERT_FALSE(writer->IsClosed());
+
+  auto write = writer->Write(std::string(1024, 'x'));
+  auto end = writer->End();
+  TryAssertUntilTimeout(
+      [&node2, &test_stream_consumer] {
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        std::unique_lock lock(test_stream_consumer->readers_mutex);
+        return test_stream_consumer->readers.size() == 1;
+      },
+      10s);
+  ASSERT_NO_THROW(write.get());
+  ASSERT_NO_THROW(end.get());
+}
+
+TEST(WebSockets, message_receiving_offloaded) {
+  // every received payload is decoded by a job instead of the I/O thread
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.receive.offload-bytes", 1);
+  config->Set("net.stream.window-bytes", 64 * 1024);
+  config->Set("net.stream.fragment-bytes", 4 * 1024);
+  Node node1 = SetupWebSocketPeer(9003);
+  Node node2 = SetupWebSocketPeer(9004, config);
+
+  std::shared_ptr<TestConsumer> test_consumer =
+      std::make_shared<TestConsumer>();
+  std::shared_ptr<TestStreamConsumer> test_stream_consumer =
+      std::make_shared<TestStreamConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+  node2.networking_manager.Borrow()->AddMessageStreamConsumer(
+      test_stream_consumer);
+
+  auto endpoint1 =
+      node1.networking_manager.Borrow()->GetDefaultMessageEndpoint().value();
+  auto result = endpoint1->EstablishConnectionTo("ws://127.0.0.1:9004");
+  result.wait();
+  ASSERT_NO_THROW(result.get());
+  waitUntilConnectionCompleted(node1, node2);
+
+  for (int i = 0; i < 20; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    sendMessageToNode(message, endpoint1, node2.uuid);
+  }
+
+  TryAssertUntilTimeout(
+      [&node2, &test_consumer] {
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 20;
+      },
+      10s);
+
+  // fragments of streams are corrupted if they are not processed in order
+  std::string payload;
+  for (int i = 0; i < 256 * 1024; i++) {
+    payload += static_cast<char>('a' + i % 26);
+  }
+
+  auto writer = endpoint1->OpenStream(node2.uuid, "test-stream");
+  auto write = writer->Write(payload);
+  auto end = writer->End();
+
+  TryAssertUntilTimeout(
+      [&node2, &test_stream_consumer] {
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        std::unique_lock lock(test_stream_consumer->readers_mutex);
+        return test_stream_consumer->readers.size() == 1;
+      },
+      10s);
+  auto reader = test_stream_consumer->readers.front();
+
+  // fragments are only received while the job cycles of the receiver run
+  std::string received_payload;
+  bool finished = false;
+  auto fragment_future = reader->Read();
+  TryAssertUntilTimeout(
+      [&node2, &reader, &fragment_future, &received_payload, &finished] {
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        while (fragment_future.wait_for(0s) == std::future_status::ready) {
+          auto fragment = fragment_future.get();
+          if (!fragment.has_value()) {
+            finished = true;
+            return true;
+          }
+          received_payload += fragment->GetView();
+          fragment_future = reader->Read();
+        }
+        return false;
+      },
+      10s);
+
+  ASSERT_TRUE(finished);
+  ASSERT_EQ(received_payload, payload);
+  ASSERT_NO_THROW(write.get());
+  ASSERT_NO_THROW(end.get());
+}
+
+TEST(UnixSockets, message_passing) {
+  auto config1 = std::make_shared<common::config::Configuration>();
+  auto config2 = std::make_shared<common::config::Configuration>();
+  config1->Set("net.shm.path", std::string("/tmp/hive-test-9003.sock"));
+  config2->Set("net.shm.path", std::string("/tmp/hive-test-9004.sock"));
+
+  Node node1 = SetupWebSocketPeer(9003, config1);
+  Node node2 = SetupWebSocketPeer(9004, config2);
+
+  node1.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::UnixSocketEndpoint>(
+          node1.subsystems.CreateReference(), config1));
+  node2.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::UnixSocketEndpoint>(
+          node2.subsystems.CreateReference(), config2));
+
+  auto test_consumer_1 = std::make_shared<TestConsumer>();
+  auto test_consumer_2 = std::make_shared<TestConsumer>();
+  node1.networking_manager.Borrow()->AddMessageConsumer(test_consumer_1);
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer_2);
+
+  auto endpoint_1 =
+      node1.networking_manager.Borrow()->GetMessageEndpoint("shm").value();
+  auto endpoint_2 =
+      node2.networking_manager.Borrow()->GetMessageEndpoint("shm").value();
+
+  auto result = endpoint_1->EstablishConnectionTo(
+      "shm:///tmp/hive-test-9004.sock");
+  result.wait();
+
+  ConnectionInfo connection_info;
+  ASSERT_NO_THROW(connection_info = result.get());
+  ASSERT_EQ(connection_info.endpoint_id, node2.uuid);
+  ASSERT_EQ(connection_info.wire_format, WireFormat::BINARY);
+
+  waitUntilConnectionCompleted(node1, node2);
+  ASSERT_TRUE(endpoint_2->HasConnectionTo(node1.uuid));
+
+  // messages are passed in both directions over the same connection
+  for (int i = 0; i < 5; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    message->SetAttribute("payload", std::string(i * 64 * 1024, 'x'));
+    sendMessageToNode(message, endpoint_1, node2.uuid);
+  }
+  sendMessageToNode(std::make_shared<Message>("test-type"), endpoint_2,
+                    node1.uuid);
+
+  auto broadcast =
+      endpoint_1->Broadcast(std::make_shared<Message>("test-type"));
+  BroadcastResult broadcast_result = broadcast.get();
+  ASSERT_EQ(broadcast_result.delivered.size(), 1);
+  ASSERT_TRUE(broadcast_result.failed.empty());
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer_1, &test_consumer_2] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer_1->counter == 1 && test_consumer_2->counter == 6;
+      },
+      10s);
+
+  // closing the connection on one side closes it on the other one as well
+  endpoint_1->CloseConnectionTo(node2.uuid);
+  TryAssertUntilTimeout(
+      [&endpoint_1, &endpoint_2] {
+        return endpoint_1->GetActiveConnectionCount() == 0 &&
+               endpoint_2->GetActiveConnectionCount() == 0;
+      },
+      5s);
+}
+
+TEST(UnixSockets, socket_file_replacement) {
+  const std::string path = "/tmp/hive-test-9005.sock";
+
+  // leave a socket file nobody accepts connections on, like a crashed node
+  {
+    boost::asio::io_context context;
+    boost::asio::local::stream_protocol::acceptor stale_acceptor(
+        context, boost::asio::local::stream_protocol::endpoint(path));
+  }
+  ASSERT_TRUE(std::filesystem::is_socket(path));
+
+  auto config = std::make_shared<common::config::Configuration>();
+  config->Set("net.shm.path", path);
+  Node node = SetupWebSocketPeer(9005, config);
+  ASSERT_NO_THROW(node.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::UnixSocketEndpoint>(
+          node.subsystems.CreateReference(), config)));
+
+  // the socket file of a running node must not be taken over
+  sockets::UnixSocketEndpoint intruder(node.subsystems.CreateReference(),
+                                       config);
+  ASSERT_THROW(intruder.Startup(), EndpointSetupException);
+  ASSERT_TRUE(std::filesystem::is_socket(path));
+
+  auto peer_config = std::make_shared<common::config::Configuration>();
+  peer_config->Set("net.shm.path", std::string("/tmp/hive-test-9006.sock"));
+  Node peer = SetupWebSocketPeer(9006, peer_config);
+  peer.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::UnixSocketEndpoint>(
+          peer.subsystems.CreateReference(), peer_config));
+  auto peer_endpoint =
+      peer.networking_manager.Borrow()->GetMessageEndpoint("shm").value();
+  ConnectionInfo connection_info;
+  ASSERT_NO_THROW(connection_info =
+                      peer_endpoint->EstablishConnectionTo("shm://" + path)
+                          .get());
+  ASSERT_EQ(connection_info.endpoint_id, node.uuid);
+}
+
+TEST(TcpSockets, message_passing) {
+  auto config1 = std::make_shared<common::config::Configuration>();
+  auto config2 = std::make_shared<common::config::Configuration>();
+
+  Node node1 = SetupWebSocketPeer(9003, config1);
+  Node node2 = SetupWebSocketPeer(9004, config2);
+
+  node1.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::TcpSocketEndpoint>(
+          node1.subsystems.CreateReference(), config1));
+  node2.networking_manager.Borrow()->InstallMessageEndpoint(
+      common::memory::Owner<sockets::TcpSocketEndpoint>(
+          node2.subsystems.CreateReference(), config2));
+
+  auto test_consumer = std::make_shared<TestConsumer>();
+  node2.networking_manager.Borrow()->AddMessageConsumer(test_consumer);
+
+  // connect both endpoints, so the preferred one must be picked
+  auto web_socket_result = node1.networking_manager.Borrow()
+                               ->GetDefaultMessageEndpoint()
+                               .value()
+                               ->EstablishConnectionTo("ws://127.0.0.1:9004");
+  auto tcp_result = node1.networking_manager.Borrow()
+                        ->GetMessageEndpoint("tcp")
+                        .value()
+                        ->EstablishConnectionTo("tcp://127.0.0.1:10004");
+  ASSERT_NO_THROW(web_socket_result.get());
+
+  ConnectionInfo connection_info;
+  ASSERT_NO_THROW(connection_info = tcp_result.get());
+  ASSERT_EQ(connection_info.endpoint_id, node2.uuid);
+
+  waitUntilConnectionCompleted(node1, node2);
+
+  auto endpoint = node1.networking_manager.Borrow()
+                      ->GetSomeMessageEndpointConnectedTo(node2.uuid)
+                      .value();
+  ASSERT_EQ(endpoint->GetProtocol(), "tcp");
+
+  for (int i = 0; i < 5; i++) {
+    SharedMessage message = std::make_shared<Message>("test-type");
+    message->SetAttribute("payload", std::string(i * 64 * 1024, 'x'));
+    sendMessageToNode(message, endpoint, node2.uuid);
+  }
+
+  TryAssertUntilTimeout(
+      [&node1, &node2, &test_consumer] {
+        node1.job_manager.Borrow()->InvokeCycleAndWait();
+        node2.job_manager.Borrow()->InvokeCycleAndWait();
+        return test_consumer->counter == 5;
+      },
+      10s);
+
+  // invalid URIs are reported through the future
+  auto invalid_result = endpoint->EstablishConnectionTo("tcp://127.0.0.1");
+  ASSERT_THROW(invalid_result.get(), sockets::UrlMalformedException);
+}
+
+TEST(WebSockets, consumer_registration) {
+  Node node = SetupWebSocketPeer(9003);
+  auto networking_manager = node.networking_manager.Borrow();
+
+  auto consumer_1 = std::make_shared<TestConsumer>();
+  auto consumer_2 = std::make_shared<TestConsumer>();
+  networking_manager->AddMessageConsumer(consumer_1);
+  networking_manager->AddMessageConsumer(consumer_2);
+  ASSERT_EQ(networking_manager->GetConsumersOfMessageType("test-type").size(),
+            2);
+  ASSERT_TRUE(networking_manager->GetConsumersOfMessageType("other").empty());
+
+  // expired consumers are skipped, even if they have not been pruned yet
+  consumer_2.reset();
+  ASSERT_EQ(networking_manager->GetConsumersOfMessageType("test-type").size(),
+            1);
+
+  networking_manager->RemoveMessageConsumer(consumer_1);
+  ASSERT_TRUE(
+      networking_manager->GetConsumersOfMessageType("test-type").empty());
+
+  // messages without consumers are dropped
+  SharedMessage message = std::make_shared<Message>("test-type");
+  networking_manager->ProcessMessage(message, ConnectionInfo{});
+  node.job_manager.Borrow()->InvokeCycleAndWait();
+  ASSERT_EQ(consumer_1->counter, 0);
+}
@@ -1,3 +1,4 @@
+#include "EventBridgeTest.h"
 #include "MessageConverterTest.h"
 #include "MessagingEndpointTest.h"
 #include "MultipartFormdataTest.h"
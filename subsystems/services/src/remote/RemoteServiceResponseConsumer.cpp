@@ -129,9 +129,12 @@ void RemoteServiceResponseConsumer::AddResponsePromise(
   if (auto maybe_subsystems = m_subsystems.TryBorrow()) {
     auto subsystems = maybe_subsystems.value();
     auto event_broker = subsystems->RequireSubsystem<events::IEventBroker>();
+
+    // the handler mostly compares endpoint ids, which is cheaper than a job
     event_broker->RegisterListener(
         connection_closed_handler,
-        networking::ConnectionClosedEvent::c_event_name);
+        networking::ConnectionClosedEvent::c_event_name,
+        events::DispatchMode::INLINE);
   } else {
     LOG_WARN("cannot register handler for severed connection during service "
              "call because required subsystems are not available")